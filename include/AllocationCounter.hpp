@@ -0,0 +1,10 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+/* ##### Standard Libraries ##### */
+#include <cstdint>
+
+/* Linking AllocationCounter.cpp replaces the global operator new and delete (every ordinary form) with versions counting the allocations. They live in their own translation unit so that the compiler never sees the inlined free of a delete next to the new it pairs with. Not thread safe: meant for single threaded benchmarks */
+std::uint64_t getAllocationCount();
+
+#endif
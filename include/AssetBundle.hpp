@@ -0,0 +1,65 @@
+#ifndef ASSET_BUNDLE_H
+#define ASSET_BUNDLE_H
+
+/* ##### Project Headers ##### */
+#include "MappedFile.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Asset bundle: the images, sounds and fonts of the GUI packed in a single file at build time, and memory mapped at startup. The assets are found by their path relative to the assets directory, e.g. "sounds/move.wav", and are used in place from the mapping.
+
+File layout (little endian, sections aligned to 8 bytes):
+   BundleHeader
+   Entries   BundleEntry per asset, sorted by name
+   Names     null terminated, referenced by their offset
+   Data      contents of the assets, one after the other
+*/
+
+const char BUNDLE_MAGIC[8] = {'C', 'P', 'P', 'C', 'H', 'A', 'S', 'T'};
+const std::uint32_t BUNDLE_VERSION = 1;
+
+struct BundleHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint64_t namesOffset;
+    std::uint64_t namesSize;
+};
+
+struct BundleEntry {
+    std::uint32_t name; /* Offset into the names section */
+    std::uint32_t reserved;
+    std::uint64_t offset; /* From the start of the file */
+    std::uint64_t size;
+};
+
+/* Packs the files (paths relative to root) into a bundle. Returns false if a file cannot be read or the bundle cannot be written */
+bool writeAssetBundle(const std::string & path, const std::string & root, const std::vector<std::string> & names);
+
+/* Memory mapped bundle reader. Opening validates the tables, and an asset is then found with a binary search on its name */
+class AssetBundle {
+public:
+    AssetBundle();
+
+    bool open(const std::string & path);
+    void close();
+
+    bool isOpen() const { return mHeader != nullptr; }
+    std::uint32_t getAssetCount() const { return mHeader ? mHeader->entryCount : 0; }
+    std::size_t getSize() const { return mFile.getSize(); }
+
+    /* Contents of an asset, valid while the bundle is open. Returns nullptr if there is no such asset */
+    const char * find(const std::string & name, std::size_t & size) const;
+
+private:
+    MappedFile mFile;
+    const BundleHeader * mHeader;
+    const BundleEntry * mEntries;
+    const char * mNames;
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef BISHOP_H
 #define BISHOP_H
 
+/* ##### Standard Libraries ##### */
+#include <array>
+
 /* ##### Project Headers ##### */
 #include "Piece.hpp"
 
@@ -11,7 +14,7 @@ class Bishop : public Piece {
 public:
     Bishop(Color color, int position, Board * board) : Piece(color, PieceType::Bishop, position, board, true) {}
     ~Bishop() {}
-    Piece * clone(Board* newBoard) const override;
+    Piece * clone(Board* newBoard, void * memory) const override;
     void computeMoves() override;
     
 private:
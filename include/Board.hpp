@@ -4,19 +4,68 @@
 /* ##### Project Headers ##### */
 #include "Piece.hpp"
 #include "King.hpp"
+#include "PieceArena.hpp"
 
 /* ##### Standard Libraries ##### */
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
 
 /* ##### Class Forward Declaration ##### */
 class ChessGame;
 
+/* ##### Board Dimensions ##### */
+extern const int ROW;
+extern const int COL;
+
+/* ##### Castling Rights ##### */
+/* Flags returned by Board::getCastlingRights, in FEN order (KQkq) */
+const int CASTLE_WHITE_KING_SIDE = 1;
+const int CASTLE_WHITE_QUEEN_SIDE = 2;
+const int CASTLE_BLACK_KING_SIDE = 4;
+const int CASTLE_BLACK_QUEEN_SIDE = 8;
+
 /* ##### Enums ##### */
 enum class SquareStatus {Invalid, Empty, Friendly, Enemy};
 
+/* ##### FEN ##### */
+/* Reasons for Board::parseFEN to reject a FEN */
+enum class FENError {None, MissingFields, TooManyFields, InvalidPiece, InvalidRankLength, InvalidRankCount, InvalidKingCount, PawnOnBackRank, InvalidTurn, InvalidCastling, CastlingMismatch, InvalidEnPassant, InvalidClock, OpponentInCheck};
+const char * fenErrorName(FENError error);
+
+/* The longest FEN (8 ranks of alternating pieces and empty squares, all castling rights, 6 digit clocks) has 95 characters, plus the null terminator */
+const std::size_t FEN_BUFFER_SIZE = 96;
+
+/* ##### Packed Position ##### */
+/* Compact canonical encoding of a position, without the move clocks, for position sets, caches and network transfers. Positions that only differ by their clocks, or by an en passant square that no pawn can capture, pack to the same bytes */
+struct PackedBoard {
+    std::uint64_t occupancy;     /* Bit i set if square i (a1 = 0) has a piece */
+    std::uint8_t pieces[16];     /* 4 bits per occupied square in square order, low nibble first: 1-6 White Pawn to King, 9-14 Black */
+    std::uint8_t flags;          /* Bit 0: Black to move. Bits 1-4: castling rights (KQkq) */
+    std::uint8_t enPassantFile;  /* File of the en passant target + 1, 0 if none */
+    std::uint8_t reserved[6];    /* Always 0, so the whole struct can be compared and hashed as bytes */
+
+    bool operator==(const PackedBoard & other) const { return std::memcmp(this, &other, sizeof(PackedBoard)) == 0; }
+    bool operator!=(const PackedBoard & other) const { return !(*this == other); }
+};
+
+/* ##### Move ##### */
+/* A move from one index to another. The promotion type is only used when a pawn reaches the last rank */
+struct Move {
+    int from;
+    int to;
+    PieceType promotion;
+
+    bool operator==(const Move & other) const { return from == other.from && to == other.to && promotion == other.promotion; }
+};
+
 class Board {
 public:
-    Board(ChessGame * game); /* Constructor */
+    Board(ChessGame * game = nullptr); /* Constructor */
     Board(const Board & original); /* Copy Constructor */
     ~Board(); /* Destructor */
 
@@ -36,14 +85,23 @@ public:
     static std::string indexToAlgebraic(int index);
 
     /* Get the King */
-    King * getKing(Color color) { return (color == Color::White) ? mWhiteKing : mBlackKing; }
+    King * getKing(Color color) const { return (color == Color::White) ? mWhiteKing : mBlackKing; }
 
     /* Clear/Reset the board*/
     void clearBoard();
 
-    /* Piece creation and board initialization */
+    /* Piece creation (in the arena of the board) and board initialization */
     Piece * createPiece(PieceType type, Color color, int position);
     bool loadFromFEN(const std::string & fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    FENError parseFEN(std::string_view fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+    /* Writes the FEN of the position into a null terminated buffer (FEN_BUFFER_SIZE is always enough). Returns the length written, or 0 if it does not fit */
+    std::size_t toFEN(char * buffer, std::size_t size) const;
+    std::string toFEN() const;
+
+    /* Packs the position (false if it has more than 32 pieces), or places a packed one with the same validation as parseFEN */
+    bool pack(PackedBoard & packed) const;
+    FENError unpack(const PackedBoard & packed);
 
     /* Helpers for move computation */
     static bool isValidIndex(int index);
@@ -58,21 +116,43 @@ public:
     bool validateMove(int fromIndex, int toIndex);
     void validateAllNextPlayerMoves(Color turn);
 
-    bool movePiece(int fromIndex, int toIndex);
+    bool movePiece(int fromIndex, int toIndex, PieceType promotion = PieceType::Queen);
     bool existLegalMoves(Color color);
     bool isKingInCheck(Color color);
 
     void countMoves(Color color);
 
+    /* Plays a move for the side to move: moves the piece, updates the clocks, switches turns and validates the replies */
+    bool playMove(const Move & move);
+
+    /* Legal moves of the side to move. Only valid after validateAllNextPlayerMoves(getTurn()), which playMove and loadFromFEN already do */
+    void generateLegalMoves(std::vector<Move> & moves) const;
+
+    /* Turn and Move Clocks */
+    Color getTurn() const { return mTurn; }
+    void setTurn(Color color) { mTurn = color; }
+    int getHalfMoveClock() const { return mHalfMoveClock; }
+    int getFullMoveClock() const { return mFullMoveClock; }
+
     /* En Passant Setters/Getters */
     int getEnPassantIndex() const { return mEnPassantIndex; }
     void setEnPassantIndex(int position) { mEnPassantIndex = position; }
 
+    /* Castling rights still available, as CASTLE_* flags. A right is kept while the King has it and neither the King nor that Rook have moved, even if castling is not possible right now */
+    int getCastlingRights() const;
+
 private:
+    struct PositionSetup;
+    FENError setupPosition(const PositionSetup & setup);
+
+    PieceArena mArena; /* Memory of the pieces of this board */
     ChessGame * mGamePtr;
     King * mWhiteKing;
     King * mBlackKing;
     int mEnPassantIndex;
+    Color mTurn;
+    int mHalfMoveClock;
+    int mFullMoveClock;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+/* ##### Standard Libraries ##### */
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/* Blocking queue with a fixed capacity, used to pass work between threads. Producers wait while it is full and consumers wait while it is empty. Closing it wakes everyone up: pushes fail and pops drain what is left. It also records its depth at every push, so the pipelines using it can report how full their stages were */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : mCapacity(capacity > 0 ? capacity : 1), mClosed(false), mPushes(0), mDepthSum(0), mMaxDepth(0) {}
+
+    /* Adds an item, waiting for space. Returns false if the queue was closed */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotFull.wait(lock, [this] { return mClosed || mItems.size() < mCapacity; });
+        if (mClosed) return false;
+
+        mItems.push_back(std::move(item));
+        ++mPushes;
+        mDepthSum += mItems.size();
+        if (mItems.size() > mMaxDepth) mMaxDepth = mItems.size();
+
+        lock.unlock();
+        mNotEmpty.notify_one();
+        return true;
+    }
+
+    /* Adds an item if there is space, without waiting. Returns false if the queue is full or closed */
+    bool tryPush(T item) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mClosed || mItems.size() >= mCapacity) return false;
+
+        mItems.push_back(std::move(item));
+        ++mPushes;
+        mDepthSum += mItems.size();
+        if (mItems.size() > mMaxDepth) mMaxDepth = mItems.size();
+
+        lock.unlock();
+        mNotEmpty.notify_one();
+        return true;
+    }
+
+    /* Removes the oldest item, waiting for one. Returns false once the queue is closed and empty */
+    bool pop(T & item) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotEmpty.wait(lock, [this] { return mClosed || !mItems.empty(); });
+        if (mItems.empty()) return false;
+
+        item = std::move(mItems.front());
+        mItems.pop_front();
+
+        lock.unlock();
+        mNotFull.notify_one();
+        return true;
+    }
+
+    /* Drops the items not popped yet, for consumers which should stop without draining. Returns how many were dropped */
+    std::size_t clear() {
+        std::size_t dropped;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            dropped = mItems.size();
+            mItems.clear();
+        }
+        mNotFull.notify_all();
+        return dropped;
+    }
+
+    /* No more items will be pushed */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+        }
+        mNotFull.notify_all();
+        mNotEmpty.notify_all();
+    }
+
+    /* Depth Statistics */
+    std::size_t getCapacity() const { return mCapacity; }
+    std::size_t getMaxDepth() const { std::lock_guard<std::mutex> lock(mMutex); return mMaxDepth; }
+    double getAverageDepth() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPushes ? static_cast<double>(mDepthSum) / mPushes : 0.0;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::condition_variable mNotFull;
+    std::condition_variable mNotEmpty;
+    std::deque<T> mItems;
+    std::size_t mCapacity;
+    bool mClosed;
+
+    std::uint64_t mPushes;
+    std::uint64_t mDepthSum;
+    std::size_t mMaxDepth;
+};
+
+#endif
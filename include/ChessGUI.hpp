@@ -2,7 +2,17 @@
 #define GUI_H
 
 /* Imports */
+#include "FrameStats.hpp"
 #include "Game.hpp"
+#include "PolyglotBook.hpp"
+#include "Search.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 class ChessGUI {
 public:
@@ -18,12 +28,56 @@ public:
     /* Game Over Menu */
     void gameOverMenu();
 
+    /* Opening Book Section */
+    void bookMenu();
+
+    /* Performance Section */
+    void performanceMenu();
+
+    /* Records the time of the stages of a frame, measured by the main loop */
+    void recordFrame(const FrameTiming & timing, float seconds);
+
+    /* The main loop keeps rendering during an analysis, so its statistics are updated */
+    bool isAnalyzing() const { return mAnalysisRunning; }
+
 private:
     bool showDemoWindow;
     bool showGameOver;
     SDL_Window * mWindow;
     SDL_Renderer * mRenderer;
     ChessGame * mGame;
+
+    /* Opening book and the moves of the last position probed, so the book is only searched when the position changes */
+    PolyglotBook mBook;
+    std::uint64_t mBookKey;
+    std::vector<std::string> mBookMoves;
+    std::vector<float> mBookWeights;
+
+    /* Move history, one row per move number. Only the moves added since the last frame are appended, and only the visible rows are drawn */
+    std::vector<std::string> mHistoryRows;
+    std::size_t mHistoryMoves;
+    unsigned mHistoryResets;
+    bool mHistoryScroll;
+    void updateMoveHistory();
+
+    /* Frame history and the draw calls counted at the last frame */
+    FrameStats mFrameStats;
+    unsigned long mLastDrawCalls;
+    int mGuiDrawCommands;
+    int mGuiVertices;
+
+    /* Engine analysis of the current position, on its own thread. It is started again when the position changes, and the statistics of its last completed iteration are shown */
+    std::unique_ptr<Search> mAnalysis;
+    std::thread mAnalysisThread;
+    std::uint64_t mAnalysisKey;
+    std::atomic<bool> mAnalysisRunning;
+    std::atomic<int> mEngineDepth;
+    std::atomic<int> mEngineScore;
+    std::atomic<int> mEngineHashFull;
+    std::atomic<std::uint64_t> mEngineNodes;
+    std::atomic<std::uint64_t> mEngineNPS;
+    void startAnalysis();
+    void stopAnalysis();
 };
 
 #endif
\ No newline at end of file
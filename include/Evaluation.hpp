@@ -0,0 +1,15 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* Static evaluation in centipawns: material plus piece-square tables, with the King table blended from the middlegame to the endgame as pieces come off the board. More information: https://www.chessprogramming.org/Simplified_Evaluation_Function */
+
+/* Material value of a piece in centipawns. The King and empty squares are worth 0 */
+int pieceValue(PieceType type);
+
+/* Evaluates the position from the point of view of the side to move (positive is good for it) */
+int evaluate(const Board & board);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+/* ##### Standard Libraries ##### */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+/* Fixed size history, overwriting the oldest value when full. The values stay in one array, which ImGui::PlotLines reads directly with getOffset() */
+template <typename T, std::size_t N>
+class RingBuffer {
+public:
+    void push(const T & value) {
+        mValues[mNext] = value;
+        mNext = (mNext + 1) % N;
+        mCount = std::min(mCount + 1, N);
+    }
+
+    void clear() { mNext = 0; mCount = 0; }
+
+    std::size_t size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+    static constexpr std::size_t capacity() { return N; }
+
+    /* Oldest first */
+    const T & operator[](std::size_t i) const { return mValues[(mNext + N - mCount + i) % N]; }
+    const T & back() const { return mValues[(mNext + N - 1) % N]; }
+
+    const T * data() const { return mValues.data(); }
+    int getOffset() const { return mCount < N ? 0 : static_cast<int>(mNext); } /* Index of the oldest value */
+
+private:
+    std::array<T, N> mValues{};
+    std::size_t mNext = 0;
+    std::size_t mCount = 0;
+};
+
+/* Adds the time between its construction and destruction to a value in milliseconds. It only reads the clock twice, so it can wrap every stage of a frame */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(float & milliseconds) : mMilliseconds(milliseconds), mStart(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { mMilliseconds += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - mStart).count(); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+private:
+    float & mMilliseconds;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+/* Time spent in each stage of a frame, in milliseconds */
+struct FrameTiming {
+    float events = 0.0f;
+    float update = 0.0f;
+    float render = 0.0f;
+    float gui = 0.0f;
+    float present = 0.0f;
+
+    float total() const { return events + update + render + gui + present; }
+};
+
+/* History of the last frames, shown by the performance overlay */
+struct FrameStats {
+    static const std::size_t HISTORY = 240;
+
+    RingBuffer<FrameTiming, HISTORY> timings;
+    RingBuffer<float, HISTORY> frameTimes; /* Total of each timing, for the plot */
+    RingBuffer<float, HISTORY> intervals; /* Milliseconds since the previous frame, not counting the idle waits */
+    RingBuffer<float, HISTORY> drawCalls; /* Of the board batches, in the frame */
+
+    void record(const FrameTiming & timing, float intervalMs, unsigned long frameDrawCalls) {
+        timings.push(timing);
+        frameTimes.push(timing.total());
+        intervals.push(intervalMs);
+        drawCalls.push(static_cast<float>(frameDrawCalls));
+    }
+
+    /* Mean of every stage over the history */
+    FrameTiming average() const {
+        FrameTiming mean;
+        if (timings.empty()) return mean;
+        for (std::size_t i = 0; i < timings.size(); ++i) {
+            mean.events += timings[i].events;
+            mean.update += timings[i].update;
+            mean.render += timings[i].render;
+            mean.gui += timings[i].gui;
+            mean.present += timings[i].present;
+        }
+        float count = static_cast<float>(timings.size());
+        mean.events /= count;
+        mean.update /= count;
+        mean.render /= count;
+        mean.gui /= count;
+        mean.present /= count;
+        return mean;
+    }
+
+    float worstFrameTime() const {
+        float worst = 0.0f;
+        for (std::size_t i = 0; i < frameTimes.size(); ++i) worst = std::max(worst, frameTimes[i]);
+        return worst;
+    }
+};
+
+#endif
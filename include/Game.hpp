@@ -34,23 +34,19 @@ public:
     /* Public Move List */
     std::vector<std::string> moveList;
 
+    /* Times the Move List was cleared, so a copy of it knows when to start again */
+    unsigned getMoveListResets() const {return mMoveListResets;}
+
     /* Reset the Game */
     void resetGame();
 
     /* Load Position from FEN */
     bool loadFEN(const std::string fen);
 
-    /* Turn Methods */
-    void setTurn(Color color) {mTurn = color;}
-    Color getTurn() const {return mTurn;}
-
-    /* Half Move Clock Methods */
-    void setHalfMoveClock(int value) {mHalfMoveClock = value;}
-    int getHalfMoveClock() const {return mHalfMoveClock;}
-
-    /* Full Move Clock Methods*/
-    void setFullMoveClock(int value) {mFullMoveClock = value;}
-    int getFullMoveClock() const {return mFullMoveClock;}
+    /* Turn and Move Clocks, kept by the Board */
+    Color getTurn() const {return mBoard.getTurn();}
+    int getHalfMoveClock() const {return mBoard.getHalfMoveClock();}
+    int getFullMoveClock() const {return mBoard.getFullMoveClock();}
 
     /* Get En Passant Index */
     int getEnPassantIndex() const {return mBoard.getEnPassantIndex();}
@@ -58,6 +54,9 @@ public:
     /* Get move count */
     int getMoveCount() const {return mBoard.moveCount;}
 
+    /* Current position, read-only */
+    const Board & getBoard() const {return mBoard;}
+
     /* Pieces */
     int getFocusIndex() const {return mFocusIndex;}
     int getTargetIndex() const {return mTargetIndex;}
@@ -66,6 +65,7 @@ public:
     void handleStatesProcessing();
     void handleRender();
     void handleEvent(SDL_Event & event);
+    void handleUpdate(float seconds);
 
     /* State Handling */
     void handleProcessingMove();
@@ -74,6 +74,12 @@ public:
     /* Game Status */
     bool isGameOver() const { return mState == GameState::GameOver; }
 
+    /* Nothing changes on the screen without an event: no animation, move or timer running */
+    bool isIdle() const;
+
+    /* The Game Over menu shows up once the outcome was on the screen for a while */
+    bool isGameOverMenuReady() const { return isGameOver() && mGameOverSeconds >= GAME_OVER_DELAY; }
+
     /* File Handling and Register Moves */
     bool generatePGN(const std::string & result = "");
     void registerMove();
@@ -89,12 +95,15 @@ private:
     bool mLeftMouseButtonDown;
     bool mWasClicked;
 
-    Color mTurn;
-    int mHalfMoveClock;
-    int mFullMoveClock;
     /* add std::unordered_map for tracking repetitions */
     
     bool mProcessGameOver;
+    unsigned mMoveListResets;
+
+    /* Outcome shown on the board, and for how long it was shown (seconds) */
+    static constexpr float GAME_OVER_DELAY = 3.0f;
+    std::string mOutcome;
+    float mGameOverSeconds;
 };
 
 #endif
\ No newline at end of file
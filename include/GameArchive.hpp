@@ -0,0 +1,126 @@
+#ifndef GAME_ARCHIVE_H
+#define GAME_ARCHIVE_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include "PGN.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Compact binary game archive. Every move is stored as one byte: its index in the sorted list of legal moves of the position, which is never above 218. Tag names and values go to a deduplicated string table, and a fixed size index entry per game gives random access to any game without scanning the file.
+
+File layout (little endian, sections aligned to 8 bytes):
+   ArchiveHeader
+   Moves     uint8_t per move, games one after the other
+   Strings   null terminated, referenced by their offset
+   Tags      ArchiveTag per tag, games one after the other
+   Index     ArchiveGameEntry per game
+*/
+
+const char ARCHIVE_MAGIC[8] = {'C', 'P', 'P', 'C', 'H', 'G', 'A', 'R'};
+const std::uint32_t ARCHIVE_VERSION = 1;
+
+struct ArchiveHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t gameCount;
+    std::uint64_t movesOffset;
+    std::uint64_t movesSize;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+    std::uint64_t tagsOffset;
+    std::uint64_t tagCount;
+    std::uint64_t indexOffset;
+};
+
+struct ArchiveTag {
+    std::uint32_t name; /* Offsets into the string table */
+    std::uint32_t value;
+};
+
+struct ArchiveGameEntry {
+    std::uint64_t moves; /* Offset into the moves section */
+    std::uint64_t tags; /* First tag of the game in the tags section */
+    std::uint32_t moveCount;
+    std::uint16_t tagCount;
+    std::uint8_t result; /* ArchiveResult */
+    std::uint8_t reserved;
+};
+
+enum class ArchiveResult : std::uint8_t {Unknown, WhiteWins, BlackWins, Draw};
+
+/* Sorted legal moves of the side to move, the order used to encode the moves */
+void sortedLegalMoves(const Board & board, std::vector<Move> & moves);
+
+/* Writes an archive. The moves are streamed to the file while the games are added, and the tables are written when closing it */
+class GameArchiveWriter {
+public:
+    GameArchiveWriter();
+    ~GameArchiveWriter();
+
+    bool open(const std::string & path);
+
+    /* Replays the game on a board to encode its moves. Returns false (and skips the game) if a move cannot be played */
+    bool addGame(const PGNGame & game);
+
+    /* Writes the tables and the header. Returns false on a write error */
+    bool close();
+
+    std::uint64_t getGameCount() const { return mEntries.size(); }
+
+private:
+    std::ofstream mFile;
+    Board mBoard;
+    std::vector<Move> mMoves;
+    std::vector<Move> mLegalMoves;
+    std::vector<std::uint8_t> mEncoded;
+
+    std::vector<ArchiveGameEntry> mEntries;
+    std::vector<ArchiveTag> mTags;
+    std::string mStrings;
+    std::unordered_map<std::string, std::uint32_t> mStringIds;
+    std::uint64_t mMovesSize;
+
+    std::uint32_t addString(const std::string & text);
+};
+
+/* Memory mapped archive reader. Opening only validates the header, and any game can then be read in constant time */
+class GameArchive {
+public:
+    GameArchive();
+
+    bool open(const std::string & path);
+    void close();
+
+    std::uint64_t getGameCount() const { return mHeader ? mHeader->gameCount : 0; }
+    const ArchiveGameEntry & getEntry(std::uint64_t index) const { return mIndex[index]; }
+    const std::uint8_t * getMoveIndexes(std::uint64_t index) const { return mMoves + mIndex[index].moves; }
+
+    /* Loads the starting position of a game (its FEN tag, or the initial position). Also checks that the game entry points inside the archive */
+    bool loadStartPosition(std::uint64_t index, Board & board) const;
+
+    /* Decodes the moves of a game by replaying them on the board, which ends in the final position of the game */
+    bool readMoves(std::uint64_t index, Board & board, std::vector<Move> & moves) const;
+
+    /* Decodes a full game: tags, SAN moves and result */
+    bool readGame(std::uint64_t index, PGNGame & game) const;
+
+private:
+    MappedFile mFile;
+    const ArchiveHeader * mHeader;
+    const std::uint8_t * mMoves;
+    const char * mStrings;
+    const ArchiveTag * mTags;
+    const ArchiveGameEntry * mIndex;
+
+    const char * getString(std::uint32_t offset) const { return mStrings + offset; }
+};
+
+#endif
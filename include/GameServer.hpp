@@ -0,0 +1,151 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+/* ##### Project Headers ##### */
+#include "BoundedQueue.hpp"
+#include "HeadlessGame.hpp"
+#include "LineSocket.hpp"
+#include "Search.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Headless server hosting many games at once over TCP, human against human or human against the engine (Linux, as it uses epoll).
+
+One thread runs the event loop: it accepts the connections, reads their commands and owns every game, so the games need no locks. Engine moves are searched by a pool of workers, each with its own Search, which post the moves back to the event loop and wake it through an eventfd.
+
+The protocol is text, one command per line, answered on the same connection in order. A connection can play any number of games:
+   create [white|black] [engine]   ->  created <id> <color>                  Creates a game, playing the color. With engine, the engine plays the other color and the game starts at once
+   join <id>                       ->  joined <id> <color>                   Joins a created game, with the remaining color. The creator gets started <id>
+   move <id> <move>                ->  ok <id> <uci>                         Plays a move, in UCI (e2e4) or SAN (e4). The opponent gets moved <id> <uci>
+   resign <id>                     ->  (end)
+   fen <id>                        ->  fen <id> <fen>
+   stats                           ->  stats <games> <connections> <moves>
+When a game ends, both players get end <id> <result> <reason>, and the id is no longer valid. If the engine is too busy to take a move, the player gets error create|move <id> engine busy and the game ends as cancelled. A player disconnecting loses its games. Errors are answered with error <command> <message> */
+
+struct ServerOptions {
+    std::string host = "127.0.0.1";
+    int port = 7878;
+    unsigned workers = 0; /* Engine threads, 0 uses every core */
+    std::size_t maxGames = 100000;
+    std::size_t hash = 1; /* Transposition table of each worker, in MB */
+    SearchLimits engineLimits;
+};
+
+/* Totals since the server started */
+struct ServerStats {
+    std::uint64_t connections = 0;
+    std::uint64_t gamesCreated = 0;
+    std::uint64_t gamesFinished = 0;
+    std::uint64_t moves = 0; /* Including the engine moves */
+    std::uint64_t engineMoves = 0;
+};
+
+class GameServer {
+public:
+    explicit GameServer(const ServerOptions & options);
+    ~GameServer();
+    GameServer(const GameServer &) = delete;
+    GameServer & operator=(const GameServer &) = delete;
+
+    /* Listens and starts the engine workers. Returns false, with the reason printed, if the socket cannot be set up */
+    bool start();
+
+    /* Runs the event loop until stop */
+    void run();
+
+    /* Makes run return. Only writes to the eventfd, so it can be called from a signal handler */
+    void stop();
+
+    /* Only read by the thread of run, or after it returned */
+    const ServerStats & getStats() const { return mStats; }
+    std::size_t getGameCount() const { return mGames.size(); }
+    std::size_t getConnectionCount() const { return mConnections.size(); }
+
+private:
+    struct Connection {
+        LineSocket socket;
+        std::vector<std::uint64_t> games; /* Played by this connection */
+        bool dirty = false;               /* Has output to flush at the end of the loop iteration */
+        bool writing = false;             /* Waiting for EPOLLOUT */
+    };
+
+    struct Game {
+        HeadlessGame game;
+        int players[2] = {-1, -1}; /* File descriptors of White and Black, -1 for the engine or a free seat */
+        bool engine = false;
+        bool started = false;
+    };
+
+    /* The board is copied, so the game can go on (or end) while the engine thinks */
+    struct EngineJob {
+        std::uint64_t gameId = 0;
+        int ply = 0;
+        std::unique_ptr<Board> board;
+        std::vector<std::uint64_t> history;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    struct EngineReply {
+        std::uint64_t gameId;
+        int ply;
+        Move move;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    /* Event Loop */
+    void acceptConnections();
+    void readConnection(int fd);
+    void closeConnection(int fd);
+    void flushConnections();
+    void flushConnection(int fd);
+    void send(int fd, std::string_view text);
+    void handleCommand(int fd, std::string_view line);
+
+    /* Commands */
+    void createGame(int fd, const std::vector<std::string_view> & words);
+    void joinGame(int fd, std::uint64_t id);
+    void playMove(int fd, std::uint64_t id, std::string_view text);
+    void resignGame(int fd, std::uint64_t id);
+    void sendFEN(int fd, std::uint64_t id);
+
+    /* Games */
+    Game * findGame(std::uint64_t id);
+    void afterMove(std::uint64_t id, Game & game);
+    void finishGame(std::uint64_t id);
+    bool queueEngineMove(std::uint64_t id, const Game & game);
+    void handleEngineReplies();
+    void runWorker(std::size_t index);
+
+    ServerOptions mOptions;
+    int mListenFd;
+    int mEpollFd;
+    int mWakeFd; /* eventfd written by the workers and stop */
+    std::atomic<bool> mStopping;
+
+    std::unordered_map<int, Connection> mConnections;
+    std::vector<int> mDirty;
+    std::vector<std::string_view> mWords; /* Of the command being handled, kept to reuse its memory */
+    std::unordered_map<std::uint64_t, Game> mGames;
+    std::uint64_t mNextGameId;
+    ServerStats mStats;
+
+    /* Engine Workers */
+    BoundedQueue<EngineJob> mJobs; /* A game has at most one job, so with maxGames places it is only full if jobs of games which already ended pile up. The event loop never waits on it */
+    std::vector<std::unique_ptr<Search>> mSearches; /* One per worker, so the destructor can abort the searches running */
+    std::vector<std::thread> mWorkers;
+    std::mutex mRepliesMutex;
+    std::vector<EngineReply> mReplies;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+/* ##### Project Headers ##### */
+#include "TextureAtlas.hpp"
+
+/* ##### SDL Include ##### */
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+/* ##### Standard Libraries ##### */
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* A glyph of a laid out line, in font pixels from the top left corner of the line */
+struct GlyphQuad {
+    int sprite;
+    SDL_Rect rect;
+};
+
+/* A line of text, laid out once and then drawn from the cache */
+struct TextLine {
+    std::vector<GlyphQuad> glyphs;
+    int width = 0;
+    int height = 0;
+};
+
+/* Text drawn from glyphs packed in the texture atlas, so it goes in the same sprite batch as the board instead of a texture per string. The printable ASCII glyphs of a font are rendered once, when the atlas is built, and every line is laid out once and cached by its content */
+class GlyphCache {
+public:
+    GlyphCache();
+
+    /* Renders the glyphs of the font (white, tinted when drawn) and appends them to the images of the atlas, whose sprites are numbered from the current size of images. The caller frees the surfaces */
+    bool render(TTF_Font * font, std::vector<SDL_Surface *> & images);
+    void clear();
+
+    /* Layout of a line, from the cache */
+    const TextLine & layout(const std::string & text);
+
+    /* Adds the glyphs of a line, with its top left corner at (x, y). Font pixels are divided by scale, as the fonts are opened at the size of the display */
+    void draw(SpriteBatch & batch, const std::string & text, float x, float y, SDL_Color color, float scale = 1.0f);
+
+    int getWidth(const std::string & text) { return layout(text).width; }
+    int getHeight() const { return mHeight; }
+
+private:
+    static const char FIRST_GLYPH = ' ';
+    static const char LAST_GLYPH = '~';
+
+    int mHeight;
+    std::array<int, LAST_GLYPH - FIRST_GLYPH + 1> mAdvance;
+    std::array<int, LAST_GLYPH - FIRST_GLYPH + 1> mSprite; /* -1 when the glyph has no image */
+    std::array<SDL_Point, LAST_GLYPH - FIRST_GLYPH + 1> mSize;
+    std::unordered_map<std::string, TextLine> mLines;
+};
+
+#endif
@@ -1,8 +1,19 @@
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 
+/* ##### Project Headers ##### */
+#include "AssetBundle.hpp"
+#include "GlyphCache.hpp"
+#include "Piece.hpp"
+#include "TextureAtlas.hpp"
+
 /* ##### Standard Libraries ##### */
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <vector>
 
 /* ##### SDL Include ##### */
 #include <SDL.h>
@@ -39,18 +50,38 @@ extern Mix_Chunk * moveCheckSound;
 extern Mix_Chunk * promoteSound;
 extern Mix_Chunk * illegalMoveSound;
 
+/* ##### Render Modes ##### */
+/* Window: the GUI, with a window, vsync and audio. Offscreen: a software renderer drawing on a surface, which needs no display, e.g. to save images of positions */
+enum class RenderMode {
+    Window,
+    Offscreen,
+};
+
+/* ##### Animations ##### */
+/* A piece sliding between two squares, or fading out on its square if it was captured. The squares are looked up when rendering, so flipping the board during an animation is fine */
+struct PieceTween {
+    Color color;
+    PieceType type;
+    int fromIndex;
+    int toIndex;
+    float elapsed;  /* Seconds */
+    float duration; /* Seconds */
+    bool fade;
+};
+
 /* ##### Class #####*/
 class Graphics {
 public:
     /* RAII Technique - Resource Acquisition Is Initialization */
-    Graphics();
+    explicit Graphics(RenderMode mode = RenderMode::Window);
     ~Graphics();
     
     /* Getters for the window and renderer, to be used if necessary */
     SDL_Window * getWindow() const { return mWindow; }
     SDL_Renderer * getRenderer() const { return mRenderer; }
+    SDL_Surface * getSurface() const { return mSurface; }
 
-    /* Set GUI Pointer (only used for animatePieceMoving)*/
+    /* Set GUI Pointer */
     void setGUIPointer(ChessGUI * inGUI) { mGuiPtr = inGUI; }
 
     /* Media Loader */
@@ -65,6 +96,11 @@ public:
     /* GUI Methods */
     void clearWindow();
     void updateWindow();
+    void flushSprites();
+
+    /* Statistics for the performance overlay: draw calls of the sprite batch since the start, and bytes of the textures kept by the board */
+    unsigned long getDrawCalls() const { return mSprites.getDrawCalls(); }
+    std::size_t getTextureMemory() const;
     void renderBoardSquare(int col, int row);
     void renderBoard();
     void renderMarkings();
@@ -72,6 +108,8 @@ public:
     void renderKingInCheck(int index);
     void renderPieces(const Board & board);
     void renderBoardWithPieces(const Board & board);
+    void renderScene(const Board & board, std::uint64_t highlights = 0);
+    void invalidateScene();
     void highlightSquare(int index);
     void highlightMove(int index);
     void highlightCapture(int index);
@@ -80,16 +118,59 @@ public:
     void selectPiece(const Board & board, int index);
     void renderHoverSquare(int mouseX, int mouseY);
     void renderDraggedPiece(const Board & board, int index, int mouseX, int mouseY);
-    void animatePieceMoving(const Board & board, int fromIndex, int toIndex);
-    void printText(const Board & board, std::string & text);
+    void printText(const Board & board, const std::string & text);
+    void renderText(const std::string & text);
     void flipBoard();
 
+    /* Offscreen only: renders a position and saves it as a PNG image */
+    bool saveBoardImage(const Board & board, const std::string & path, int selectedIndex = -1);
+
+    /* Animations. They only start here and are advanced by the main loop, which keeps handling events while they run */
+    void animatePieceMoving(const Board & board, int fromIndex, int toIndex, bool slide = true);
+    void updateAnimations(float seconds);
+    void renderAnimations();
+    void clearAnimations() { mTweens.clear(); }
+    bool isAnimating() const { return !mTweens.empty(); }
+
 private:
+    RenderMode mMode;
     SDL_Window * mWindow;
     SDL_Renderer * mRenderer;
+    SDL_Surface * mSurface; /* Offscreen only */
     // static bool instantiated; /* https://gameprogrammingpatterns.com/singleton.html */
     std::array<SDL_Rect, 64> mSquares;
     ChessGUI * mGuiPtr;
+
+    void createWindow();
+    void createOffscreen();
+
+    /* Memory mapped asset bundle */
+    AssetBundle mAssets;
+    SDL_RWops * openAsset(const char * name) const;
+
+    /* Pieces and markings are sprites of one texture, drawn in batches instead of one texture at a time */
+    TextureAtlas mAtlas;
+    SpriteBatch mSprites;
+
+    /* Glyphs of the markings and status text, in the atlas */
+    GlyphCache mBoardText;
+
+    /* Running animations, and the squares hidden under them */
+    std::vector<PieceTween> mTweens;
+    bool isAnimatedSquare(int index) const;
+    void addTween(const Board & board, int fromIndex, int toIndex, bool fade);
+    void renderPieceTexture(Color color, PieceType type, int x, int y, Uint8 alpha = 0xFF);
+
+    /* Retained scene: the board with its markings, highlights and pieces, kept in a render target. The board is only drawn again when the colors, flip, markings or size change, and then only the squares whose content changed */
+    SDL_Texture * mSceneTexture;
+    std::array<int, 64> mSceneKeys;
+    std::array<SDL_Color, 3> mSceneColors;
+    bool mSceneFlipped;
+    bool mSceneMarkings;
+    int mSceneWidth;
+    int mSceneHeight;
+    bool updateSceneTexture();
+    int sceneKey(const Board & board, int index, std::uint64_t highlights) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef HEADLESS_GAME_H
+#define HEADLESS_GAME_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+#include "SelfPlay.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* A game without Graphics, for servers and tools. It follows the rule flow of ChessGame::handleProcessingMove: the move is checked against the validated moves of the side to move, played on the Board, and the position is then checked for the end of the game. It also detects repetitions and insufficient material, which the GUI does not */
+class HeadlessGame {
+public:
+    HeadlessGame();
+
+    /* Starts a new game from a position. Returns false if the FEN is not valid */
+    bool start(std::string_view fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+    /* Plays a move of the side to move, given in UCI (e2e4, e7e8q) or SAN (e4, Nf3, O-O). The move played is written back. Returns false if the game is over or the move is not legal */
+    bool playMove(std::string_view text, Move & played);
+    bool playMove(const Move & move);
+
+    /* Ends the game with a win for the opponent of the color */
+    void resign(Color color);
+    void abandon(Color color);
+
+    bool isOver() const { return mEnd != GameEnd::None; }
+    GameEnd getEnd() const { return mEnd; }
+    const std::string & getResult() const { return mResult; } /* "1-0", "0-1", "1/2-1/2", or "*" while playing */
+
+    const Board & getBoard() const { return mBoard; }
+    Color getTurn() const { return mBoard.getTurn(); }
+    int getPlies() const { return static_cast<int>(mKeys.size()) - 1; }
+
+    /* Keys of every position of the game, the current one last */
+    const std::vector<std::uint64_t> & getKeys() const { return mKeys; }
+
+private:
+    void forfeit(Color color, GameEnd end);
+
+    Board mBoard;
+    std::vector<std::uint64_t> mKeys;
+    GameEnd mEnd;
+    std::string mResult;
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef KING_H
 #define KING_H
 
+/* ##### Standard Libraries ##### */
+#include <array>
+
 /* ##### Project Headers ##### */
 #include "Piece.hpp"
 
@@ -11,7 +14,7 @@ class King : public Piece {
 public:
     King(Color color, int position, Board * board, bool hasMoved);
     ~King() {}
-    Piece * clone(Board* newBoard) const override;
+    Piece * clone(Board* newBoard, void * memory) const override;
 
     void setKingSideCastleRight(bool state) { mKingSideCastle = state; }
     void setQueenSideCastleRight(bool state) { mQueenSideCastle = state; }
@@ -19,6 +22,8 @@ public:
     
     bool isChecked() const { return mInCheck; }
     bool hasCastleRights() const { return mKingSideCastle || mQueenSideCastle; }
+    bool hasKingSideCastleRight() const { return mKingSideCastle; }
+    bool hasQueenSideCastleRight() const { return mQueenSideCastle; }
 
     void computeMoves() override;
     void computeCastling();
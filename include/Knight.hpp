@@ -14,7 +14,7 @@ class Knight : public Piece {
 public:
     Knight(Color color, int position, Board * board) : Piece(color, PieceType::Knight, position, board, true) {}
     ~Knight() {}
-    Piece * clone(Board* newBoard) const override;
+    Piece * clone(Board* newBoard, void * memory) const override;
     void computeMoves() override;
 
 private:
@@ -0,0 +1,42 @@
+#ifndef LINE_SOCKET_H
+#define LINE_SOCKET_H
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/* Non-blocking socket of a line based protocol (POSIX). The text read is kept until it makes complete lines, and the text sent is kept until the socket accepts it, so an event loop never waits on one peer. The socket is not closed by this class */
+class LineSocket {
+public:
+    explicit LineSocket(int fd = -1) : mFd(fd), mInputOffset(0), mOutputOffset(0) {}
+
+    int getFd() const { return mFd; }
+
+    /* Reads everything the socket has. Returns false if the peer closed it, it failed, or a line is longer than MAX_LINE. The lines read before are still there to be taken */
+    bool receive();
+
+    /* Takes the next complete line, without its end of line ("\n" or "\r\n"). Returns false if there is none yet. The line is valid until the next receive */
+    bool nextLine(std::string_view & line);
+
+    /* Queues text, written by the next flush */
+    void send(std::string_view text) { mOutput.append(text.data(), text.size()); }
+
+    /* Writes what the socket accepts. Returns false if it failed */
+    bool flush();
+    bool hasOutput() const { return mOutputOffset < mOutput.size(); }
+
+    static const std::size_t MAX_LINE = 4096;
+
+private:
+    int mFd;
+    std::string mInput;
+    std::size_t mInputOffset; /* Start of the text not taken yet */
+    std::string mOutput;
+    std::size_t mOutputOffset; /* Start of the text not written yet */
+};
+
+/* Sets O_NONBLOCK on a file descriptor */
+bool setNonBlocking(int fd);
+
+#endif
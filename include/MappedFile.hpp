@@ -0,0 +1,32 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <string>
+
+/* Read-only memory mapped file (POSIX mmap). The file contents are paged in by the OS on demand, so large files can be accessed at random without reading them first */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /* Not copyable, the mapping has a single owner */
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    /* Maps the whole file. The sequential hint tells the OS the file will be read from start to end, so it can read ahead */
+    bool open(const std::string & path, bool sequential = false);
+    void close();
+
+    bool isOpen() const { return mOpen; }
+    const char * getData() const { return mData; }
+    std::size_t getSize() const { return mSize; }
+
+private:
+    const char * mData;
+    std::size_t mSize;
+    bool mOpen;
+};
+
+#endif
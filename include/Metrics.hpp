@@ -0,0 +1,154 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/* ##### Standard Libraries ##### */
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Aggregate counters and histograms of the engine, for capacity planning. Unlike SearchStats they are never reset: they add up everything the process did, on every thread.
+
+The values are sharded: a thread updates the slot of its shard, each slot on its own cache line, so the threads do not fight over the same line. Reading a value sums the shards. The metrics register themselves and are exported together as JSON or in the Prometheus text format */
+
+const std::size_t METRIC_SHARDS = 16;
+const std::size_t MAX_HISTOGRAM_BUCKETS = 15;
+
+/* Shard of the calling thread, given in turn to the threads as they first use a metric */
+inline std::size_t metricShard() {
+    static std::atomic<std::size_t> nextShard(0);
+    thread_local std::size_t shard = nextShard++ % METRIC_SHARDS;
+    return shard;
+}
+
+class Counter {
+public:
+    Counter(const std::string & name, const std::string & help);
+    ~Counter();
+    Counter(const Counter &) = delete;
+    Counter & operator=(const Counter &) = delete;
+
+    void add(std::uint64_t count = 1) { mShards[metricShard()].value.fetch_add(count, std::memory_order_relaxed); }
+    std::uint64_t getValue() const;
+
+    const std::string & getName() const { return mName; }
+    const std::string & getHelp() const { return mHelp; }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::string mName;
+    std::string mHelp;
+    std::array<Shard, METRIC_SHARDS> mShards;
+};
+
+/* Distribution of a value, e.g. a latency in seconds, in buckets given by their upper bounds. Values above the last bound go in an extra +Inf bucket */
+class Histogram {
+public:
+    Histogram(const std::string & name, const std::string & help, const std::vector<double> & bounds);
+    ~Histogram();
+    Histogram(const Histogram &) = delete;
+    Histogram & operator=(const Histogram &) = delete;
+
+    void observe(double value);
+
+    /* Counts of every bucket (not cumulative), the last one being +Inf */
+    struct Snapshot {
+        std::vector<std::uint64_t> counts;
+        std::uint64_t count = 0;
+        double sum = 0.0;
+    };
+    Snapshot getSnapshot() const;
+
+    const std::string & getName() const { return mName; }
+    const std::string & getHelp() const { return mHelp; }
+    const std::vector<double> & getBounds() const { return mBounds; }
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, MAX_HISTOGRAM_BUCKETS + 1> counts{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<double> sum{0.0};
+    };
+
+    std::string mName;
+    std::string mHelp;
+    std::vector<double> mBounds;
+    std::array<Shard, METRIC_SHARDS> mShards;
+};
+
+enum class MetricsFormat {JSON, Prometheus};
+
+/* Every metric of the process, in the order they were created */
+class MetricsRegistry {
+public:
+    static MetricsRegistry & instance();
+
+    void add(Counter * counter);
+    void add(Histogram * histogram);
+    void remove(const Counter * counter);
+    void remove(const Histogram * histogram);
+
+    std::string toJSON() const;
+    std::string toPrometheus() const;
+    std::string format(MetricsFormat format) const { return format == MetricsFormat::JSON ? toJSON() : toPrometheus(); }
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<Counter *> mCounters;
+    std::vector<Histogram *> mHistograms;
+};
+
+/* The metrics of the engine, created on first use */
+struct EngineMetrics {
+    Counter positionsGenerated{"cppchess_positions_generated_total", "Positions reached with Board::movePiece"};
+    Counter legalityChecks{"cppchess_legality_checks_total", "Moves checked with Board::validateMove"};
+    Counter searchNodes{"cppchess_search_nodes_total", "Nodes searched, including the quiescence nodes"};
+    Counter ttProbes{"cppchess_tt_probes_total", "Transposition table probes"};
+    Counter ttHits{"cppchess_tt_hits_total", "Transposition table hits"};
+    Counter cutoffs{"cppchess_search_cutoffs_total", "Beta cutoffs of the search"};
+    Counter evalCalls{"cppchess_eval_calls_total", "Static evaluations"};
+    Counter pgnBytesParsed{"cppchess_pgn_bytes_parsed_total", "Bytes of PGN text read by PGNReader"};
+    Counter gamesReplayed{"cppchess_games_replayed_total", "Games replayed to their end by replayGame"};
+    Histogram moveLatency{"cppchess_move_latency_seconds", "Time of ChessGame::handleProcessingMove", {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0}};
+};
+
+EngineMetrics & engineMetrics();
+
+/* Writes a snapshot of every metric. "-" is the standard output. A file is written next to the path and renamed over it, so a scraper never reads half of it */
+bool writeMetrics(const std::string & path, MetricsFormat format);
+
+/* Export options of the command line tools */
+struct MetricsOptions {
+    std::string path; /* Empty: no export */
+    MetricsFormat format = MetricsFormat::Prometheus;
+    double interval = 10.0; /* Seconds */
+};
+
+/* Reads --metrics <file|->, --metrics-format json|prometheus or --metrics-interval <seconds> at argv[i], moving i past its value. Returns false if argv[i] is none of them */
+bool parseMetricsArgument(int argc, char * argv[], int & i, MetricsOptions & options);
+
+/* Writes the metrics on a timer, from its own thread, and a last time when destroyed. Nothing is done if the options have no path */
+class MetricsExporter {
+public:
+    explicit MetricsExporter(const MetricsOptions & options);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter & operator=(const MetricsExporter &) = delete;
+
+private:
+    MetricsOptions mOptions;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    bool mStop;
+};
+
+#endif
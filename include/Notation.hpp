@@ -0,0 +1,35 @@
+#ifndef NOTATION_H
+#define NOTATION_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <string_view>
+
+/* Standard Algebraic Notation (SAN), as used by PGN files. More information: https://en.wikipedia.org/wiki/Algebraic_notation_(chess) */
+
+/* The longest SAN move (e.g. Qa1xb2#, exf8=Q+) has 7 characters, plus the null terminator */
+const std::size_t SAN_BUFFER_SIZE = 8;
+
+/* Piece letters used by SAN (N, B, R, Q, K). Pawns have no letter */
+char pieceToLetter(PieceType type);
+PieceType letterToPiece(char letter);
+
+/* Parses a SAN move (e.g. e4, Nbd7, exd6, R1a3, O-O-O, e8=Q+) for the side to move of the board. Returns false if the text does not match exactly one legal move */
+bool parseSAN(const Board & board, std::string_view san, Move & move);
+
+/* Writes the SAN of a legal move of the side to move into a null terminated buffer, with minimal disambiguation, promotion and check/checkmate suffixes. The suffix needs the position after the move: pass it if the move was already played, otherwise the move is simulated on a copy of the board. Returns the length written, or 0 if the move is not legal or does not fit */
+std::size_t writeSAN(const Board & board, const Move & move, char * buffer, std::size_t size, const Board * after = nullptr);
+
+/* Long algebraic notation, as used by UCI: the origin and destination squares, followed by the promotion piece in lower case (e.g. e2e4, e1g1, e7e8q) */
+const std::size_t UCI_BUFFER_SIZE = 6;
+
+/* Parses a UCI move for the side to move of the board. A promotion without its piece is a Queen. Returns false if it is not one of the legal moves */
+bool parseUCI(const Board & board, std::string_view uci, Move & move);
+
+/* Writes the UCI text of a move into a null terminated buffer. Returns the length written, or 0 if the squares are not valid or it does not fit */
+std::size_t writeUCI(const Move & move, char * buffer, std::size_t size);
+
+#endif
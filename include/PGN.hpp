@@ -0,0 +1,79 @@
+#ifndef PGN_H
+#define PGN_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* A tag pair of the PGN header, e.g. [White "Kasparov, Garry"] */
+struct PGNTag {
+    std::string name;
+    std::string value;
+};
+
+/* A game read from a PGN file. Only the main line is kept, as comments, NAGs and variations are skipped by the reader */
+struct PGNGame {
+    std::vector<PGNTag> tags;
+    std::vector<std::string> moves; /* SAN of the main line, without move numbers */
+    std::string result;
+
+    /* Clears the game, keeping the allocated memory so the same object can be reused for every game of a file */
+    void clear();
+
+    /* Returns the value of a tag, or nullptr if the game does not have it */
+    const std::string * findTag(const std::string & name) const;
+};
+
+/* Streaming PGN reader. The input is read in chunks of a fixed size buffer, so the memory used only depends on the size of a single game and not on the size of the file. More information: https://www.saremba.de/chessgml/standards/pgn/pgn-complete.htm */
+class PGNReader {
+public:
+    explicit PGNReader(std::istream & input, std::size_t bufferSize = 1 << 16); /* Reads from a stream */
+    PGNReader(const char * data, std::size_t size); /* Reads from memory, without copying */
+
+    /* Reads the next game. Returns false when there are no more games */
+    bool readGame(PGNGame & game);
+
+    /* Statistics */
+    std::uint64_t getBytesRead() const { return mOffset + (mCursor - mBegin); }
+    std::uint64_t getGamesRead() const { return mGamesRead; }
+
+private:
+    std::istream * mInput;
+    std::vector<char> mBuffer;
+    const char * mBegin; /* Start of the current chunk */
+    const char * mCursor;
+    const char * mEnd;
+    std::uint64_t mOffset; /* Bytes of the input before the current chunk */
+    std::uint64_t mGamesRead;
+    int mLastChar;
+    std::string mToken;
+
+    /* Buffer Handling */
+    bool refill();
+    int peek() { return (mCursor != mEnd || refill()) ? static_cast<unsigned char>(*mCursor) : EOF; }
+    int get();
+
+    /* Parsing Helpers */
+    bool parseGame(PGNGame & game);
+    void readTag(PGNGame & game);
+    void readToken();
+    void skipLine();
+    void skipComment();
+    void skipVariation();
+};
+
+/* Replays the main line of a game on the board, starting from the FEN tag if there is one or from the initial position otherwise. The moves played are stored if a vector is given. Returns false at the first move that cannot be read or played */
+bool replayGame(const PGNGame & game, Board & board, std::vector<Move> * moves = nullptr);
+
+/* Writes a game in export format: the tags, a blank line and the numbered moves wrapped at 80 columns, followed by the result. Move numbers start from the FEN tag if there is one */
+void writePGN(std::ostream & output, const PGNGame & game);
+
+#endif
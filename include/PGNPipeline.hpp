@@ -0,0 +1,86 @@
+#ifndef PGN_PIPELINE_H
+#define PGN_PIPELINE_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+#include "PGN.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/* A game parsed and replayed by the pipeline */
+struct PGNPipelineGame {
+    std::uint64_t index; /* Order of the game in the file */
+    PGNGame game;
+    std::vector<Move> moves; /* Moves played on the board, when replayed */
+    bool replayed;
+};
+
+/* Pipeline configuration */
+struct PGNPipelineOptions {
+    unsigned threads = 0; /* Replay workers, 0 uses every core */
+    std::size_t queueCapacity = 1024; /* Capacity of the range and result queues */
+    std::size_t maxInFlight = 8192; /* Games split but not yet delivered, which bounds the reordering memory */
+    bool replay = true; /* Replay the games on a Board, or only parse them */
+};
+
+/* Per stage statistics of a run */
+struct PGNPipelineStats {
+    double seconds = 0.0; /* Wall time of the whole run */
+
+    /* Splitter */
+    std::uint64_t ranges = 0;
+    std::uint64_t bytes = 0;
+    double splitSeconds = 0.0;
+
+    /* Workers (busy time is summed over all workers) */
+    unsigned workers = 0;
+    std::uint64_t games = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t failed = 0;
+    double workerSeconds = 0.0;
+
+    /* Sink */
+    std::uint64_t delivered = 0;
+    double sinkSeconds = 0.0;
+
+    /* Queue depths */
+    std::size_t rangeQueueMax = 0;
+    double rangeQueueAverage = 0.0;
+    std::size_t resultQueueMax = 0;
+    double resultQueueAverage = 0.0;
+    std::size_t reorderMax = 0; /* Games waiting in the sink for an earlier one */
+};
+
+/* Three stage PGN ingestion pipeline over a memory mapped file:
+   1. A splitter thread cuts the file into one byte range per game, at the [Event tags.
+   2. A pool of workers parses each range and replays it on its own Board.
+   3. The calling thread receives the games in file order, through the sink callback.
+   The stages are connected by bounded queues, so memory use does not depend on the size of the file */
+class PGNPipeline {
+public:
+    using Sink = std::function<void(const PGNPipelineGame &)>;
+
+    explicit PGNPipeline(const PGNPipelineOptions & options = PGNPipelineOptions());
+
+    /* Runs the pipeline on a file. Returns false if the file cannot be opened */
+    bool run(const std::string & path, const Sink & sink);
+
+    /* Runs the pipeline on a buffer that stays valid for the whole run */
+    void run(const char * data, std::size_t size, const Sink & sink);
+
+    const PGNPipelineStats & getStats() const { return mStats; }
+
+private:
+    PGNPipelineOptions mOptions;
+    PGNPipelineStats mStats;
+};
+
+/* Finds the start of the next game at or after offset: a [Event tag at the beginning of a line. Returns size if there is none */
+std::size_t findNextGame(const char * data, std::size_t size, std::size_t offset);
+
+#endif
@@ -11,7 +11,7 @@ class Pawn : public Piece {
 public:
     Pawn(Color color, int position, Board * board, bool hasMoved) : Piece(color, PieceType::Pawn, position, board, hasMoved) {}
     ~Pawn() {}
-    Piece * clone(Board* newBoard) const override;
+    Piece * clone(Board* newBoard, void * memory) const override;
     void computeMoves() override;      
 };
 
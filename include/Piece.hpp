@@ -2,7 +2,9 @@
 #define PIECE_H
 
 /* Standard Libraries */
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
 /* ##### Class Forward Declaration ##### */
 class Board;
@@ -10,11 +12,42 @@ class Board;
 enum class Color {White, Black};
 enum class PieceType {Empty, Pawn, Knight, Bishop, Rook, Queen, King};
 
+/* Destination squares of a piece. The capacity is the most moves a piece can have (a Queen in the centre of an empty board), so the squares are stored inline and copying a piece copies no heap memory */
+class PieceMoves {
+public:
+    static const int CAPACITY = 27;
+
+    PieceMoves() : mSquares(), mCount(0) {}
+
+    void push_back(int square) { if (mCount < CAPACITY) mSquares[mCount++] = static_cast<std::uint8_t>(square); }
+    void clear() { mCount = 0; }
+    std::size_t size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+
+    /* Keeps, in order, the squares for which keep returns true */
+    template <typename Predicate>
+    void filter(Predicate keep) {
+        std::uint8_t kept = 0;
+        for (std::uint8_t i = 0; i < mCount; ++i) {
+            if (keep(static_cast<int>(mSquares[i]))) mSquares[kept++] = mSquares[i];
+        }
+        mCount = kept;
+    }
+
+    const std::uint8_t * begin() const { return mSquares; }
+    const std::uint8_t * end() const { return mSquares + mCount; }
+
+private:
+    std::uint8_t mSquares[CAPACITY];
+    std::uint8_t mCount;
+};
+
 class Piece {
 public:
-    std::vector<int> validMoves;
+    PieceMoves validMoves;
     
-    virtual Piece * clone(Board* newBoard) const = 0;
+    /* Copies the piece for another board, building it in the given memory (see PieceArena) */
+    virtual Piece * clone(Board* newBoard, void * memory) const = 0;
     virtual void computeMoves() = 0;
     bool isValidMove(int toIndex);
 
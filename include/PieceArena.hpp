@@ -0,0 +1,51 @@
+#ifndef PIECE_ARENA_H
+#define PIECE_ARENA_H
+
+/* ##### Project Headers ##### */
+#include "Piece.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+
+/* Size of the memory of one piece: every piece type fits in a cache line */
+const std::size_t PIECE_SLOT_SIZE = 64;
+
+/* Pieces allocated by the calling thread. Each thread has its own counters, so the search threads do not share a cache line */
+struct PieceAllocationCounters {
+    std::uint64_t arenaAllocations = 0;
+    std::uint64_t heapAllocations = 0; /* Only when an arena is full, which no legal position does */
+    std::uint64_t releases = 0;
+};
+const PieceAllocationCounters & getPieceAllocationCounters();
+void resetPieceAllocationCounters();
+
+/* Fixed storage for the pieces of one Board, with one slot per piece of a legal position (32). The pieces are built in place in the slots, so creating, copying and capturing them does not go through the global new and delete. If every slot is used (only possible with an illegal position), pieces are allocated on the heap instead */
+class PieceArena {
+public:
+    static const int CAPACITY = 32;
+
+    PieceArena() : mUsed(0) {}
+    ~PieceArena() { reset(); }
+    PieceArena(const PieceArena &) = delete;
+    PieceArena & operator=(const PieceArena &) = delete;
+
+    /* Memory for a new piece: a free slot (the given one when it is free, otherwise the first one), or heap memory if the arena is full */
+    void * allocate(int preferredSlot = -1);
+
+    /* Destroys a piece created in memory from allocate */
+    void release(Piece * piece);
+
+    /* Destroys every piece still in a slot */
+    void reset();
+
+    /* Slot of a piece of this arena, or -1 if it was allocated on the heap */
+    int getSlot(const Piece * piece) const;
+    int getUsedCount() const;
+
+private:
+    alignas(64) unsigned char mStorage[CAPACITY][PIECE_SLOT_SIZE];
+    std::uint32_t mUsed; /* Bit i set if slot i has a piece */
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef POLYGLOT_BOOK_H
+#define POLYGLOT_BOOK_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include "PGN.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Opening book in the Polyglot .bin format: a sorted array of 16 byte big endian entries (key, move, weight, learn), keyed by the Zobrist key of the position (see Zobrist.hpp). More information: http://hgm.nubati.net/book_format.html
+
+Moves are packed as to file (bits 0-2), to row (3-5), from file (6-8), from row (9-11) and promotion (12-14: none, Knight, Bishop, Rook, Queen). Castling is written as the King capturing its own Rook (e1h1, e1a1, e8h8, e8a8) */
+
+const std::size_t POLYGLOT_ENTRY_SIZE = 16;
+
+struct PolyglotEntry {
+    std::uint64_t key;
+    std::uint16_t move;
+    std::uint16_t weight;
+    std::uint32_t learn;
+};
+
+struct BookMove {
+    Move move;
+    std::uint16_t weight;
+};
+
+/* Conversion between Polyglot moves and the moves of a position */
+std::uint16_t encodePolyglotMove(const Board & board, const Move & move);
+bool decodePolyglotMove(const Board & board, std::uint16_t polyglotMove, Move & move);
+
+/* Memory mapped book. The entries are read in place, finding a position is a binary search */
+class PolyglotBook {
+public:
+    PolyglotBook();
+
+    bool open(const std::string & path);
+    void close();
+
+    bool isOpen() const { return mFile.isOpen(); }
+    std::size_t getEntryCount() const { return mCount; }
+
+    /* Legal book moves of the position, by decreasing weight */
+    void findMoves(const Board & board, std::vector<BookMove> & moves) const;
+
+    /* Picks a book move at random, with a probability proportional to its weight. Returns false if the position is not in the book */
+    bool pickMove(const Board & board, std::mt19937_64 & random, Move & move) const;
+
+private:
+    MappedFile mFile;
+    const unsigned char * mData;
+    std::size_t mCount;
+
+    PolyglotEntry getEntry(std::size_t index) const;
+};
+
+/* Builds a book from games. Every move played in the first plies of the games gets a weight equal to the number of games that played it in that position */
+class PolyglotBookBuilder {
+public:
+    explicit PolyglotBookBuilder(int maxPly = 30, std::uint32_t minCount = 1);
+
+    /* Replays a game and counts its moves. Returns false if a move cannot be played, the moves before it are still counted */
+    bool addGame(const PGNGame & game);
+
+    /* Writes the book, sorted by key and by decreasing weight. Counts above 65535 are scaled down to fit the weight */
+    bool write(const std::string & path) const;
+
+    std::size_t getPositionMoveCount() const { return mCounts.size(); }
+
+private:
+    struct KeyMove {
+        std::uint64_t key;
+        std::uint16_t move;
+        bool operator==(const KeyMove & other) const { return key == other.key && move == other.move; }
+    };
+    struct KeyMoveHash {
+        std::size_t operator()(const KeyMove & keyMove) const { return static_cast<std::size_t>(keyMove.key ^ (static_cast<std::uint64_t>(keyMove.move) * 0x9E3779B97F4A7C15ULL)); }
+    };
+
+    int mMaxPly;
+    std::uint32_t mMinCount;
+    std::unordered_map<KeyMove, std::uint32_t, KeyMoveHash> mCounts;
+    Board mBoard;
+};
+
+#endif
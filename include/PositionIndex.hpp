@@ -0,0 +1,139 @@
+#ifndef POSITION_INDEX_H
+#define POSITION_INDEX_H
+
+/* ##### Project Headers ##### */
+#include "GameArchive.hpp"
+#include "MappedFile.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* Index of every position reached by the games of an archive, for finding the games that reached a position without replaying the whole database.
+
+Each position is an entry with its Zobrist key, the game (its index in the archive) and the ply. The entries are sorted by key, so a query is a binary search on the mapped file. A directory with the first entry of every key prefix narrows the search to a few entries before it starts, so a query only touches a handful of pages.
+
+The material of the positions is indexed the same way in a second section, keyed by the material signature instead (see materialSignature). A game has an entry for each material it went through, at the first ply that reached it, so the section is much smaller and is searched without a directory.
+
+File layout (little endian):
+   PositionIndexHeader
+   Entries     PositionEntry, sorted by key, game and ply
+   Directory   (1 << bucketBits) + 1 entry offsets, one per key prefix
+   Material    PositionEntry keyed by material signature, sorted by signature, game and ply
+*/
+
+const char POSITION_INDEX_MAGIC[8] = {'C', 'P', 'P', 'C', 'H', 'P', 'I', 'X'};
+const std::uint32_t POSITION_INDEX_VERSION = 2;
+const std::uint32_t POSITION_INDEX_BUCKET_BITS = 16;
+
+struct PositionIndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t bucketBits;
+    std::uint64_t entryCount;
+    std::uint64_t gameCount;
+    std::uint64_t entriesOffset;
+    std::uint64_t directoryOffset;
+    std::uint64_t materialCount;
+    std::uint64_t materialOffset;
+};
+
+struct PositionEntry {
+    std::uint64_t key;
+    std::uint32_t game;
+    std::uint16_t ply; /* 0 is the starting position */
+    std::uint8_t result; /* ArchiveResult of the game, so statistics do not need the archive */
+    std::uint8_t reserved;
+};
+
+/* Material signature: the number of pieces of each type and color, 4 bits each (Pawn to Queen, White in the low 20 bits, Black above). The Kings are not counted */
+std::uint64_t materialSignature(const Board & board);
+
+/* Signature of a material written as piece letters, White in uppercase and Black in lowercase, with both Kings (KRPkr). Returns false if the text is not one */
+bool parseMaterialSignature(std::string_view text, std::uint64_t & signature);
+
+/* Statistics of a position. Each game is counted once, even if it reached the position more than once */
+struct PositionStats {
+    std::uint64_t occurrences = 0;
+    std::uint64_t games = 0;
+    std::uint64_t whiteWins = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t blackWins = 0;
+    std::uint64_t unknown = 0;
+};
+
+/* Builds an index. The entries are collected in memory and, when there are too many, sorted and spilled to temporary run files that are merged when closing, so the memory used does not depend on the size of the database */
+class PositionIndexBuilder {
+public:
+    explicit PositionIndexBuilder(std::size_t runEntries = 1 << 24); /* 16 bytes per entry, 256 MB by default */
+    ~PositionIndexBuilder();
+
+    bool open(const std::string & path);
+
+    /* Replays a game of the archive and adds all its positions. Returns false if the game cannot be decoded */
+    bool addGame(const GameArchive & archive, std::uint64_t index);
+
+    /* Sorts or merges the entries and writes the index. Returns false on a write error */
+    bool close();
+
+    std::uint64_t getEntryCount() const { return mEntryCount; }
+    std::uint64_t getMaterialEntryCount() const { return mMaterialCount; }
+    std::size_t getRunCount() const { return mRuns.size() + mMaterialRuns.size(); }
+
+private:
+    std::string mPath;
+    std::size_t mRunEntries;
+    std::vector<PositionEntry> mEntries;
+    std::vector<std::string> mRuns;
+    std::vector<PositionEntry> mMaterialEntries;
+    std::vector<std::string> mMaterialRuns;
+    std::uint64_t mEntryCount;
+    std::uint64_t mMaterialCount;
+    std::uint64_t mGameCount;
+    bool mOpen;
+
+    Board mBoard;
+    std::vector<Move> mLegalMoves;
+
+    bool writeRun(std::vector<PositionEntry> & entries, std::vector<std::string> & runs, const char * name);
+    void removeRuns();
+};
+
+/* Memory mapped index reader */
+class PositionIndex {
+public:
+    PositionIndex();
+
+    bool open(const std::string & path);
+    void close();
+
+    std::uint64_t getEntryCount() const { return mHeader ? mHeader->entryCount : 0; }
+    std::uint64_t getGameCount() const { return mHeader ? mHeader->gameCount : 0; }
+    std::uint64_t getMaterialEntryCount() const { return mHeader ? mHeader->materialCount : 0; }
+
+    /* Entries of a position, sorted by game and ply. Empty if no game reached it */
+    std::pair<const PositionEntry *, const PositionEntry *> find(std::uint64_t key) const;
+
+    /* Entries and win/draw/loss statistics of the position of a FEN. At most maxMatches entries are returned, the statistics count all of them. Returns false if the FEN is invalid */
+    bool query(const std::string & fen, std::vector<PositionEntry> & matches, PositionStats & stats, std::size_t maxMatches = std::numeric_limits<std::size_t>::max()) const;
+
+    /* Games that reached a material signature, each entry at the first ply with that material. Empty if no game reached it */
+    std::pair<const PositionEntry *, const PositionEntry *> findMaterial(std::uint64_t signature) const;
+
+    /* Same as query, for a material written as piece letters (KRPkr). Returns false if the text is not a material */
+    bool queryMaterial(std::string_view material, std::vector<PositionEntry> & matches, PositionStats & stats, std::size_t maxMatches = std::numeric_limits<std::size_t>::max()) const;
+
+private:
+    MappedFile mFile;
+    const PositionIndexHeader * mHeader;
+    const PositionEntry * mEntries;
+    const std::uint64_t * mDirectory;
+    const PositionEntry * mMaterial;
+};
+
+#endif
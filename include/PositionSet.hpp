@@ -0,0 +1,48 @@
+#ifndef POSITION_SET_H
+#define POSITION_SET_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Hash of the bytes of a packed position */
+std::uint64_t hashPackedBoard(const PackedBoard & packed);
+
+/* Set of packed positions, for de-duplicating the positions of millions of games. Open addressing with linear probing over a flat array of 32 byte slots, grown to twice its size above 70% load. A slot is empty when its occupancy is 0, which no valid position has */
+class PositionSet {
+public:
+    explicit PositionSet(std::size_t expected = 0);
+
+    /* Reserves the slots for a number of positions, so that inserting them does not grow the set */
+    void reserve(std::size_t expected);
+    void clear();
+
+    /* Returns true if the position was not in the set */
+    bool insert(const PackedBoard & packed);
+    bool contains(const PackedBoard & packed) const;
+
+    std::size_t getSize() const { return mSize; }
+    std::size_t getCapacity() const { return mSlots.size(); }
+    std::size_t getMemoryUsage() const { return mSlots.size() * sizeof(PackedBoard); }
+
+    /* Visits every position, in no particular order */
+    template <typename Function>
+    void forEach(Function && function) const {
+        for (const PackedBoard & slot : mSlots)
+            if (slot.occupancy) function(slot);
+    }
+
+private:
+    std::vector<PackedBoard> mSlots;
+    std::size_t mMask;
+    std::size_t mSize;
+
+    std::size_t findSlot(const PackedBoard & packed) const;
+    void rehash(std::size_t capacity);
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef QUEEN_H
 #define QUEEN_H
 
+/* ##### Standard Libraries ##### */
+#include <array>
+
 /* ##### Project Headers ##### */
 #include "Piece.hpp"
 
@@ -12,7 +15,7 @@ public:
     Queen(Color color, int position, Board * board) : Piece(color, PieceType::Queen, position, board, true) {}  
     ~Queen() {}
     void computeMoves() override;
-    Piece * clone(Board* newBoard) const override;
+    Piece * clone(Board* newBoard, void * memory) const override;
 
 private:
     static std::array<const int, 8> mOffsets;
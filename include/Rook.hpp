@@ -1,6 +1,9 @@
 #ifndef ROOK_H
 #define ROOK_H
 
+/* ##### Standard Libraries ##### */
+#include <array>
+
 /* ##### Project Headers ##### */
 #include "Piece.hpp"
 
@@ -12,7 +15,7 @@ public:
     Rook(Color color, int position, Board * board) : Piece(color, PieceType::Rook, position, board, true) {}
     ~Rook() {}
     void computeMoves() override;
-    Piece * clone(Board* newBoard) const override;
+    Piece * clone(Board* newBoard, void * memory) const override;
     
 private:
     static std::array<const int, 4> mOffsets;
@@ -0,0 +1,120 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+#include "PolyglotBook.hpp"
+#include "Tablebase.hpp"
+#include "TranspositionTable.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+/* ##### Search Constants ##### */
+const int MAX_SEARCH_DEPTH = 64;
+const int MAX_SEARCH_PLY = 128;
+const int INFINITE_SCORE = 32000;
+const int MATE_SCORE = 30000;
+const int MATE_BOUND = MATE_SCORE - MAX_SEARCH_PLY; /* Scores beyond it are mates, in MATE_SCORE - |score| plies */
+const int TB_WIN_SCORE = MATE_BOUND - MAX_SEARCH_PLY; /* Tablebase wins, in TB_WIN_SCORE - |score| plies to the probed position */
+const int TB_WIN_BOUND = TB_WIN_SCORE - MAX_SEARCH_PLY;
+
+/* Limits of a search. Zero means no limit */
+struct SearchLimits {
+    int depth = MAX_SEARCH_DEPTH;
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+    bool useBook = true;
+    bool useTablebase = false; /* Opt-in: the Syzygy decoder has not been checked against real tables yet, and a wrong probe drops winning root moves */
+};
+
+struct SearchStats {
+    std::uint64_t nodes = 0; /* Including the quiescence nodes */
+    std::uint64_t qnodes = 0;
+    std::uint64_t ttProbes = 0;
+    std::uint64_t ttHits = 0;
+    std::uint64_t cutoffs = 0;
+    std::uint64_t evalCalls = 0;
+    std::uint64_t tbHits = 0;
+    int depth = 0; /* Last completed iteration */
+    int selDepth = 0;
+    double seconds = 0.0;
+};
+
+struct SearchResult {
+    Move bestMove = {-1, -1, PieceType::Empty}; /* from = -1 if there are no legal moves */
+    int score = 0; /* Centipawns from the point of view of the side to move */
+    int depth = 0;
+    bool fromBook = false;
+    std::vector<Move> pv;
+};
+
+/* Alpha-beta engine: iterative deepening with principal variation search, a transposition table, check extensions, and a quiescence search of captures and promotions. Moves are ordered by the table move, captures (most valuable victim first), promotions and killer moves.
+
+The board has no undo, so every child position is a copy of its parent with the move played. One Search is used by one thread at a time; run several of them for parallel games */
+class Search {
+public:
+    explicit Search(std::size_t hashMegabytes = 16);
+
+    /* Searches the position. The history holds the keys of the positions played before it in the game, for detecting repetitions */
+    SearchResult think(const Board & board, const SearchLimits & limits, const std::vector<std::uint64_t> & history = {});
+
+    /* Stops the search from another thread. think returns the best move of the last completed iteration */
+    void stop() { mStop = true; }
+
+    /* Forgets the previous searches */
+    void clear();
+    void setHashSize(std::size_t megabytes) { mTable.resize(megabytes); }
+
+    /* The book is probed before searching, picking one of its moves at random (weighted). The seed makes the choices reproducible */
+    void setBook(const PolyglotBook * book, std::uint64_t seed = 0);
+
+    /* With tablebases, the root moves are first reduced to the ones that keep the best result, and positions with few pieces are probed in the search instead of searched. Only positions right after a capture or pawn move are probed, at the given depth or more, with at most the given number of pieces */
+    void setTablebase(const Tablebase * tablebase, int probeDepth = 1, int probeLimit = TB_MAX_PIECES);
+
+    /* Called after every completed iteration */
+    using InfoCallback = std::function<void(const SearchResult &, const SearchStats &)>;
+    void setInfoCallback(const InfoCallback & callback) { mInfoCallback = callback; }
+
+    const SearchStats & getStats() const { return mStats; }
+    int getHashFull() const { return mTable.getHashFull(); }
+
+private:
+    TranspositionTable mTable;
+    const PolyglotBook * mBook;
+    std::mt19937_64 mRandom;
+    const Tablebase * mTablebase;
+    int mProbeDepth;
+    int mProbeLimit;
+    InfoCallback mInfoCallback;
+
+    std::atomic<bool> mStop;
+    bool mAborted;
+    SearchLimits mLimits;
+    std::chrono::steady_clock::time_point mStart;
+    SearchStats mStats;
+
+    Move mRootBest;
+    std::vector<Move> mRootMoves;
+    std::vector<std::uint64_t> mKeys; /* Game history and the current search path */
+    std::array<std::array<Move, 2>, MAX_SEARCH_PLY> mKillers;
+    std::vector<std::vector<Move>> mMoveLists; /* One per ply, to reuse their memory */
+    std::vector<std::vector<int>> mMoveScores;
+
+    int searchNode(const Board & board, int depth, int alpha, int beta, int ply);
+    int quiescence(const Board & board, int alpha, int beta, int ply);
+    void orderMoves(const Board & board, std::vector<Move> & moves, const Move & ttMove, int ply);
+    bool isRepetition(std::uint64_t key, int halfMoveClock) const;
+    bool probeTablebase(const Board & board, int depth, int ply, int & score);
+    bool shouldStop();
+    void extractPV(const Board & board, int depth, std::vector<Move> & pv) const;
+};
+
+#endif
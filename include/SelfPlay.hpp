@@ -0,0 +1,76 @@
+#ifndef SELF_PLAY_H
+#define SELF_PLAY_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+#include "PGN.hpp"
+#include "Search.hpp"
+#include "Tablebase.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+/* A starting position for self-play: a FEN and the moves (SAN) played from it */
+struct Opening {
+    std::string fen;
+    std::vector<std::string> moves;
+};
+
+/* Loads the openings of a file: EPD files (.epd) have one position per line, PGN files give the first plies of each game. Returns false if the file cannot be read or has no openings */
+bool loadOpenings(const std::string & path, int plies, std::vector<Opening> & openings);
+
+/* Plays random legal moves from the initial position. Returns false if the game ended during them */
+bool randomOpening(int plies, std::mt19937_64 & random, Opening & opening);
+
+/* How a game ended */
+enum class GameEnd {None, Checkmate, Stalemate, Repetition, FiftyMoves, InsufficientMaterial, Tablebase, MaxLength, Resignation, Abandoned};
+
+/* Number of GameEnd values, to size arrays indexed by them. Abandoned must stay the last one */
+constexpr int GAME_END_COUNT = static_cast<int>(GameEnd::Abandoned) + 1;
+
+const char * gameEndName(GameEnd end);
+
+/* Checks if the game is over in the position, setting the result to "1-0", "0-1" or "1/2-1/2". The keys are those of every position of the game, the current one last. With a tablebase, positions it covers are adjudicated by their WDL (cursed wins and blessed losses are draws) */
+GameEnd adjudicate(const Board & board, const std::vector<std::uint64_t> & keys, const Tablebase * tablebase, std::string & result);
+
+struct SelfPlayOptions {
+    SearchLimits limits[2]; /* White, Black */
+    int maxPlies = 600;     /* Longer games are drawn */
+    const Tablebase * tablebase = nullptr;
+};
+
+/* Called with every position searched in a game and its search result, before the move is played */
+using SelfPlayCallback = std::function<void(const Board &, const SearchResult &)>;
+
+/* Plays a game from an opening, each side searched by its own engine. The moves and the result are written to the record, with a FEN tag if the game does not start from the initial position. Returns how the game ended, or GameEnd::None if the opening cannot be played */
+GameEnd playGame(const Opening & opening, Search & white, Search & black, const SelfPlayOptions & options, PGNGame & record, const SelfPlayCallback & callback = nullptr);
+
+/* ##### Match Statistics ##### */
+/* Score of a match from the point of view of the first engine. The Elo difference comes from the logistic model, its margin is the 95% confidence interval of the mean game score, and the sequential probability ratio test (SPRT) uses the normal approximation of the log-likelihood ratio between two Elo hypotheses. More information: https://www.chessprogramming.org/Match_Statistics */
+struct MatchScore {
+    std::uint64_t wins = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t losses = 0;
+
+    std::uint64_t getGames() const { return wins + draws + losses; }
+    double getScore() const;
+    double getElo() const;
+    double getEloMargin() const;
+
+    /* Log-likelihood ratio of elo1 against elo0 */
+    double getLLR(double elo0, double elo1) const;
+};
+
+/* Elo difference of a mean score, and back */
+double scoreToElo(double score);
+double eloToScore(double elo);
+
+/* SPRT bounds: the test accepts elo1 above the upper one and elo0 below the lower one */
+double sprtLowerBound(double alpha, double beta);
+double sprtUpperBound(double alpha, double beta);
+
+#endif
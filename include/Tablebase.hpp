@@ -0,0 +1,74 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Syzygy endgame tablebase probing. WDL tables (.rtbw) give the result of a position under the 50-move rule, DTZ tables (.rtbz) the distance in plies to the next capture or pawn move (zeroing move) that keeps that result. More information: https://www.chessprogramming.org/Syzygy_Bases
+
+The files are found by name in the configured directories, and each one is only memory mapped the first time a position of its material is probed. Probing is thread safe. The tables do not cover castling rights, so positions with them are never probed */
+
+const int TB_MAX_PIECES = 7;
+
+/* Result of a position for the side to move. Cursed wins and blessed losses are wins and losses that the 50-move rule turns into draws */
+enum class WDLScore : int {Loss = -2, BlessedLoss = -1, Draw = 0, CursedWin = 1, Win = 2};
+
+struct TBTable;
+
+class Tablebase {
+public:
+    Tablebase();
+    ~Tablebase();
+
+    /* Not copyable, the tables own their mappings */
+    Tablebase(const Tablebase &) = delete;
+    Tablebase & operator=(const Tablebase &) = delete;
+
+    /* Finds the table files in a list of directories separated by ':' (';' on Windows). Returns the number of WDL tables found */
+    std::size_t init(const std::string & paths);
+
+    /* Largest number of pieces (Kings included) with WDL tables, 0 if there are none */
+    int getMaxPieces() const { return mMaxPieces; }
+    std::size_t getWDLCount() const { return mWDLCount; }
+    std::size_t getDTZCount() const { return mDTZCount; }
+
+    /* Probes the WDL tables. Returns false if the position is not covered (too many pieces, castling rights, missing or corrupt file) */
+    bool probeWDL(const Board & board, WDLScore & wdl) const;
+
+    /* Probes the DTZ tables: plies to the next zeroing move with the best play, positive if the side to move wins, negative if it loses (-1 if mated), 0 for draws. Cursed wins and blessed losses are shifted by 100 */
+    bool probeDTZ(const Board & board, int & dtz) const;
+
+    /* Keeps only the best root moves: the ones that win (or draw, or delay the loss) while respecting the 50-move rule, using DTZ if available and WDL otherwise. The WDL of the root is returned. Returns false, leaving the moves as they are, if the position is not covered */
+    bool filterRootMoves(const Board & board, std::vector<Move> & moves, WDLScore & wdl) const;
+
+private:
+    std::vector<std::unique_ptr<TBTable>> mTables;
+    std::unordered_map<std::uint64_t, TBTable *> mWDL;
+    std::unordered_map<std::uint64_t, TBTable *> mDTZ;
+    std::size_t mWDLCount;
+    std::size_t mDTZCount;
+    int mMaxPieces;
+    mutable std::mutex mMapMutex;
+
+    enum class ProbeState {Fail, Ok, ChangeSide, ZeroingBestMove};
+
+    void addTable(const std::string & path, const std::string & name, bool dtz);
+    bool mapTable(TBTable & table) const;
+    int probeTable(const Board & board, bool dtz, WDLScore wdl, ProbeState & state) const;
+    WDLScore search(const Board & board, bool checkZeroing, ProbeState & state) const;
+    WDLScore probeWDL(const Board & board, ProbeState & state) const;
+    int probeDTZ(const Board & board, ProbeState & state) const;
+    bool rankRootMoves(const Board & board, std::vector<Move> & moves, std::vector<int> & ranks, bool useDTZ) const;
+    bool isCovered(const Board & board) const;
+};
+
+#endif
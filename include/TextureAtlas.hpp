@@ -0,0 +1,71 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+/* ##### SDL Include ##### */
+#include <SDL.h>
+#include <SDL_image.h>
+
+/* ##### Standard Libraries ##### */
+#include <string>
+#include <vector>
+
+/* Several images packed in a single texture, so they can all be drawn with the same texture. The sprites are numbered in the order the images were given, and a small white sprite is added after them to draw solid colored rectangles */
+class TextureAtlas {
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+    void free();
+
+    /* Loads the PNG images and packs them */
+    bool load(const std::vector<std::string> & paths, SDL_Renderer * renderer);
+
+    /* Packs already decoded images, which are kept by the caller */
+    bool build(const std::vector<SDL_Surface *> & images, SDL_Renderer * renderer);
+
+    SDL_Texture * getTexture() const { return mTexture; }
+    int getWidth() const { return mWidth; }
+    int getHeight() const { return mHeight; }
+    int getSpriteCount() const { return static_cast<int>(mSprites.size()); }
+    int getSolidSprite() const { return mSolidSprite; }
+    const SDL_Rect & getSprite(int sprite) const { return mSprites[sprite]; }
+
+private:
+    SDL_Texture * mTexture;
+    int mWidth;
+    int mHeight;
+    int mSolidSprite;
+    std::vector<SDL_Rect> mSprites; /* Pixels of each sprite in the texture */
+};
+
+/* Sprites of an atlas collected during a frame and submitted with a single SDL_RenderGeometry call. They are drawn in the order they were added, so the layering is kept */
+class SpriteBatch {
+public:
+    explicit SpriteBatch(const TextureAtlas & atlas);
+
+    /* Adds a sprite stretched over the rectangle. The color multiplies the sprite, its alpha fading it */
+    void add(int sprite, const SDL_Rect & dstRect, SDL_Color color = {0xFF, 0xFF, 0xFF, 0xFF});
+    /* Same, placed with sub-pixel precision, as SDL_RenderCopyF */
+    void addF(int sprite, const SDL_FRect & dstRect, SDL_Color color = {0xFF, 0xFF, 0xFF, 0xFF});
+
+    /* Adds a solid rectangle */
+    void addRect(const SDL_Rect & dstRect, SDL_Color color);
+
+    /* Draws everything added since the last flush. Returns false if SDL failed to draw */
+    bool flush(SDL_Renderer * renderer);
+
+    int getQuadCount() const { return static_cast<int>(mIndices.size() / 6); }
+    bool isEmpty() const { return mIndices.empty(); }
+
+    /* Number of SDL_RenderGeometry calls made, e.g. for statistics */
+    unsigned long getDrawCalls() const { return mDrawCalls; }
+
+private:
+    const TextureAtlas & mAtlas;
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+    unsigned long mDrawCalls;
+
+    void addQuad(const SDL_FRect & dstRect, float u0, float v0, float u1, float v1, SDL_Color color);
+};
+
+#endif
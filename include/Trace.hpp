@@ -0,0 +1,55 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/* ##### Standard Libraries ##### */
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/* Timeline tracing in the Chrome trace event format, which chrome://tracing and Perfetto (ui.perfetto.dev) open. A zone records when a scope started and how long it took, on the thread that ran it.
+
+Tracing is compiled in with the CPPCHESS_TRACE CMake option. Without it, TRACE_ZONE expands to nothing and the instrumented code is the same as without the zones. With it, every thread appends to its own buffer without locks: only the first zone of a thread takes a lock, to register its buffer.
+
+The category and name of a zone must be string literals, as only their address is kept */
+#ifdef CPPCHESS_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(category, name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(category, name)
+#else
+#define TRACE_ZONE(category, name) do {} while (false)
+#endif
+
+/* True when built with CPPCHESS_TRACE */
+bool isTraceEnabled();
+
+/* Appends a zone to the buffer of the calling thread. A thread keeps at most TRACE_MAX_EVENTS, the zones after them are dropped and counted */
+void recordTraceZone(const char * category, const char * name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+/* Name of the calling thread in the timeline */
+void setTraceThreadName(const std::string & name);
+
+/* Writes the zones recorded so far by every thread as Chrome trace JSON. The threads keep recording meanwhile. Returns false if tracing is not compiled in or the file cannot be written */
+bool writeTrace(const std::string & path);
+
+/* Totals over every thread */
+std::uint64_t getTraceEventCount();
+std::uint64_t getTraceDroppedCount();
+
+const std::uint64_t TRACE_MAX_EVENTS = 1 << 20;
+
+/* Records the time from its construction to its destruction */
+class TraceZone {
+public:
+    TraceZone(const char * category, const char * name) : mCategory(category), mName(name), mStart(std::chrono::steady_clock::now()) {}
+    ~TraceZone() { recordTraceZone(mCategory, mName, mStart, std::chrono::steady_clock::now()); }
+
+    TraceZone(const TraceZone &) = delete;
+    TraceZone & operator=(const TraceZone &) = delete;
+
+private:
+    const char * mCategory;
+    const char * mName;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+#endif
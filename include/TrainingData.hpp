@@ -0,0 +1,52 @@
+#ifndef TRAINING_DATA_H
+#define TRAINING_DATA_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* A labelled position for training evaluation weights, packed in 32 bytes. The files are plain sequences of records, little endian */
+struct TrainingRecord {
+    std::uint64_t occupancy;  /* Bit i set if square i (a1 = 0) has a piece */
+    std::uint8_t pieces[16];  /* 4 bits per occupied square in square order, low nibble first: 1-6 White Pawn to King, 9-14 Black */
+    std::int16_t score;       /* Search score in centipawns, from the side to move */
+    std::uint8_t flags;       /* Bit 0: Black to move. Bits 1-4: castling rights (KQkq) */
+    std::int8_t result;       /* Game result from the side to move: 1 win, 0 draw, -1 loss */
+    std::uint8_t enPassant;   /* En passant target square + 1, 0 if none */
+    std::uint8_t halfMoveClock;
+    std::uint16_t fullMoveClock;
+};
+
+/* Packs a position with its score. The result is set when the game is over. Returns false if the position has more than 32 pieces */
+bool packTrainingRecord(const Board & board, int score, TrainingRecord & record);
+
+/* FEN of a record, e.g. for inspecting a file */
+std::string trainingRecordToFEN(const TrainingRecord & record);
+
+/* Buffered writer of one file. Each thread uses its own writer (and file), so writing needs no locking */
+class TrainingDataWriter {
+public:
+    explicit TrainingDataWriter(std::size_t bufferRecords = 1 << 15);
+    ~TrainingDataWriter();
+
+    bool open(const std::string & path);
+    void write(const TrainingRecord & record);
+    bool close();
+
+    std::uint64_t getRecordCount() const { return mCount; }
+
+private:
+    std::ofstream mFile;
+    std::vector<TrainingRecord> mBuffer;
+    std::uint64_t mCount;
+
+    void flush();
+};
+
+#endif
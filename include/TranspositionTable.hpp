@@ -0,0 +1,56 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Bound of a stored score: exact, or only an upper/lower bound after an alpha-beta cutoff */
+enum class Bound : std::uint8_t {None, Exact, Lower, Upper};
+
+/* A search result for a position, indexed by its Zobrist key. 16 bytes, so four entries share a cache line */
+struct TTEntry {
+    std::uint64_t key;
+    std::uint16_t move; /* Packed with packMove */
+    std::int16_t score;
+    std::int8_t depth;
+    Bound bound;
+    std::uint8_t generation;
+    std::uint8_t reserved;
+};
+
+/* Moves packed into 16 bits: from (6 bits), to (6 bits) and promotion (3 bits). 0 is no move, as a move from a1 to a1 is impossible */
+std::uint16_t packMove(const Move & move);
+Move unpackMove(std::uint16_t packed);
+
+/* Transposition table, a hash table of search results with one entry per slot. An entry is replaced by a search of the same or greater depth, or by any search of a newer generation (a later call to think) */
+class TranspositionTable {
+public:
+    explicit TranspositionTable(std::size_t megabytes = 16);
+
+    /* Resizes the table, clearing it. The number of entries is rounded down to a power of two */
+    void resize(std::size_t megabytes);
+    void clear();
+
+    /* Starts a new search, so the entries of the previous ones can be replaced first */
+    void newSearch() { ++mGeneration; }
+
+    /* Returns the entry of the key, or nullptr if it is not stored */
+    const TTEntry * probe(std::uint64_t key) const;
+    void store(std::uint64_t key, const Move & move, int score, int depth, Bound bound);
+
+    /* Permille of the table used by the current search, estimated from the first 1000 entries */
+    int getHashFull() const;
+    std::size_t getSize() const { return mEntries.size(); }
+
+private:
+    std::vector<TTEntry> mEntries;
+    std::uint64_t mMask;
+    std::uint8_t mGeneration;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+/* ##### Project Headers ##### */
+#include "Board.hpp"
+
+/* ##### Standard Libraries ##### */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Zobrist hashing: a position is identified by the XOR of one random 64 bit key per piece on its square, plus keys for the castling rights, the en passant file and the side to move. The clocks are not part of the key, so transpositions reached at different move numbers share it. More information: https://www.chessprogramming.org/Zobrist_Hashing
+
+The keys follow the Polyglot layout (781 keys):
+   0 - 767     Pieces, at 64 * kind + square, with kind = 2 * (type - Pawn) + (1 if White)
+   768 - 771   Castling rights: White King side, White Queen side, Black King side, Black Queen side
+   772 - 779   En passant file, only when a pawn of the side to move can actually capture
+   780         White to move
+*/
+
+const std::size_t ZOBRIST_KEY_COUNT = 781;
+const std::size_t ZOBRIST_CASTLING = 768;
+const std::size_t ZOBRIST_EN_PASSANT = 772;
+const std::size_t ZOBRIST_TURN = 780;
+
+/* The keys, the Random64 table of Polyglot so that books made by other programs can be probed. Entries 556 - 679 are not transcribed yet (see Zobrist.cpp) */
+const std::array<std::uint64_t, ZOBRIST_KEY_COUNT> & getZobristKeys();
+
+/* Key of a piece on a square */
+std::uint64_t zobristPieceKey(PieceType type, Color color, int square);
+
+/* Computes the key of a position from scratch */
+std::uint64_t computeZobristKey(const Board & board);
+
+/* Checks the keys against the positions published with the Polyglot format. Returns false, with the positions whose key differs printed, if books made by other programs would not be found */
+bool verifyPolyglotKeys();
+
+/* Quiet check of the initial position key only, true if the keys are those of Polyglot */
+bool hasPolyglotKeys();
+
+#endif
@@ -0,0 +1,38 @@
+/* Standard Libraries */
+#include <cstdlib>
+#include <new>
+
+/* Include other defined headers */
+#include "AllocationCounter.hpp"
+
+static std::uint64_t gAllocations = 0;
+
+std::uint64_t getAllocationCount() {
+    return gAllocations;
+}
+
+void * operator new(std::size_t size) {
+    ++gAllocations;
+    if (void * memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void * memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void * memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void * memory, std::size_t) noexcept {
+    std::free(memory);
+}
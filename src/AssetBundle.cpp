@@ -0,0 +1,126 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+/* Include other defined headers */
+#include "AssetBundle.hpp"
+
+/* The tables are read in place from the mapped file, so their layout must not depend on the compiler */
+static_assert(sizeof(BundleHeader) == 32, "Unexpected BundleHeader layout");
+static_assert(sizeof(BundleEntry) == 24, "Unexpected BundleEntry layout");
+
+/* Bytes needed to align an offset to 8 bytes */
+static std::uint64_t paddingFor(std::uint64_t offset) {
+    return (8 - (offset % 8)) % 8;
+}
+
+/* ##### Writer ##### */
+bool writeAssetBundle(const std::string & path, const std::string & root, const std::vector<std::string> & names) {
+    std::vector<std::string> sorted(names);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    /* Read every asset first, so a missing file leaves no bundle behind */
+    std::vector<std::string> contents;
+    for (const std::string & name : sorted) {
+        std::ifstream file(root + "/" + name, std::ios::binary);
+        if (!file) return false;
+        contents.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::string namesSection;
+    std::vector<BundleEntry> entries(sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        entries[i].name = static_cast<std::uint32_t>(namesSection.size());
+        namesSection += sorted[i];
+        namesSection += '\0';
+    }
+
+    BundleHeader header = {};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = BUNDLE_VERSION;
+    header.entryCount = static_cast<std::uint32_t>(entries.size());
+    header.namesOffset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+    header.namesSize = namesSection.size();
+
+    std::uint64_t offset = header.namesOffset + header.namesSize;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        offset += paddingFor(offset);
+        entries[i].offset = offset;
+        entries[i].size = contents[i].size();
+        offset += contents[i].size();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    const char zeros[8] = {};
+    std::uint64_t written = 0;
+    auto write = [&](const char * data, std::uint64_t size) {
+        file.write(data, static_cast<std::streamsize>(size));
+        written += size;
+    };
+
+    write(reinterpret_cast<const char *>(&header), sizeof(header));
+    write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(BundleEntry));
+    write(namesSection.data(), namesSection.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        write(zeros, paddingFor(written));
+        write(contents[i].data(), contents[i].size());
+    }
+    return static_cast<bool>(file);
+}
+
+/* ##### AssetBundle ##### */
+AssetBundle::AssetBundle() : mHeader(nullptr), mEntries(nullptr), mNames(nullptr) {}
+
+bool AssetBundle::open(const std::string & path) {
+    close();
+    if (!mFile.open(path)) return false;
+
+    const char * data = mFile.getData();
+    std::uint64_t size = mFile.getSize();
+    if (size < sizeof(BundleHeader)) { close(); return false; }
+
+    const BundleHeader * header = reinterpret_cast<const BundleHeader *>(data);
+    bool valid = std::memcmp(header->magic, BUNDLE_MAGIC, sizeof(header->magic)) == 0 && header->version == BUNDLE_VERSION
+        && header->entryCount <= (size - sizeof(BundleHeader)) / sizeof(BundleEntry)
+        && header->namesOffset <= size && header->namesSize <= size - header->namesOffset
+        && (header->namesSize == 0 || data[header->namesOffset + header->namesSize - 1] == '\0');
+    if (!valid) { close(); return false; }
+
+    const BundleEntry * entries = reinterpret_cast<const BundleEntry *>(data + sizeof(BundleHeader));
+    for (std::uint32_t i = 0; i < header->entryCount; ++i) {
+        if (entries[i].name >= header->namesSize || entries[i].offset > size || entries[i].size > size - entries[i].offset) {
+            close();
+            return false;
+        }
+    }
+
+    mHeader = header;
+    mEntries = entries;
+    mNames = data + header->namesOffset;
+    return true;
+}
+
+void AssetBundle::close() {
+    mFile.close();
+    mHeader = nullptr;
+    mEntries = nullptr;
+    mNames = nullptr;
+}
+
+const char * AssetBundle::find(const std::string & name, std::size_t & size) const {
+    if (!mHeader) return nullptr;
+
+    const BundleEntry * end = mEntries + mHeader->entryCount;
+    const BundleEntry * entry = std::lower_bound(mEntries, end, name, [&](const BundleEntry & a, const std::string & key) {
+        return std::strcmp(mNames + a.name, key.c_str()) < 0;
+    });
+    if (entry == end || name != mNames + entry->name) return nullptr;
+
+    size = entry->size;
+    return mFile.getData() + entry->offset;
+}
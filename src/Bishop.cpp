@@ -16,8 +16,8 @@
 std::array<const int, 4> Bishop::mOffsets = {-9, -7, +7, +9};
 
 /* Clone method to allow the piece to be copied into a new memory location. Useful for creating a copy of Board */
-Piece * Bishop::clone(Board* newBoard) const {
-    Piece * copy = new Bishop(getColor(), getPosition(), newBoard);
+Piece * Bishop::clone(Board* newBoard, void * memory) const {
+    Piece * copy = new (memory) Bishop(getColor(), getPosition(), newBoard);
     copy->validMoves = validMoves;
     return copy;
 }
@@ -1,13 +1,13 @@
 /* Standard Libraries */
-#include <cctype>
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <cstdlib>
+#include <stdexcept>
 
 /* Include other defined headers */
 #include "Board.hpp"
-#include "Graphics.hpp"
-#include "Game.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
 
 /* Include each piece type*/
 #include "King.hpp"
@@ -33,6 +33,10 @@ Source:
 https://lichess.org/@/likeawizard/blog/review-of-different-board-representations-in-computer-chess/S9eQCAWa
 */
 
+/* ##### Board Dimensions ##### */
+const int ROW = 8;
+const int COL = 8;
+
 /* ##### Static Methods - Helper functions ##### */
 /* Converts row and column of a square in the board to an index */
 int Board::squareToIndex(int row, int col) {
@@ -63,10 +67,10 @@ int Board::algebraicToIndex(const std::string & notation) {
     else throw std::invalid_argument("Invalid file character in algebraic notation");
 
     char rank = notation[1];
-    if (file >= '1' && file <= '8') {
+    if (rank >= '1' && rank <= '8') {
         row = rank - '1';
     } 
-    else std::invalid_argument("Invalid rank character in algebraic notation");
+    else throw std::invalid_argument("Invalid rank character in algebraic notation");
 
     return Board::squareToIndex(row, col);
 }
@@ -85,7 +89,7 @@ std::string Board::indexToAlgebraic(int index) {
 }
 
 /* Constructor */
-Board::Board(ChessGame * game) : mGamePtr(game), mEnPassantIndex(-1) {
+Board::Board(ChessGame * game) : castlingOffset(0), moveCount(0), mGamePtr(game), mEnPassantIndex(-1), mTurn(Color::White), mHalfMoveClock(0), mFullMoveClock(1) {
     /* Set every pointer of board to NULL, ocupation board to 0 */
     for (int i = 0; i < ROW * COL; ++i) {
         board[i] = nullptr;
@@ -96,11 +100,12 @@ Board::Board(ChessGame * game) : mGamePtr(game), mEnPassantIndex(-1) {
     mBlackKing = nullptr;
 }
 
-/* Copy Constructor, which will copy every piece of the Board with new addresses, so move simulations can be performed */
-Board::Board(const Board & original) {
+/* Copy Constructor, which will copy every piece of the Board with new addresses, so move simulations can be performed. Each piece is copied into the same arena slot as in the original, so the copy only needs the pointers of the squares fixed */
+Board::Board(const Board & original) : mWhiteKing(nullptr), mBlackKing(nullptr) {
      // Deep copy pieces
      for (int i = 0; i < 64; ++i) {
-        board[i] = original.board[i] ? original.board[i]->clone(this) : nullptr;
+        const Piece * piece = original.board[i];
+        board[i] = piece ? piece->clone(this, mArena.allocate(original.mArena.getSlot(piece))) : nullptr;
         if (board[i] && board[i]->getType() == PieceType::King) {
             if (board[i]->getColor() == Color::White) mWhiteKing = static_cast<King *>(board[i]);
             else mBlackKing = static_cast<King *>(board[i]);
@@ -110,8 +115,13 @@ Board::Board(const Board & original) {
     whiteAttackBoard = original.whiteAttackBoard;
     blackAttackBoard = original.blackAttackBoard;
 
-    /* Copying enPassant */
+    /* Copying enPassant, turn and clocks */
     mEnPassantIndex = original.getEnPassantIndex();
+    mTurn = original.mTurn;
+    mHalfMoveClock = original.mHalfMoveClock;
+    mFullMoveClock = original.mFullMoveClock;
+    moveCount = original.moveCount;
+    castlingOffset = original.castlingOffset;
 
     /* Game Pointer is not necessary */
     mGamePtr = nullptr;
@@ -121,159 +131,247 @@ Board::~Board() {
     clearBoard();
 }
 
+/* The pieces in the arena are all destroyed by a single reset. Only those that did not fit (from an illegal position) are released one by one */
 void Board::clearBoard() {
     for (int i = 0; i < ROW * COL; ++i) {
-        delete board[i];
+        if (board[i] && mArena.getSlot(board[i]) < 0) mArena.release(board[i]);
         board[i] = nullptr;
         whiteAttackBoard[i] = 0;
         blackAttackBoard[i] = 0;    
     }
+    mArena.reset();
     mWhiteKing = nullptr;
     mBlackKing = nullptr;
     mEnPassantIndex = -1;
 }
 
-/* Dynamically allocates a piece according to the type, color and position */
+/* Creates a piece according to the type, color and position, in a slot of the arena of the board */
 Piece* Board::createPiece(PieceType type, Color color, int position) {
+    if (type == PieceType::Empty) return nullptr; // Implement error handling
+    void * memory = mArena.allocate();
     switch(type) {
-        case PieceType::King: return new King(color, position, this, false);
-        case PieceType::Queen: return new Queen(color, position, this);
-        case PieceType::Rook: return new Rook(color, position, this);
-        case PieceType::Bishop: return new Bishop(color, position, this);
-        case PieceType::Knight: return new Knight(color, position, this);
-        case PieceType::Pawn: return new Pawn(color, position, this, false);
-        default: return nullptr; // Implement error handling
+        case PieceType::King: return new (memory) King(color, position, this, false);
+        case PieceType::Queen: return new (memory) Queen(color, position, this);
+        case PieceType::Rook: return new (memory) Rook(color, position, this);
+        case PieceType::Bishop: return new (memory) Bishop(color, position, this);
+        case PieceType::Knight: return new (memory) Knight(color, position, this);
+        default: return new (memory) Pawn(color, position, this, false);
     }
 }
 
-/* Initializes a Chess Position by providing a VALID FEN String, which has the information of the pieces placement, turn, castling rights, en-passant target square, and other informations 
-More information: https://en.wikipedia.org/wiki/Forsyth–Edwards_Notation */
-bool Board::loadFromFEN(const std::string & fen) {
-    
-    clearBoard();
-    /* https://www.geeksforgeeks.org/how-to-split-string-by-delimiter-in-cpp/*/
-    std::istringstream fenStream(fen);
-    std::string piecePlacement, activeColor, castlingRights, enPassant, halfMoveClock, fullMoveClock;
+/* ##### FEN ##### */
+const char * fenErrorName(FENError error) {
+    switch (error) {
+        case FENError::None: return "no error";
+        case FENError::MissingFields: return "missing FEN fields";
+        case FENError::TooManyFields: return "unexpected characters after the FEN";
+        case FENError::InvalidPiece: return "invalid piece letter";
+        case FENError::InvalidRankLength: return "a rank does not have 8 squares";
+        case FENError::InvalidRankCount: return "the placement does not have 8 ranks";
+        case FENError::InvalidKingCount: return "each side must have exactly one King";
+        case FENError::PawnOnBackRank: return "pawn on the first or last rank";
+        case FENError::InvalidTurn: return "the side to move must be w or b";
+        case FENError::InvalidCastling: return "invalid castling rights";
+        case FENError::CastlingMismatch: return "castling rights without the King or Rook on its initial square";
+        case FENError::InvalidEnPassant: return "invalid en passant target square";
+        case FENError::InvalidClock: return "invalid move clock";
+        case FENError::OpponentInCheck: return "the side not to move is in check";
+    }
+    return "unknown error";
+}
 
-    /* Split FEN into main parts */
-    if (!(fenStream >> piecePlacement >> activeColor >> castlingRights >> enPassant >> halfMoveClock >> fullMoveClock)) {
-        throw std::invalid_argument("FEN string is incomplete or malformed");
+/* Non-negative decimal number, up to a limit that keeps the clocks far from overflowing */
+static bool parseClock(std::string_view text, int & value) {
+    if (text.empty() || text.size() > 6) return false;
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
     }
+    return true;
+}
 
-    int row = (ROW - 1); /* Starts from the 8th row/rank */
-    int col = 0; /* Starts from the 0th column/file */
-    int stringIndex;
-
-    /* Initialize pointers to the white and black kings */
-    mWhiteKing = nullptr;
-    mBlackKing = nullptr;
+static PieceType fenLetterToPiece(char letter) {
+    switch (letter) {
+        case 'p': return PieceType::Pawn;
+        case 'n': return PieceType::Knight;
+        case 'b': return PieceType::Bishop;
+        case 'r': return PieceType::Rook;
+        case 'q': return PieceType::Queen;
+        case 'k': return PieceType::King;
+        default: return PieceType::Empty;
+    }
+}
 
-    /* Create pieces according to the placement, from top to bottom, right to left, starting from the Top-Left corner */
-    for (char character : piecePlacement) {
-        
-        if(character == '/') { /* Change row */
+/* A position read from a FEN or a PackedBoard, before it is validated and placed on the board */
+struct Board::PositionSetup {
+    std::array<PieceType, 64> types;
+    std::array<Color, 64> colors;
+    Color turn = Color::White;
+    int castling = 0;
+    int enPassantIndex = -1;
+    int halfMoveClock = 0;
+    int fullMoveClock = 1;
+};
+
+/* Initializes a Chess Position from a FEN String, which has the information of the pieces placement, turn, castling rights, en-passant target square, and the move clocks (optional, as in EPD, defaulting to 0 and 1)
+More information: https://en.wikipedia.org/wiki/Forsyth–Edwards_Notation
+The whole string is validated before the board is changed, so an invalid FEN leaves the previous position, except OpponentInCheck, which is only known once the pieces are placed and leaves the board empty. The text is read in place, without streams or exceptions, as batch tools load millions of positions */
+FENError Board::parseFEN(std::string_view fen) {
+
+    /* Split FEN into main parts, separated by spaces */
+    std::string_view fields[6];
+    int fieldCount = 0;
+    std::size_t position = 0;
+    while (position < fen.size()) {
+        if (fen[position] == ' ' || fen[position] == '\t' || fen[position] == '\r' || fen[position] == '\n') {
+            ++position;
+            continue;
+        }
+        std::size_t start = position;
+        while (position < fen.size() && fen[position] != ' ' && fen[position] != '\t' && fen[position] != '\r' && fen[position] != '\n') ++position;
+        if (fieldCount == 6) return FENError::TooManyFields;
+        fields[fieldCount++] = fen.substr(start, position - start);
+    }
+    if (fieldCount < 4) return FENError::MissingFields;
+
+    PositionSetup setup;
+    setup.types.fill(PieceType::Empty);
+
+    /* 1. Piece placement, from the 8th rank down and from the a-file to the h-file */
+    int row = ROW - 1;
+    int col = 0;
+    for (char character : fields[0]) {
+        if (character == '/') {
+            if (col != COL) return FENError::InvalidRankLength;
+            if (--row < 0) return FENError::InvalidRankCount;
             col = 0;
-            row--;
         }
-        
-        else if (isdigit(character)) /* Skip columns */
-        {
-            if((character - '0') > 0 && (character - '0') < 9) {
-                int emptySquares = character - '0';
-                col += emptySquares;
-                if(col > (COL - 1)) col = COL - 1; /* Prevent overflow */
-            }
+        else if (character >= '1' && character <= '8') {
+            col += character - '0';
+            if (col > COL) return FENError::InvalidRankLength;
         }
-
-        else /* Create a piece */
-        {
-            Color color = (isupper(character)) ? Color::White : Color::Black;
-            PieceType type;
-            character = tolower(character);
-            switch(character) {    
-                case 'k': type = PieceType::King; break;
-                case 'q': type = PieceType::Queen; break;
-                case 'r': type = PieceType::Rook; break;
-                case 'n': type = PieceType::Knight; break;
-                case 'b': type = PieceType::Bishop; break;
-                case 'p': type = PieceType::Pawn; break;
-                default: return false; /* Invalid Piece */
-            }
-            stringIndex = squareToIndex(row, col);
-            board[stringIndex] = createPiece(type, color, stringIndex);
-            
-            /* Two square moving rights for pawns */
-            
-            if (type == PieceType::Pawn) {
-                int initialRow = (color == Color::White) ? 1 : 6;
-                Pawn * pawn = static_cast<Pawn *>(board[stringIndex]);
-                if (row == initialRow) {
-                    pawn->setHasMoved(false);
-                } else {
-                    pawn->setHasMoved(true);
-                }
-            }
-
-            if (type == PieceType::King && color == Color::White) mWhiteKing = static_cast<King *>(board[stringIndex]);
-            if (type == PieceType::King && color == Color::Black) mBlackKing = static_cast<King *>(board[stringIndex]);
+        else {
+            bool white = character >= 'A' && character <= 'Z';
+            PieceType type = fenLetterToPiece(white ? static_cast<char>(character - 'A' + 'a') : character);
+            if (type == PieceType::Empty) return FENError::InvalidPiece;
+            if (col >= COL) return FENError::InvalidRankLength;
+
+            int index = squareToIndex(row, col);
+            setup.types[index] = type;
+            setup.colors[index] = white ? Color::White : Color::Black;
             ++col;
-            if (col > (COL - 1)) col = COL;
         }
     }
+    if (row != 0) return FENError::InvalidRankCount;
+    if (col != COL) return FENError::InvalidRankLength;
 
-    /* Store turn information into game */
-    Color playerTurn = (activeColor == "w") ? Color::White :
-    (activeColor == "b") ? Color::Black : Color::White;
-    mGamePtr->setTurn(playerTurn);
+    /* 2. Side to move */
+    if (fields[1] != "w" && fields[1] != "b") return FENError::InvalidTurn;
+    setup.turn = (fields[1] == "w") ? Color::White : Color::Black;
 
-    if (!mWhiteKing || !mBlackKing) {
-        throw std::invalid_argument("There is no one or both of Kings on the Board!");
-    }
-    
-    /* Castling Rights of white and black kings */
-    if (mWhiteKing && mBlackKing) {
-        if (castlingRights.find('K') != std::string::npos) {
-            static_cast<King *>(mWhiteKing)->setKingSideCastleRight(true);
-            if(board[7] != nullptr) board[7]->setHasMoved(false);
-        }
-        if(castlingRights.find('Q') != std::string::npos) {
-            static_cast<King *>(mWhiteKing)->setQueenSideCastleRight(true);
-            if(board[0] != nullptr) board[0]->setHasMoved(false);
+    /* 3. Castling rights: KQkq in any order, or - */
+    if (fields[2] != "-") {
+        for (char character : fields[2]) {
+            int right = character == 'K' ? CASTLE_WHITE_KING_SIDE : character == 'Q' ? CASTLE_WHITE_QUEEN_SIDE :
+                        character == 'k' ? CASTLE_BLACK_KING_SIDE : character == 'q' ? CASTLE_BLACK_QUEEN_SIDE : 0;
+            if (!right || (setup.castling & right)) return FENError::InvalidCastling;
+            setup.castling |= right;
         }
-        if(castlingRights.find('k') != std::string::npos) {
-            static_cast<King *>(mBlackKing)->setKingSideCastleRight(true);
-            if(board[63] != nullptr) board[63]->setHasMoved(false);
-        }
-        if(castlingRights.find('q') != std::string::npos) {
-            static_cast<King *>(mBlackKing)->setQueenSideCastleRight(true);
-            if(board[56] != nullptr) board[56]->setHasMoved(false);
-        }
-    } else return false;
+    }
 
-    /* enPassant target square */
-    if (enPassant == "-") {
-        mEnPassantIndex = -1;
-    } else {
-        try {
-            mEnPassantIndex = Board::algebraicToIndex(enPassant);
-        } catch (std::invalid_argument) {
-            std::cerr << "Invalid en-passant target square. Using default value instead" << std::endl;
-            mEnPassantIndex = -1;
+    /* 4. En passant target square */
+    if (fields[3] != "-") {
+        std::string_view square = fields[3];
+        if (square.size() != 2 || square[0] < 'a' || square[0] > 'h' || square[1] < '1' || square[1] > '8') return FENError::InvalidEnPassant;
+        setup.enPassantIndex = squareToIndex(square[1] - '1', square[0] - 'a');
+    }
+
+    /* 5. Half and full move clocks. A full move number of 0, written by some programs, is read as 1 */
+    if (fieldCount > 4 && !parseClock(fields[4], setup.halfMoveClock)) return FENError::InvalidClock;
+    if (fieldCount > 5 && !parseClock(fields[5], setup.fullMoveClock)) return FENError::InvalidClock;
+    if (setup.fullMoveClock < 1) setup.fullMoveClock = 1;
+
+    return setupPosition(setup);
+}
+
+/* Checks the rules that a position must follow, then places it on the board */
+FENError Board::setupPosition(const PositionSetup & setup) {
+    const std::array<PieceType, 64> & types = setup.types;
+    const std::array<Color, 64> & colors = setup.colors;
+
+    /* Exactly one King per side, and no pawns on the first or last rank */
+    int kings[2] = {-1, -1};
+    for (int i = 0; i < 64; ++i) {
+        if (types[i] == PieceType::Pawn && (indexToRow(i) == 0 || indexToRow(i) == ROW - 1)) return FENError::PawnOnBackRank;
+        if (types[i] != PieceType::King) continue;
+        int & king = kings[colors[i] == Color::White ? 0 : 1];
+        if (king >= 0) return FENError::InvalidKingCount;
+        king = i;
+    }
+    if (kings[0] < 0 || kings[1] < 0) return FENError::InvalidKingCount;
+
+    /* Each castling right needs its King and Rook on their initial squares */
+    int castling = setup.castling;
+    auto hasRook = [&](int index, Color color) { return types[index] == PieceType::Rook && colors[index] == color; };
+    if ((castling & (CASTLE_WHITE_KING_SIDE | CASTLE_WHITE_QUEEN_SIDE)) && kings[0] != 4) return FENError::CastlingMismatch;
+    if ((castling & (CASTLE_BLACK_KING_SIDE | CASTLE_BLACK_QUEEN_SIDE)) && kings[1] != 60) return FENError::CastlingMismatch;
+    if ((castling & CASTLE_WHITE_KING_SIDE) && !hasRook(7, Color::White)) return FENError::CastlingMismatch;
+    if ((castling & CASTLE_WHITE_QUEEN_SIDE) && !hasRook(0, Color::White)) return FENError::CastlingMismatch;
+    if ((castling & CASTLE_BLACK_KING_SIDE) && !hasRook(63, Color::Black)) return FENError::CastlingMismatch;
+    if ((castling & CASTLE_BLACK_QUEEN_SIDE) && !hasRook(56, Color::Black)) return FENError::CastlingMismatch;
+
+    /* The en passant target is behind a pawn that has just moved two squares: on the 6th rank if White is to move, 3rd otherwise */
+    int enPassantIndex = setup.enPassantIndex;
+    if (enPassantIndex >= 0) {
+        Color turn = setup.turn;
+        if (indexToRow(enPassantIndex) != ((turn == Color::White) ? 5 : 2)) return FENError::InvalidEnPassant;
+        int pawnIndex = enPassantIndex + ((turn == Color::White) ? -COL : COL);
+        int originIndex = enPassantIndex + ((turn == Color::White) ? COL : -COL);
+        Color pawnColor = (turn == Color::White) ? Color::Black : Color::White;
+        if (types[enPassantIndex] != PieceType::Empty || types[originIndex] != PieceType::Empty) return FENError::InvalidEnPassant;
+        if (types[pawnIndex] != PieceType::Pawn || colors[pawnIndex] != pawnColor) return FENError::InvalidEnPassant;
+    }
+
+    /* The position is valid: build it */
+    Color playerTurn = setup.turn;
+    clearBoard();
+    for (int i = 0; i < 64; ++i) {
+        if (types[i] == PieceType::Empty) continue;
+        board[i] = createPiece(types[i], colors[i], i);
+
+        /* Two square moving rights for pawns */
+        if (types[i] == PieceType::Pawn) {
+            int initialRow = (colors[i] == Color::White) ? 1 : 6;
+            board[i]->setHasMoved(indexToRow(i) != initialRow);
         }
     }
+    mWhiteKing = static_cast<King *>(board[kings[0]]);
+    mBlackKing = static_cast<King *>(board[kings[1]]);
+    mTurn = playerTurn;
 
-    /* Set Half Move Clock */
-    if (std::stoi(halfMoveClock) >= 0) {
-        mGamePtr->setHalfMoveClock(std::stoi(halfMoveClock));
-    } else {
-        
+    /* Castling Rights of white and black kings */
+    if (castling & CASTLE_WHITE_KING_SIDE) {
+        mWhiteKing->setKingSideCastleRight(true);
+        board[7]->setHasMoved(false);
     }
-    
-    /* Set Full Move Clock */
-    if (std::stoi(fullMoveClock) >= 1) {
-        mGamePtr->setFullMoveClock(std::stoi(fullMoveClock));
+    if (castling & CASTLE_WHITE_QUEEN_SIDE) {
+        mWhiteKing->setQueenSideCastleRight(true);
+        board[0]->setHasMoved(false);
     }
-    
+    if (castling & CASTLE_BLACK_KING_SIDE) {
+        mBlackKing->setKingSideCastleRight(true);
+        board[63]->setHasMoved(false);
+    }
+    if (castling & CASTLE_BLACK_QUEEN_SIDE) {
+        mBlackKing->setQueenSideCastleRight(true);
+        board[56]->setHasMoved(false);
+    }
+
+    mEnPassantIndex = enPassantIndex;
+    mHalfMoveClock = setup.halfMoveClock;
+    mFullMoveClock = setup.fullMoveClock;
+
     /* 1. Compute all non-king moves first */
     for (int i = 0; i < 64; ++i) {
         if (board[i] && board[i]->getType() != PieceType::King) {
@@ -285,23 +383,170 @@ bool Board::loadFromFEN(const std::string & fen) {
     computeAttackBoards();
 
     /* 3. Compute king moves using updated attack boards */
-    if (mWhiteKing) mWhiteKing->computeMoves();
-    if (mBlackKing) mBlackKing->computeMoves();
+    mWhiteKing->computeMoves();
+    mBlackKing->computeMoves();
 
     /* 4. Final attack board update including kings */
     computeAttackBoards();
 
+    /* The King of the side that has just moved cannot be left in check */
+    if (isKingInCheck(playerTurn == Color::White ? Color::Black : Color::White)) {
+        clearBoard();
+        return FENError::OpponentInCheck;
+    }
+
     /* 5. Validate all valid moves after loading a position */
     validateAllNextPlayerMoves(playerTurn);
     countMoves(playerTurn);
 
     /* Check detection */
     mWhiteKing->setCheck(isKingInCheck(Color::White));
-    mBlackKing->setCheck(isKingInCheck(Color::Black));   
+    mBlackKing->setCheck(isKingInCheck(Color::Black));
+
+    return FENError::None;
+}
+
+/* Loads a FEN, throwing std::invalid_argument with the reason if it is not valid. Kept for the GUI and the callers that report errors with exceptions */
+bool Board::loadFromFEN(const std::string & fen) {
+    FENError error = parseFEN(fen);
+    if (error != FENError::None) {
+        throw std::invalid_argument(std::string("Invalid FEN: ") + fenErrorName(error));
+    }
+    return true;
+}
+
+/* Writes a non-negative number, returning the position after it */
+static char * writeNumber(char * output, int value) {
+    char digits[12];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) *output++ = digits[--count];
+    return output;
+}
+
+std::size_t Board::toFEN(char * buffer, std::size_t size) const {
+    static const char letters[] = " pnbrqk";
+    char text[FEN_BUFFER_SIZE];
+    char * output = text;
+
+    for (int row = ROW - 1; row >= 0; --row) {
+        int empty = 0;
+        for (int col = 0; col < COL; ++col) {
+            const Piece * piece = board[squareToIndex(row, col)];
+            if (!piece) {
+                ++empty;
+                continue;
+            }
+            if (empty) *output++ = static_cast<char>('0' + empty);
+            empty = 0;
+            char letter = letters[static_cast<int>(piece->getType())];
+            *output++ = (piece->getColor() == Color::White) ? static_cast<char>(letter - 'a' + 'A') : letter;
+        }
+        if (empty) *output++ = static_cast<char>('0' + empty);
+        if (row) *output++ = '/';
+    }
+
+    *output++ = ' ';
+    *output++ = (mTurn == Color::White) ? 'w' : 'b';
+    *output++ = ' ';
+
+    int rights = getCastlingRights();
+    if (!rights) *output++ = '-';
+    if (rights & CASTLE_WHITE_KING_SIDE) *output++ = 'K';
+    if (rights & CASTLE_WHITE_QUEEN_SIDE) *output++ = 'Q';
+    if (rights & CASTLE_BLACK_KING_SIDE) *output++ = 'k';
+    if (rights & CASTLE_BLACK_QUEEN_SIDE) *output++ = 'q';
+    *output++ = ' ';
+
+    if (isValidIndex(mEnPassantIndex)) {
+        *output++ = static_cast<char>('a' + indexToColumn(mEnPassantIndex));
+        *output++ = static_cast<char>('1' + indexToRow(mEnPassantIndex));
+    }
+    else *output++ = '-';
+
+    *output++ = ' ';
+    output = writeNumber(output, std::clamp(mHalfMoveClock, 0, 999999));
+    *output++ = ' ';
+    output = writeNumber(output, std::clamp(mFullMoveClock, 1, 999999));
+
+    std::size_t length = output - text;
+    if (length + 1 > size) return 0;
+    std::memcpy(buffer, text, length);
+    buffer[length] = '\0';
+    return length;
+}
 
+std::string Board::toFEN() const {
+    char buffer[FEN_BUFFER_SIZE];
+    std::size_t length = toFEN(buffer, sizeof(buffer));
+    return std::string(buffer, length);
+}
+
+/* ##### Packed Position ##### */
+bool Board::pack(PackedBoard & packed) const {
+    std::memset(&packed, 0, sizeof(packed));
+
+    int count = 0;
+    for (int i = 0; i < 64; ++i) {
+        const Piece * piece = board[i];
+        if (!piece) continue;
+        if (count == 32) return false;
+
+        int code = static_cast<int>(piece->getType()) + (piece->getColor() == Color::Black ? 8 : 0);
+        packed.occupancy |= std::uint64_t(1) << i;
+        packed.pieces[count / 2] |= static_cast<std::uint8_t>(code << (4 * (count % 2)));
+        ++count;
+    }
+
+    packed.flags = static_cast<std::uint8_t>((mTurn == Color::Black ? 1 : 0) | (getCastlingRights() << 1));
+
+    /* As in the Zobrist key, the en passant file only counts if a pawn of the side to move stands next to the pawn that has just moved twice, so that transpositions pack the same */
+    int pushed = (mTurn == Color::White) ? mEnPassantIndex - COL : mEnPassantIndex + COL;
+    if (isValidIndex(mEnPassantIndex) && isValidIndex(pushed)) {
+        int file = indexToColumn(mEnPassantIndex);
+        for (int side : {-1, +1}) {
+            if (file + side < 0 || file + side >= COL) continue;
+            const Piece * pawn = board[pushed + side];
+            if (pawn && pawn->getType() == PieceType::Pawn && pawn->getColor() == mTurn) {
+                packed.enPassantFile = static_cast<std::uint8_t>(file + 1);
+                break;
+            }
+        }
+    }
     return true;
 }
 
+/* Places a packed position, with the same validation as parseFEN. The clocks are not packed, so they are reset to 0 and 1 */
+FENError Board::unpack(const PackedBoard & packed) {
+    PositionSetup setup;
+    setup.types.fill(PieceType::Empty);
+
+    int count = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (!((packed.occupancy >> i) & 1)) continue;
+        if (count == 32) return FENError::InvalidPiece;
+
+        int code = (packed.pieces[count / 2] >> (4 * (count % 2))) & 0xF;
+        int type = code & 7;
+        if (type < static_cast<int>(PieceType::Pawn) || type > static_cast<int>(PieceType::King)) return FENError::InvalidPiece;
+        setup.types[i] = static_cast<PieceType>(type);
+        setup.colors[i] = (code & 8) ? Color::Black : Color::White;
+        ++count;
+    }
+
+    if (packed.flags >> 5) return FENError::InvalidCastling;
+    setup.turn = (packed.flags & 1) ? Color::Black : Color::White;
+    setup.castling = packed.flags >> 1;
+
+    if (packed.enPassantFile > COL) return FENError::InvalidEnPassant;
+    if (packed.enPassantFile) setup.enPassantIndex = squareToIndex((setup.turn == Color::White) ? 5 : 2, packed.enPassantFile - 1);
+
+    return setupPosition(setup);
+}
+
 /* Check if the given index is within the defined boundaries */
 bool Board::isValidIndex(int index) {
     return index >= 0 && index < 64;
@@ -332,14 +577,21 @@ void Board::computeAttackBoards() {
     for (int i = 0; i < 64; ++i) {
         if (board[i] && board[i]->getType() != PieceType::King) {
             board[i]->computeMoves();
-            for (int target : board[i]->validMoves) {
-                if (board[i]->getColor() == Color::White) {
-                    whiteAttackBoard[target] = 1;
-                    if (board[i]->getType() == PieceType::Pawn && (indexToColumn(board[i]->getPosition()) - indexToColumn(target)) == 0) whiteAttackBoard[target] = 0;
-                } else {
-                    blackAttackBoard[target] = 1;
-                    if (board[i]->getType() == PieceType::Pawn && (indexToColumn(board[i]->getPosition()) - indexToColumn(target)) == 0) blackAttackBoard[target] = 0; 
+            std::array<int, 64> & attackBoard = (board[i]->getColor() == Color::White) ? whiteAttackBoard : blackAttackBoard;
+
+            /* Pawns attack both diagonals, even when there is nothing to capture, which matters for the King moves and castling */
+            if (board[i]->getType() == PieceType::Pawn) {
+                int forwardRow = indexToRow(i) + ((board[i]->getColor() == Color::White) ? 1 : -1);
+                int col = indexToColumn(i);
+                if (forwardRow >= 0 && forwardRow < ROW) {
+                    if (col > 0) attackBoard[squareToIndex(forwardRow, col - 1)] = 1;
+                    if (col < COL - 1) attackBoard[squareToIndex(forwardRow, col + 1)] = 1;
                 }
+                continue;
+            }
+
+            for (int target : board[i]->validMoves) {
+                attackBoard[target] = 1;
             }
         }
     }
@@ -380,25 +632,13 @@ void Board::validateMovesForPiece(int index) {
     Piece * piece = board[index];
     if (!piece) return;
 
-    // Get all pseudolegal moves first
-    std::vector<int> pseudoLegalMoves;
-    //piece->computeMoves();  // Generates pseudolegal moves
-    pseudoLegalMoves = piece->validMoves;
-    std::vector<int> legalMoves;
-    
-    /* Validate each move by calling validateMove method */
-    for (int targetIndex : pseudoLegalMoves) {
-        if(validateMove(index, targetIndex)) {
-            legalMoves.push_back(targetIndex);
-        }
-    }
-    
-    /* Copy all the legalMoves to the piece validMoves vector */
-    piece->validMoves = legalMoves;
+    /* Keeps the pseudolegal moves that validateMove accepts. It only plays them on a copy of the board, so the moves can be filtered in place */
+    piece->validMoves.filter([this, index](int targetIndex) { return validateMove(index, targetIndex); });
 }
 
 /* Method responsible for VALIDATING a move, which means it considers if the move is performed, would it lead the King (of same color) be in check. If yes, then the move is illegal, if not, the move is legal. This allows for the existance of pinned pieces, double checks, forks, and checkmate/stalemate detection (when there are no legal moves remaining) */
 bool Board::validateMove(int fromIndex, int toIndex) {
+    engineMetrics().legalityChecks.add();
 
     /* Checks if the indexes are within the bounds */
     if (!isValidIndex(fromIndex) || !isValidIndex(toIndex))
@@ -429,12 +669,12 @@ bool Board::validateMove(int fromIndex, int toIndex) {
 
     /* Delete a piece if it is not a King or not empty */
     if (targetPiece && targetPiece->getType() != PieceType::King) {
-        delete targetPiece;
+        tempBoard.mArena.release(targetPiece);
     }
 
     if (enPassantCapture) {
         int capturedPawnIndex = (movingPiece->getColor() == Color::White) ? toIndex - 8 : toIndex + 8;
-        delete tempBoard.board[capturedPawnIndex];          // Delete the pawn
+        tempBoard.mArena.release(tempBoard.board[capturedPawnIndex]);          // Delete the pawn
         tempBoard.board[capturedPawnIndex] = nullptr;       // Clear the pointer
     }
 
@@ -467,6 +707,7 @@ bool Board::validateMove(int fromIndex, int toIndex) {
 }
 
 void Board::validateAllNextPlayerMoves(Color turn) {
+    TRACE_ZONE("board", "validateAllNextPlayerMoves");
 
     // Validate all pieces of the next player
     for (int i = 0; i < 64; i++) {
@@ -477,8 +718,9 @@ void Board::validateAllNextPlayerMoves(Color turn) {
     
 }
 
-bool Board::movePiece(int fromIndex, int toIndex) {
-    
+bool Board::movePiece(int fromIndex, int toIndex, PieceType promotion) {
+    TRACE_ZONE("board", "movePiece");
+
     /* Checks if the indexes are within the bounds */
     if (!isValidIndex(fromIndex) || !isValidIndex(toIndex))
         return false;
@@ -493,11 +735,10 @@ bool Board::movePiece(int fromIndex, int toIndex) {
         normalMove = true; /* Because it moves normally */
     }
 
+    /* A King moving two squares can only be castling, as computeCastling is the only place generating it */
     bool castlingMove = false;
     if (movingPiece->getType() == PieceType::King && std::abs(toIndex - fromIndex) == 2) {
-        if (movingPiece->getColor() == Color::White) castlingMove = mWhiteKing->hasCastleRights() && mWhiteKing->isChecked();
-        else {castlingMove = mBlackKing->hasCastleRights() && mBlackKing->isChecked();}
-        
+        castlingMove = !movingPiece->getHasMoved();
         if (castlingMove) normalMove = false;
     }
 
@@ -514,12 +755,12 @@ bool Board::movePiece(int fromIndex, int toIndex) {
 
     /* Delete a piece if it is not a King or not empty */
     if (targetPiece && targetPiece->getType() != PieceType::King) {
-        delete targetPiece;
+        mArena.release(targetPiece);
     }
 
     if (enPassantCapture) {
         int capturedPawnIndex = (movingPiece->getColor() == Color::White) ? toIndex - 8 : toIndex + 8;
-        delete board[capturedPawnIndex];          // Delete the pawn
+        mArena.release(board[capturedPawnIndex]);          // Delete the pawn
         board[capturedPawnIndex] = nullptr;       // Clear the pointer
     }
 
@@ -532,8 +773,11 @@ bool Board::movePiece(int fromIndex, int toIndex) {
 
     if(pawnPromotion) {
         Color color = movingPiece->getColor();
-        delete board[toIndex];
-        board[toIndex] = createPiece(PieceType::Queen, color, toIndex);
+        if (promotion != PieceType::Knight && promotion != PieceType::Bishop && promotion != PieceType::Rook)
+            promotion = PieceType::Queen;
+        mArena.release(board[toIndex]);
+        board[toIndex] = createPiece(promotion, color, toIndex);
+        movingPiece = board[toIndex];
     }
     
     if(castlingMove) {
@@ -603,7 +847,8 @@ bool Board::movePiece(int fromIndex, int toIndex) {
     /* Now safely update check status */
     mWhiteKing->setCheck(whiteInCheck);
     mBlackKing->setCheck(blackInCheck);
-    
+
+    engineMetrics().positionsGenerated.add();
     return true;
 
 }
@@ -633,6 +878,7 @@ bool Board::isKingInCheck(Color color) {
 
 /* Check if there are any legal moves to the pieces of a Color. It is used to detect checkmate or stalemate */
 bool Board::existLegalMoves(Color color) {
+    TRACE_ZONE("board", "existLegalMoves");
     King * king = (color == Color::White) ? mWhiteKing : mBlackKing;
     /* Check for valid king moves*/
     validateMovesForPiece(king->getPosition());
@@ -651,4 +897,65 @@ bool Board::existLegalMoves(Color color) {
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+/* Plays a move of the side to move on the board. Besides moving the piece, it keeps the half and full move clocks, switches the turn and validates the moves of the next player, so the board is ready for the next move */
+bool Board::playMove(const Move & move) {
+    if (!isValidIndex(move.from) || !isValidIndex(move.to)) return false;
+    Piece * movingPiece = board[move.from];
+    if (!movingPiece || movingPiece->getColor() != mTurn) return false;
+
+    /* Reset the half move clock on pawn moves and captures */
+    bool resetClock = movingPiece->getType() == PieceType::Pawn || board[move.to] != nullptr;
+
+    if (!movePiece(move.from, move.to, move.promotion)) return false;
+
+    mHalfMoveClock = resetClock ? 0 : mHalfMoveClock + 1;
+    if (mTurn == Color::Black) ++mFullMoveClock;
+
+    mTurn = (mTurn == Color::White) ? Color::Black : Color::White;
+    validateAllNextPlayerMoves(mTurn);
+    countMoves(mTurn);
+
+    return true;
+}
+
+/* The rights stored in the King are only cleared when it computes its moves, so the Rooks are checked too */
+int Board::getCastlingRights() const {
+    int rights = 0;
+    for (Color color : {Color::White, Color::Black}) {
+        const King * king = getKing(color);
+        int home = (color == Color::White) ? 0 : 56;
+        if (!king || king->getHasMoved() || king->getPosition() != home + 4) continue;
+
+        const Piece * kingRook = board[home + 7];
+        const Piece * queenRook = board[home];
+        if (king->hasKingSideCastleRight() && kingRook && kingRook->getType() == PieceType::Rook && kingRook->getColor() == color && !kingRook->getHasMoved())
+            rights |= (color == Color::White) ? CASTLE_WHITE_KING_SIDE : CASTLE_BLACK_KING_SIDE;
+        if (king->hasQueenSideCastleRight() && queenRook && queenRook->getType() == PieceType::Rook && queenRook->getColor() == color && !queenRook->getHasMoved())
+            rights |= (color == Color::White) ? CASTLE_WHITE_QUEEN_SIDE : CASTLE_BLACK_QUEEN_SIDE;
+    }
+    return rights;
+}
+
+/* Collects the legal moves of the side to move. A pawn reaching the last rank expands into the four possible promotions */
+void Board::generateLegalMoves(std::vector<Move> & moves) const {
+    static const std::array<PieceType, 4> promotions = {PieceType::Queen, PieceType::Rook, PieceType::Bishop, PieceType::Knight};
+    moves.clear();
+
+    for (int i = 0; i < 64; ++i) {
+        const Piece * piece = board[i];
+        if (!piece || piece->getColor() != mTurn) continue;
+
+        bool isPawn = piece->getType() == PieceType::Pawn;
+        for (int target : piece->validMoves) {
+            int row = indexToRow(target);
+            if (isPawn && (row == 0 || row == ROW - 1)) {
+                for (PieceType promotion : promotions)
+                    moves.push_back({i, target, promotion});
+            } else {
+                moves.push_back({i, target, PieceType::Empty});
+            }
+        }
+    }
+}
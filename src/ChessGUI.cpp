@@ -3,22 +3,28 @@
 #include "Board.hpp"
 #include "Game.hpp"
 #include "Graphics.hpp"
+#include "Notation.hpp"
+#include "Trace.hpp"
+#include "Zobrist.hpp"
 #include "imgui.h"
 #include "imgui_impl_sdl2.h"
 #include "imgui_impl_sdlrenderer2.h"
 
 
+#include <cstdio>
+#include <iostream>
 #include <stdexcept>
 
 
 /* Constructor of Class Members */
-ChessGUI::ChessGUI(SDL_Window * window, SDL_Renderer * renderer, ChessGame * game) : mWindow(window), mRenderer(renderer), mGame(game) {
+ChessGUI::ChessGUI(SDL_Window * window, SDL_Renderer * renderer, ChessGame * game) : mWindow(window), mRenderer(renderer), mGame(game), mBookKey(0), mHistoryMoves(0), mHistoryResets(0), mHistoryScroll(false), mLastDrawCalls(0), mGuiDrawCommands(0), mGuiVertices(0), mAnalysisKey(0), mAnalysisRunning(false), mEngineDepth(0), mEngineScore(0), mEngineHashFull(0), mEngineNodes(0), mEngineNPS(0) {
     showDemoWindow = false;
     showGameOver = false;
 }
 
 /* Destructor and Clean-Up */
 ChessGUI::~ChessGUI() {
+    stopAnalysis();
     ImGui_ImplSDLRenderer2_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -56,7 +62,8 @@ void ChessGUI::init() {
 
 /* Render */
 void ChessGUI::render() {
-    
+    TRACE_ZONE("gui", "render");
+
     /* Start the Dear ImGui frame */
     ImGui_ImplSDLRenderer2_NewFrame();
     ImGui_ImplSDL2_NewFrame();
@@ -65,6 +72,10 @@ void ChessGUI::render() {
     ImGui::SetNextWindowPos(ImVec2(BORDER_SIZE - 5, BORDER_SIZE - 5), ImGuiCond_FirstUseEver);
     ImGui::NewFrame();
 
+    /* The analysis follows the position on the board */
+    if (mAnalysisThread.joinable() && computeZobristKey(mGame->getBoard()) != mAnalysisKey)
+        startAnalysis();
+
     {
         /* Begin Window */
         ImGui::Begin("CPPChess GUI");
@@ -73,7 +84,7 @@ void ChessGUI::render() {
         if (showDemoWindow)
             ImGui::ShowDemoWindow(&showDemoWindow);
 
-        if(mGame->getState() == GameState::GameOver)
+        if(mGame->isGameOverMenuReady())
             gameOverMenu();
 
         /* Info Section */
@@ -220,16 +231,33 @@ void ChessGUI::render() {
                 ImGui::SetNextWindowSizeConstraints(ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 1), ImVec2(FLT_MAX, ImGui::GetTextLineHeightWithSpacing() * max_height_in_lines));
                 
                 if (ImGui::BeginChild("ConstrainedChild", ImVec2(-FLT_MIN, 0.0f), ImGuiChildFlags_Borders | ImGuiChildFlags_AutoResizeY)) {
-                    std::string moveList;
-                    for (const std::string & move : mGame->moveList) {
-                        moveList += move + " ";
+                    updateMoveHistory();
+                    bool atBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY(); /* As of the last frame */
+
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(mHistoryRows.size()));
+                    while (clipper.Step()) {
+                        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                            ImGui::TextUnformatted(mHistoryRows[row].c_str());
                     }
-                    ImGui::TextWrapped("%s", moveList.c_str());
+
+                    /* Follow the new moves, unless the user scrolled up */
+                    if (mHistoryScroll && atBottom)
+                        ImGui::SetScrollHereY(1.0f);
+                    mHistoryScroll = false;
                 }
                 ImGui::EndChild();
             }    
         }
 
+        /* Frame times, draw calls and engine statistics */
+        if (ImGui::CollapsingHeader("Performance"))
+            performanceMenu();
+
+        /* Opening book moves of the current position */
+        if (ImGui::CollapsingHeader("Opening Book"))
+            bookMenu();
+
         /* Debugger */
         if (ImGui::CollapsingHeader("Debugger")) {
             
@@ -244,6 +272,19 @@ void ChessGUI::render() {
 
                 ImGui::TreePop();
             }
+            /* Timeline of the zones recorded so far, for chrome://tracing or Perfetto */
+            if (ImGui::TreeNode("Tracing")) {
+                if (isTraceEnabled()) {
+                    ImGui::Text("Zones: %llu recorded, %llu dropped", static_cast<unsigned long long>(getTraceEventCount()), static_cast<unsigned long long>(getTraceDroppedCount()));
+                    if (ImGui::Button("Write Trace")) {
+                        if (writeTrace("./cppchess-trace.json")) std::cerr << "Trace written to ./cppchess-trace.json" << std::endl;
+                        else std::cerr << "Unable to write ./cppchess-trace.json" << std::endl;
+                    }
+                } else {
+                    ImGui::TextDisabled("Built without CPPCHESS_TRACE");
+                }
+                ImGui::TreePop();
+            }
             if (ImGui::TreeNode("Attacking Squares")) {
                 ImGui::Checkbox("White Attacks", &mGame->graphics.whiteAttack);
                 ImGui::Checkbox("Black Attacks", &mGame->graphics.blackAttack);
@@ -263,7 +304,204 @@ void ChessGUI::render() {
 
     /* Submit for Rendering, which will be updated in the main */
     ImGui::Render();
-    ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), mRenderer);
+    ImDrawData * drawData = ImGui::GetDrawData();
+    ImGui_ImplSDLRenderer2_RenderDrawData(drawData, mRenderer);
+
+    /* Size of the GUI, for the performance section of the next frame */
+    mGuiDrawCommands = 0;
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+        mGuiDrawCommands += drawData->CmdLists[i]->CmdBuffer.Size;
+    mGuiVertices = drawData->TotalVtxCount;
+}
+
+/* Records the frame measured by the main loop, with the draw calls of the board made since the last one */
+void ChessGUI::recordFrame(const FrameTiming & timing, float seconds) {
+    unsigned long drawCalls = mGame->graphics.getDrawCalls();
+    mFrameStats.record(timing, seconds * 1000.0f, drawCalls - mLastDrawCalls);
+    mLastDrawCalls = drawCalls;
+}
+
+/* Frame time history, the time of each stage of the last frame and on average, the draw calls, the texture memory and the engine statistics */
+void ChessGUI::performanceMenu() {
+    if (!mFrameStats.frameTimes.empty()) {
+        /* Frame Times */
+        const FrameTiming & last = mFrameStats.timings.back();
+        char overlay[64];
+        std::snprintf(overlay, sizeof(overlay), "%.2f ms (worst %.2f ms)", last.total(), mFrameStats.worstFrameTime());
+        ImGui::PlotLines("Frame Time", mFrameStats.frameTimes.data(), static_cast<int>(mFrameStats.frameTimes.size()), mFrameStats.frameTimes.getOffset(), overlay, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+        ImGui::Text("Frame Interval: %.2f ms", mFrameStats.intervals.back());
+
+        /* Stages of the frame */
+        FrameTiming mean = mFrameStats.average();
+        const char * stages[] = {"Events", "Update", "Render", "GUI", "Present"};
+        const float lastTimes[] = {last.events, last.update, last.render, last.gui, last.present};
+        const float meanTimes[] = {mean.events, mean.update, mean.render, mean.gui, mean.present};
+        if (ImGui::BeginTable("Frame Stages", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+            ImGui::TableSetupColumn("Stage");
+            ImGui::TableSetupColumn("Last (ms)");
+            ImGui::TableSetupColumn("Mean (ms)");
+            ImGui::TableHeadersRow();
+            for (int i = 0; i < IM_ARRAYSIZE(stages); ++i) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(stages[i]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", lastTimes[i]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", meanTimes[i]);
+            }
+            ImGui::EndTable();
+        }
+
+        /* Draw Calls and Memory */
+        ImGui::Text("Draw Calls: %.0f board, %d GUI (%d vertices)", mFrameStats.drawCalls.back(), mGuiDrawCommands, mGuiVertices);
+        ImGui::Text("Texture Memory: %.1f KB", mGame->graphics.getTextureMemory() / 1024.0);
+    }
+
+    /* Engine */
+    ImGui::SeparatorText("Engine");
+    bool analyzing = mAnalysisThread.joinable();
+    if (ImGui::Checkbox("Analyze Position", &analyzing)) {
+        if (analyzing) startAnalysis();
+        else stopAnalysis();
+    }
+
+    if (mAnalysisThread.joinable()) {
+        ImGui::Text("Depth: %d", mEngineDepth.load());
+        ImGui::Text("Score: %+d cp", mEngineScore.load());
+        ImGui::Text("Nodes: %llu", static_cast<unsigned long long>(mEngineNodes.load()));
+        ImGui::Text("NPS: %llu", static_cast<unsigned long long>(mEngineNPS.load()));
+        ImGui::Text("Hash Full: %.1f%%", mEngineHashFull.load() / 10.0);
+        if (!mAnalysisRunning)
+            ImGui::TextDisabled("Search finished");
+    } else {
+        ImGui::TextDisabled("No search running");
+    }
+}
+
+/* Searches the current position without limits, on a copy of the board, until it is stopped or the position changes. The statistics are published after every iteration */
+void ChessGUI::startAnalysis() {
+    stopAnalysis();
+    if (!mAnalysis)
+        mAnalysis = std::make_unique<Search>();
+
+    const Board & board = mGame->getBoard();
+    mAnalysisKey = computeZobristKey(board);
+    mEngineDepth = 0;
+    mEngineScore = 0;
+    mEngineHashFull = 0;
+    mEngineNodes = 0;
+    mEngineNPS = 0;
+
+    mAnalysis->setInfoCallback([this](const SearchResult & result, const SearchStats & stats) {
+        mEngineDepth = stats.depth;
+        mEngineScore = result.score;
+        mEngineNodes = stats.nodes;
+        mEngineNPS = stats.seconds > 0.0 ? static_cast<std::uint64_t>(stats.nodes / stats.seconds) : 0;
+        mEngineHashFull = mAnalysis->getHashFull();
+    });
+
+    mAnalysisRunning = true;
+    mAnalysisThread = std::thread([this, board] {
+        setTraceThreadName("analysis");
+        SearchLimits limits;
+        limits.useBook = false;
+        limits.useTablebase = false;
+        mAnalysis->think(board, limits);
+        mAnalysisRunning = false;
+    });
+}
+
+void ChessGUI::stopAnalysis() {
+    if (mAnalysisThread.joinable()) {
+        /* think clears the stop flag when it starts, so it is set again until the search returns */
+        while (mAnalysisRunning) {
+            mAnalysis->stop();
+            std::this_thread::yield();
+        }
+        mAnalysisThread.join();
+    }
+    mAnalysisRunning = false;
+}
+
+/* Brings the rows up to date with the Move List of the game. White moves start a row with their number ("12.e4"), Black moves and the result complete it */
+void ChessGUI::updateMoveHistory() {
+    const std::vector<std::string> & moves = mGame->moveList;
+    if (mGame->getMoveListResets() != mHistoryResets || moves.size() < mHistoryMoves) {
+        mHistoryRows.clear();
+        mHistoryMoves = 0;
+        mHistoryResets = mGame->getMoveListResets();
+    }
+
+    for (; mHistoryMoves < moves.size(); ++mHistoryMoves) {
+        const std::string & move = moves[mHistoryMoves];
+        if (mHistoryRows.empty() || move.find('.') != std::string::npos) {
+            mHistoryRows.push_back(move);
+        } else {
+            mHistoryRows.back() += ' ';
+            mHistoryRows.back() += move;
+        }
+        mHistoryScroll = true;
+    }
+}
+
+/* Loads a Polyglot book and lists its moves for the current position, with the share of each move in the book */
+void ChessGUI::bookMenu() {
+    static char bookBuffer[256] = "book.bin";
+    ImGui::InputTextWithHint("Book", "path/to/book.bin", bookBuffer, IM_ARRAYSIZE(bookBuffer));
+
+    if (ImGui::Button("Load Book")) {
+        if (mBook.open(bookBuffer)) {
+            mBookKey = 0;
+            mBookMoves.clear();
+        } else {
+            ImGui::OpenPopup("Invalid Book");
+        }
+    }
+
+    if (ImGui::BeginPopupModal("Invalid Book")) {
+        ImGui::Text("Unable to open the book!");
+        if (ImGui::Button("OK")) ImGui::CloseCurrentPopup();
+        ImGui::EndPopup();
+    }
+
+    if (!mBook.isOpen()) {
+        ImGui::TextDisabled("No book loaded");
+        return;
+    }
+
+    /* Probe only when the position changes */
+    const Board & board = mGame->getBoard();
+    std::uint64_t key = computeZobristKey(board);
+    if (key != mBookKey) {
+        mBookKey = key;
+        mBookMoves.clear();
+        mBookWeights.clear();
+
+        std::vector<BookMove> moves;
+        mBook.findMoves(board, moves);
+        float total = 0.0f;
+        for (const BookMove & move : moves) total += move.weight;
+
+        for (const BookMove & move : moves) {
+            char san[SAN_BUFFER_SIZE];
+            if (writeSAN(board, move.move, san, sizeof(san)) == 0) continue;
+            mBookMoves.push_back(san);
+            mBookWeights.push_back(total > 0.0f ? move.weight / total : 0.0f);
+        }
+    }
+
+    ImGui::Text("%zu entries", mBook.getEntryCount());
+    if (mBookMoves.empty()) {
+        ImGui::Text("Out of book");
+        return;
+    }
+
+    for (std::size_t i = 0; i < mBookMoves.size(); ++i) {
+        ImGui::Text("%-8s", mBookMoves[i].c_str());
+        ImGui::SameLine();
+        ImGui::ProgressBar(mBookWeights[i], ImVec2(-FLT_MIN, 0.0f));
+    }
 }
 
 /* Game Over Option Menu. Implement it later */
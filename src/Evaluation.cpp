@@ -0,0 +1,151 @@
+/* Standard Libraries */
+#include <array>
+
+/* Include other defined headers */
+#include "Evaluation.hpp"
+
+/* ##### Piece-Square Tables ##### */
+/* Bonuses of each piece on each square, written from White's point of view with a8 first, as seen on a diagram. Black uses the same tables mirrored */
+using Table = std::array<int, 64>;
+
+static const Table pawnTable = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+static const Table knightTable = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+static const Table bishopTable = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+static const Table rookTable = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+static const Table queenTable = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+static const Table kingMiddlegameTable = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20
+};
+
+static const Table kingEndgameTable = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+/* Game phase: 24 with all the pieces on the board, 0 with only Kings and pawns */
+static const int MAX_PHASE = 24;
+
+int pieceValue(PieceType type) {
+    switch (type) {
+        case PieceType::Pawn: return 100;
+        case PieceType::Knight: return 320;
+        case PieceType::Bishop: return 330;
+        case PieceType::Rook: return 500;
+        case PieceType::Queen: return 900;
+        default: return 0;
+    }
+}
+
+static int piecePhase(PieceType type) {
+    switch (type) {
+        case PieceType::Knight: return 1;
+        case PieceType::Bishop: return 1;
+        case PieceType::Rook: return 2;
+        case PieceType::Queen: return 4;
+        default: return 0;
+    }
+}
+
+int evaluate(const Board & board) {
+    int score = 0; /* From White's point of view */
+    int phase = 0;
+    int kingMiddlegame = 0;
+    int kingEndgame = 0;
+
+    for (int i = 0; i < 64; ++i) {
+        const Piece * piece = board.board[i];
+        if (!piece) continue;
+
+        /* The tables start at a8, so White flips the rank and Black reads them as they are */
+        int row = Board::indexToRow(i);
+        int col = Board::indexToColumn(i);
+        bool white = piece->getColor() == Color::White;
+        int square = white ? (ROW - 1 - row) * COL + col : row * COL + col;
+        int sign = white ? 1 : -1;
+
+        PieceType type = piece->getType();
+        phase += piecePhase(type);
+
+        switch (type) {
+            case PieceType::Pawn: score += sign * pawnTable[square]; break;
+            case PieceType::Knight: score += sign * knightTable[square]; break;
+            case PieceType::Bishop: score += sign * bishopTable[square]; break;
+            case PieceType::Rook: score += sign * rookTable[square]; break;
+            case PieceType::Queen: score += sign * queenTable[square]; break;
+            case PieceType::King:
+                kingMiddlegame += sign * kingMiddlegameTable[square];
+                kingEndgame += sign * kingEndgameTable[square];
+                break;
+            default: break;
+        }
+        score += sign * pieceValue(type);
+    }
+
+    if (phase > MAX_PHASE) phase = MAX_PHASE; /* Early promotions */
+    score += (kingMiddlegame * phase + kingEndgame * (MAX_PHASE - phase)) / MAX_PHASE;
+
+    return (board.getTurn() == Color::White) ? score : -score;
+}
@@ -1,5 +1,6 @@
 /* Standard Libraries */
 #include <fstream>
+#include <chrono>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
@@ -12,6 +13,9 @@
 /* User Libraries */
 #include "Game.hpp"
 #include "Graphics.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
+#include "Notation.hpp"
 #include "Piece.hpp"
 
 /* SDL */
@@ -20,7 +24,7 @@
 #include "SDL_timer.h"
 
 /* Game Loader */
-ChessGame::ChessGame(const std::string& fen) : mState(GameState::Idle), mBoard(this), mFocusIndex(-1), mTargetIndex(-1), mTurn(Color::White), mHalfMoveClock(0), mFullMoveClock(1), mWasClicked(false), mProcessGameOver(false) {
+ChessGame::ChessGame(const std::string& fen) : mState(GameState::Idle), mBoard(this), mFocusIndex(-1), mTargetIndex(-1), mWasClicked(false), mProcessGameOver(false), mMoveListResets(0), mGameOverSeconds(0.0f) {
     try {
         mBoard.loadFromFEN(fen); 
     }
@@ -40,7 +44,10 @@ void ChessGame::resetGame() {
     mFocusIndex = -1; /* Reset */
     mTargetIndex = -1; /* Reset */
     mProcessGameOver = false;
+    mGameOverSeconds = 0.0f;
+    graphics.clearAnimations();
     moveList.clear(); /* Clear the Move List */
+    ++mMoveListResets;
     mBoard.loadFromFEN(); /* Load Default Board */
     //graphics.renderBoardWithPieces(board); /* Render */
 }
@@ -51,7 +58,10 @@ bool ChessGame::loadFEN(const std::string fen) {
     mFocusIndex = -1; /* Reset */
     mTargetIndex = -1; /* Reset */
     mProcessGameOver = false;
+    mGameOverSeconds = 0.0f;
+    graphics.clearAnimations();
     moveList.clear(); /* Clear the Move List */
+    ++mMoveListResets;
 
     try {
         mBoard.loadFromFEN(fen); 
@@ -74,6 +84,20 @@ void ChessGame::handleRender() {
         case GameState::GameOver: graphics.renderBoardWithPieces(mBoard); break;
         default: break;
     }
+    graphics.renderAnimations();
+
+    /* Outcome of the game, on top of the board until the Game Over menu appears */
+    if (mState == GameState::GameOver && mProcessGameOver && !isGameOverMenuReady())
+        graphics.renderText(mOutcome);
+
+    graphics.flushSprites(); /* The sprites and text of the frame, in one batch */
+}
+
+/* Advances the animations and timers by the real time elapsed since the last frame */
+void ChessGame::handleUpdate(float seconds) {
+    graphics.updateAnimations(seconds);
+    if (mState == GameState::GameOver && mProcessGameOver)
+        mGameOverSeconds += seconds;
 }
 
 void ChessGame::handleStatesProcessing() {
@@ -84,6 +108,13 @@ void ChessGame::handleStatesProcessing() {
     }
 }
 
+/* The main loop can wait for the next event instead of rendering the same frame again */
+bool ChessGame::isIdle() const {
+    if (graphics.isAnimating() || mState == GameState::Processing) return false;
+    if (mState == GameState::GameOver && (!mProcessGameOver || !isGameOverMenuReady())) return false;
+    return true;
+}
+
 /* Handle the different events */
 void ChessGame::handleEvent(SDL_Event & event) {
     
@@ -122,7 +153,7 @@ void ChessGame::handleEvent(SDL_Event & event) {
                 /* If it is idle, it means the next state will be piece select */
                 if (mState == GameState::Idle) {
                     Piece * piece = mBoard.board[clickedIndex];
-                    if (piece && piece->getColor() == mTurn) {
+                    if (piece && piece->getColor() == mBoard.getTurn()) {
                         mFocusIndex = clickedIndex;
                         mState = GameState::PieceSelected;
                     }
@@ -134,7 +165,7 @@ void ChessGame::handleEvent(SDL_Event & event) {
                     Piece * targetPiece = mBoard.board[mTargetIndex];
                     
                     /* If is the same color piece, change the focus to the new focused piece*/
-                    if (targetPiece && targetPiece->getColor() == mTurn) {
+                    if (targetPiece && targetPiece->getColor() == mBoard.getTurn()) {
                         mFocusIndex = mTargetIndex;
                         return;
                     }
@@ -181,7 +212,7 @@ void ChessGame::handleEvent(SDL_Event & event) {
                 } else {
                     /* Invalid Drop, return to previous selection */
                     mState = GameState::PieceSelected;
-                    if (mBoard.isKingInCheck(mTurn)) Mix_PlayChannel(-1, illegalMoveSound, 0);
+                    if (mBoard.isKingInCheck(mBoard.getTurn())) Mix_PlayChannel(-1, illegalMoveSound, 0);
                 }
             }
         }
@@ -196,71 +227,51 @@ void ChessGame::handleProcessingMove() {
     /* If one of the indexes is not valid, do not proceed with the handling */
     if (!(Board::isValidIndex(mFocusIndex) && Board::isValidIndex(mTargetIndex)))
         return;
+    auto start = std::chrono::steady_clock::now();
 
     Piece * focusedPiece = mBoard.board[mFocusIndex];
     Piece * targetPiece = mBoard.board[mTargetIndex];
+    PieceType focusedType = focusedPiece ? focusedPiece->getType() : PieceType::Empty;
     if (mBoard.validateMove(mFocusIndex, mTargetIndex)) {
 
-        /* Animate the move if it was a click (not drag) */
-        if (mWasClicked) {
-            graphics.animatePieceMoving(mBoard, mFocusIndex, mTargetIndex); /* Try to remove from here! */
-            mWasClicked = false;
-        }
+        /* Animate the move, sliding the piece only if it was a click (not drag). The animation runs in the next frames */
+        graphics.animatePieceMoving(mBoard, mFocusIndex, mTargetIndex, mWasClicked);
+        mWasClicked = false;
 
         /* Play the capture sound if it is an en-passant */
         if(mTargetIndex == mBoard.getEnPassantIndex())
             Mix_PlayChannel(-1, captureSound, 0);
 
-        /* Increment halfMoveClock */
-        mHalfMoveClock++;
-
-        /* Reset halfMoveClock if it is a pawn or a capture */
-        if (focusedPiece->getType() == PieceType::Pawn || (targetPiece != nullptr)) {
-            mHalfMoveClock = 0;
-        }
-
         /* Register Move */
         registerMove();
 
-        /* Execute the move on the logical board */
-        if (mBoard.movePiece(mFocusIndex, mTargetIndex)) {
-
-            /* Switch turns */
-            mTurn = (mTurn == Color::White) ? Color::Black : Color::White;
-            mBoard.validateAllNextPlayerMoves(mTurn);
-            mBoard.countMoves(mTurn);
+        /* Execute the move on the logical board, which also switches turns and updates the move clocks */
+        if (mBoard.playMove({mFocusIndex, mTargetIndex, PieceType::Queen})) {
 
             /* Manage Sounds Effects :) */
-            if(mBoard.isKingInCheck(mTurn)) {
+            if(mBoard.isKingInCheck(mBoard.getTurn())) {
                 Mix_PlayChannel(-1, moveCheckSound, 0);
             } else {
                 if(targetPiece != nullptr) {
                     Mix_PlayChannel(-1, captureSound, 0);
-                } else if (abs(mTargetIndex - mFocusIndex) == 2 && focusedPiece->getType() == PieceType::King) {
+                } else if (abs(mTargetIndex - mFocusIndex) == 2 && focusedType == PieceType::King) {
                     Mix_PlayChannel(-1, castleSound, 0);
                 } else {
                     Mix_PlayChannel(-1, moveSound, 0);
                 }
             }
-            // Update the board display
-            graphics.renderBoardWithPieces(mBoard);
         }
     } else {
-        if (mBoard.isKingInCheck(mTurn)) Mix_PlayChannel(-1, illegalMoveSound, 0);
-    }
-
-    /* Increment Full Move Clock */
-    if (mTurn == Color::Black) {
-        ++mFullMoveClock;
+        if (mBoard.isKingInCheck(mBoard.getTurn())) Mix_PlayChannel(-1, illegalMoveSound, 0);
     }
 
     /* Check if it is a Checkmate */
-    if (!mBoard.existLegalMoves(mTurn)) {
+    if (!mBoard.existLegalMoves(mBoard.getTurn())) {
         mState = GameState::GameOver;
     }
 
-    /* Check for 50 Move Rule */
-    if (mHalfMoveClock == 50) {
+    /* Check for 50 Move Rule (100 half moves without a pawn move or capture) */
+    if (mBoard.getHalfMoveClock() >= 100) {
         mState = GameState::GameOver;
     }
 
@@ -271,83 +282,53 @@ void ChessGame::handleProcessingMove() {
     std::cerr << moveList.back() << std::endl;
     mFocusIndex = -1;
     mTargetIndex = -1;
+    engineMetrics().moveLatency.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
 }
 
-/* Handling GameOver. Prints the text into the screen, generates the PGN file and then resets the game */
+/* Handling GameOver. Sets the text printed on the screen by handleRender and generates the PGN file. The Game Over menu lets the user reset the game */
 void ChessGame::handleGameOver() {
     if (!mProcessGameOver) {
-        std::string outcome;
         std::string inMoveList;
 
-        if (mBoard.isKingInCheck(mTurn)) {
-            outcome = (mTurn == Color::White) ? "Black Wins by Checkmate" : "White Wins by Checkmate";
-            inMoveList = (mTurn == Color::White) ? "0-1" : "1-0";
+        Color turn = mBoard.getTurn();
+        if (mBoard.isKingInCheck(turn)) {
+            mOutcome = (turn == Color::White) ? "Black Wins by Checkmate" : "White Wins by Checkmate";
+            inMoveList = (turn == Color::White) ? "0-1" : "1-0";
         } else {
-            if(mHalfMoveClock == 50) {
-                outcome = "Draw by 50-Move Rule";
+            if(mBoard.getHalfMoveClock() >= 100) {
+                mOutcome = "Draw by 50-Move Rule";
             } else {
-                outcome = "Stalemate";
+                mOutcome = "Stalemate";
             }
             
             inMoveList = "1/2-1/2";
         }
-        graphics.printText(mBoard, outcome);
         moveList.push_back(inMoveList);
         generatePGN(inMoveList);
-        SDL_Delay(3000);
+        mGameOverSeconds = 0.0f;
         mProcessGameOver = true;
     }
 
 }
 
-/* Register a Move. Partially implemented, and is not totally according to the Standard Algebraic Notation */
+/* Register a Move in Standard Algebraic Notation, prefixed by the move number for White moves */
 void ChessGame::registerMove() {
-    std::string move;
-    Piece * movingPiece = mBoard.board[mFocusIndex];
-    Piece * targetSquare = mBoard.board[mTargetIndex];
-    if (movingPiece == nullptr) return; /* Throw?? */
-
-    int fromIndex = mFocusIndex;
-    int destIndex = mTargetIndex;
-
-    /* Add Numbering for White Moves */
-    if (mTurn == Color::White) {
-        /* https://stackoverflow.com/questions/5590381/how-to-convert-int-to-string-in-c*/
-        std::string number = std::to_string(mFullMoveClock) + ".";
-        move.append(number);
-    }
-
-    /* Pawn Moves */
-    if (movingPiece->getType() == PieceType::Pawn) {
-        move.append(Board::indexToAlgebraic(fromIndex));
-        move.append(Board::indexToAlgebraic(destIndex));
-        /* Add move and return */
-        moveList.push_back(move);
-        return;
+    char san[SAN_BUFFER_SIZE];
+    Move move = {mFocusIndex, mTargetIndex, PieceType::Queen};
+    if (writeSAN(mBoard, move, san, sizeof(san)) == 0) return; /* Not a legal move */
+
+    std::string entry;
+    if (mBoard.getTurn() == Color::White) {
+        entry = std::to_string(mBoard.getFullMoveClock());
+        entry += '.';
     }
-
-    /* Other Pieces */
-    PieceType type = movingPiece->getType();
-    char pieceID = '\0';
-    switch (type) {
-        case PieceType::Bishop: pieceID = 'B'; break;
-        case PieceType::Knight: pieceID = 'N'; break;
-        case PieceType::Rook: pieceID = 'R'; break;
-        case PieceType::Queen: pieceID = 'Q'; break;
-        case PieceType::King: pieceID = 'K'; break;
-        default: break;
-    }
-
-    move += pieceID; /* Add the Piece Identifier */
-    move.append(Board::indexToAlgebraic(fromIndex));
-    if (targetSquare != nullptr) move += 'x'; /* Add x if it is a capture */
-    move.append(Board::indexToAlgebraic(destIndex)); /* Add destination square*/
-    moveList.push_back(move); /* add move to the list */
-
+    entry += san;
+    moveList.push_back(std::move(entry));
 }
 
 /* Initialize a PGN File (Not the full implementation for now). Asked to DeepSeek */
 bool ChessGame::generatePGN(const std::string & result) {
+    TRACE_ZONE("pgn", "generatePGN");
 
     /* Create File Name using the Time */
     auto now = std::time(nullptr);
@@ -0,0 +1,269 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+
+/* Include other defined headers */
+#include "GameArchive.hpp"
+#include "Notation.hpp"
+
+/* The sections are read in place from the mapped file, so their layout must not depend on the compiler */
+static_assert(sizeof(ArchiveHeader) == 80, "Unexpected ArchiveHeader layout");
+static_assert(sizeof(ArchiveTag) == 8, "Unexpected ArchiveTag layout");
+static_assert(sizeof(ArchiveGameEntry) == 24, "Unexpected ArchiveGameEntry layout");
+
+/* ##### Helpers ##### */
+void sortedLegalMoves(const Board & board, std::vector<Move> & moves) {
+    board.generateLegalMoves(moves);
+    std::sort(moves.begin(), moves.end(), [](const Move & a, const Move & b) {
+        if (a.from != b.from) return a.from < b.from;
+        if (a.to != b.to) return a.to < b.to;
+        return static_cast<int>(a.promotion) < static_cast<int>(b.promotion);
+    });
+}
+
+/* Loads the starting position of a game, which is the initial position unless a FEN is given */
+static bool loadPosition(Board & board, const char * fen) {
+    return (fen ? board.parseFEN(fen) : board.parseFEN()) == FENError::None;
+}
+
+static ArchiveResult resultFromString(const std::string & result) {
+    if (result == "1-0") return ArchiveResult::WhiteWins;
+    if (result == "0-1") return ArchiveResult::BlackWins;
+    if (result == "1/2-1/2") return ArchiveResult::Draw;
+    return ArchiveResult::Unknown;
+}
+
+static const char * resultToString(std::uint8_t result) {
+    switch (static_cast<ArchiveResult>(result)) {
+        case ArchiveResult::WhiteWins: return "1-0";
+        case ArchiveResult::BlackWins: return "0-1";
+        case ArchiveResult::Draw: return "1/2-1/2";
+        default: return "*";
+    }
+}
+
+/* Bytes needed to align an offset to 8 bytes */
+static std::uint64_t paddingFor(std::uint64_t offset) {
+    return (8 - (offset % 8)) % 8;
+}
+
+/* ##### GameArchiveWriter ##### */
+GameArchiveWriter::GameArchiveWriter() : mMovesSize(0) {}
+
+GameArchiveWriter::~GameArchiveWriter() {
+    if (mFile.is_open()) close();
+}
+
+bool GameArchiveWriter::open(const std::string & path) {
+    mFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!mFile) return false;
+
+    mEntries.clear();
+    mTags.clear();
+    mStrings.clear();
+    mStringIds.clear();
+    mMovesSize = 0;
+
+    /* The header is only known at the end, reserve its space */
+    ArchiveHeader header = {};
+    mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    return static_cast<bool>(mFile);
+}
+
+/* Returns the offset of a string in the table, adding it if this is its first use */
+std::uint32_t GameArchiveWriter::addString(const std::string & text) {
+    auto it = mStringIds.find(text);
+    if (it != mStringIds.end()) return it->second;
+
+    std::uint32_t id = static_cast<std::uint32_t>(mStrings.size());
+    mStrings.append(text.c_str(), text.size() + 1);
+    mStringIds.emplace(text, id);
+    return id;
+}
+
+bool GameArchiveWriter::addGame(const PGNGame & game) {
+    if (!mFile.is_open()) return false;
+
+    /* String offsets are 32 bits, refuse the game if its tags could overflow the table */
+    std::size_t tagBytes = 0;
+    for (const PGNTag & tag : game.tags) tagBytes += tag.name.size() + tag.value.size() + 2;
+    if (mStrings.size() + tagBytes > std::numeric_limits<std::uint32_t>::max()) return false;
+    if (game.tags.size() > std::numeric_limits<std::uint16_t>::max()) return false;
+
+    /* Encode each move as its index in the sorted legal moves of the position */
+    const std::string * fen = game.findTag("FEN");
+    if (!loadPosition(mBoard, fen ? fen->c_str() : nullptr)) return false;
+
+    mEncoded.clear();
+    for (const std::string & san : game.moves) {
+        Move move;
+        if (!parseSAN(mBoard, san, move)) return false;
+
+        sortedLegalMoves(mBoard, mLegalMoves);
+        auto found = std::find(mLegalMoves.begin(), mLegalMoves.end(), move);
+        if (found == mLegalMoves.end() || !mBoard.playMove(move)) return false;
+        mEncoded.push_back(static_cast<std::uint8_t>(found - mLegalMoves.begin()));
+    }
+
+    mFile.write(reinterpret_cast<const char *>(mEncoded.data()), mEncoded.size());
+    if (!mFile) return false;
+
+    ArchiveGameEntry entry = {};
+    entry.moves = mMovesSize;
+    entry.tags = mTags.size();
+    entry.moveCount = static_cast<std::uint32_t>(mEncoded.size());
+    entry.tagCount = static_cast<std::uint16_t>(game.tags.size());
+    entry.result = static_cast<std::uint8_t>(resultFromString(game.result));
+    mEntries.push_back(entry);
+
+    for (const PGNTag & tag : game.tags)
+        mTags.push_back({addString(tag.name), addString(tag.value)});
+
+    mMovesSize += mEncoded.size();
+    return true;
+}
+
+bool GameArchiveWriter::close() {
+    if (!mFile.is_open()) return false;
+
+    static const char zeros[8] = {};
+    ArchiveHeader header = {};
+    std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = ARCHIVE_VERSION;
+    header.gameCount = mEntries.size();
+    header.movesOffset = sizeof(ArchiveHeader);
+    header.movesSize = mMovesSize;
+
+    std::uint64_t offset = header.movesOffset + header.movesSize;
+    mFile.write(zeros, paddingFor(offset));
+    offset += paddingFor(offset);
+
+    header.stringsOffset = offset;
+    header.stringsSize = mStrings.size();
+    mFile.write(mStrings.data(), mStrings.size());
+    offset += mStrings.size();
+    mFile.write(zeros, paddingFor(offset));
+    offset += paddingFor(offset);
+
+    header.tagsOffset = offset;
+    header.tagCount = mTags.size();
+    mFile.write(reinterpret_cast<const char *>(mTags.data()), mTags.size() * sizeof(ArchiveTag));
+    offset += mTags.size() * sizeof(ArchiveTag);
+
+    header.indexOffset = offset;
+    mFile.write(reinterpret_cast<const char *>(mEntries.data()), mEntries.size() * sizeof(ArchiveGameEntry));
+
+    mFile.seekp(0);
+    mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    bool good = static_cast<bool>(mFile);
+    mFile.close();
+    return good;
+}
+
+/* ##### GameArchive ##### */
+GameArchive::GameArchive() : mHeader(nullptr), mMoves(nullptr), mStrings(nullptr), mTags(nullptr), mIndex(nullptr) {}
+
+/* Maps the file and checks that every section lies inside it. The games themselves are only checked when read */
+bool GameArchive::open(const std::string & path) {
+    close();
+    if (!mFile.open(path)) return false;
+
+    const char * data = mFile.getData();
+    std::uint64_t size = mFile.getSize();
+    if (size < sizeof(ArchiveHeader)) { close(); return false; }
+
+    const ArchiveHeader * header = reinterpret_cast<const ArchiveHeader *>(data);
+    bool valid = std::memcmp(header->magic, ARCHIVE_MAGIC, sizeof(header->magic)) == 0 && header->version == ARCHIVE_VERSION
+        && header->movesOffset <= size && header->movesSize <= size - header->movesOffset
+        && header->stringsOffset <= size && header->stringsSize <= size - header->stringsOffset
+        && (header->stringsSize == 0 || data[header->stringsOffset + header->stringsSize - 1] == '\0')
+        && header->tagsOffset % 8 == 0 && header->tagsOffset <= size && header->tagCount <= (size - header->tagsOffset) / sizeof(ArchiveTag)
+        && header->indexOffset % 8 == 0 && header->indexOffset <= size && header->gameCount <= (size - header->indexOffset) / sizeof(ArchiveGameEntry);
+    if (!valid) { close(); return false; }
+
+    mHeader = header;
+    mMoves = reinterpret_cast<const std::uint8_t *>(data + header->movesOffset);
+    mStrings = data + header->stringsOffset;
+    mTags = reinterpret_cast<const ArchiveTag *>(data + header->tagsOffset);
+    mIndex = reinterpret_cast<const ArchiveGameEntry *>(data + header->indexOffset);
+    return true;
+}
+
+void GameArchive::close() {
+    mFile.close();
+    mHeader = nullptr;
+    mMoves = nullptr;
+    mStrings = nullptr;
+    mTags = nullptr;
+    mIndex = nullptr;
+}
+
+bool GameArchive::loadStartPosition(std::uint64_t index, Board & board) const {
+    if (index >= getGameCount()) return false;
+
+    const ArchiveGameEntry & entry = mIndex[index];
+    if (entry.moves > mHeader->movesSize || entry.moveCount > mHeader->movesSize - entry.moves) return false;
+    if (entry.tags > mHeader->tagCount || entry.tagCount > mHeader->tagCount - entry.tags) return false;
+
+    const char * fen = nullptr;
+    for (std::uint64_t i = entry.tags; i < entry.tags + entry.tagCount; ++i) {
+        if (mTags[i].name >= mHeader->stringsSize || mTags[i].value >= mHeader->stringsSize) return false;
+        if (std::strcmp(getString(mTags[i].name), "FEN") == 0) fen = getString(mTags[i].value);
+    }
+
+    return loadPosition(board, fen);
+}
+
+bool GameArchive::readMoves(std::uint64_t index, Board & board, std::vector<Move> & moves) const {
+    if (!loadStartPosition(index, board)) return false;
+
+    const ArchiveGameEntry & entry = mIndex[index];
+
+    std::vector<Move> legalMoves;
+    moves.clear();
+    const std::uint8_t * encoded = mMoves + entry.moves;
+    for (std::uint32_t i = 0; i < entry.moveCount; ++i) {
+        sortedLegalMoves(board, legalMoves);
+        if (encoded[i] >= legalMoves.size()) return false;
+
+        const Move & move = legalMoves[encoded[i]];
+        if (!board.playMove(move)) return false;
+        moves.push_back(move);
+    }
+    return true;
+}
+
+/* The SAN of a move needs the positions before and after it, so two boards take turns being the current position instead of copying the board twice per move */
+bool GameArchive::readGame(std::uint64_t index, PGNGame & game) const {
+    game.clear();
+    if (index >= getGameCount()) return false;
+
+    std::optional<Board> positions[2];
+    positions[0].emplace();
+    if (!loadStartPosition(index, *positions[0])) return false;
+
+    const ArchiveGameEntry & entry = mIndex[index];
+
+    for (std::uint64_t i = entry.tags; i < entry.tags + entry.tagCount; ++i)
+        game.tags.push_back({getString(mTags[i].name), getString(mTags[i].value)});
+    game.result = resultToString(entry.result);
+
+    std::vector<Move> legalMoves;
+    char san[SAN_BUFFER_SIZE];
+    const std::uint8_t * encoded = mMoves + entry.moves;
+    for (std::uint32_t i = 0; i < entry.moveCount; ++i) {
+        const Board & before = *positions[i % 2];
+        sortedLegalMoves(before, legalMoves);
+        if (encoded[i] >= legalMoves.size()) return false;
+
+        const Move & move = legalMoves[encoded[i]];
+        positions[(i + 1) % 2].emplace(before);
+        Board & after = *positions[(i + 1) % 2];
+        if (!after.playMove(move) || writeSAN(before, move, san, sizeof(san), &after) == 0) return false;
+        game.moves.emplace_back(san);
+    }
+    return true;
+}
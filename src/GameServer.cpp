@@ -0,0 +1,491 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* Include other defined headers */
+#include "GameServer.hpp"
+#include "Metrics.hpp"
+#include "Notation.hpp"
+#include "Trace.hpp"
+
+/* Metrics of the server, exported with the engine ones */
+struct ServerMetrics {
+    Counter connections{"cppchess_server_connections_total", "Connections accepted by the game server"};
+    Counter games{"cppchess_server_games_total", "Games created on the game server"};
+    Counter moves{"cppchess_server_moves_total", "Moves played on the game server, including the engine moves"};
+    Histogram engineLatency{"cppchess_server_engine_move_seconds", "Time from queueing an engine move to playing it", {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5}};
+};
+
+static ServerMetrics & serverMetrics() {
+    static ServerMetrics metrics;
+    return metrics;
+}
+
+static const int MAX_EVENTS = 256;
+
+static const char * colorName(Color color) {
+    return color == Color::White ? "white" : "black";
+}
+
+/* Splits a command into its words, at most the few a command has */
+static void splitWords(std::string_view line, std::vector<std::string_view> & words) {
+    words.clear();
+    std::size_t i = 0;
+    while (i < line.size() && words.size() < 4) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) ++i;
+        std::size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t') ++i;
+        if (i > start) words.push_back(line.substr(start, i - start));
+    }
+}
+
+static bool parseId(std::string_view text, std::uint64_t & id) {
+    auto parsed = std::from_chars(text.data(), text.data() + text.size(), id);
+    return parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+}
+
+GameServer::GameServer(const ServerOptions & options) : mOptions(options), mListenFd(-1), mEpollFd(-1), mWakeFd(-1), mStopping(false), mNextGameId(1), mJobs(options.maxGames) {}
+
+/* The jobs left are for games whose players are gone: they are dropped, and the searches running aborted, rather than searched to the end */
+GameServer::~GameServer() {
+    mStopping.store(true);
+    mJobs.close();
+    mJobs.clear();
+    for (std::unique_ptr<Search> & search : mSearches) search->stop();
+    for (std::thread & worker : mWorkers) worker.join();
+
+    for (auto & [fd, connection] : mConnections) ::close(fd);
+    if (mListenFd >= 0) ::close(mListenFd);
+    if (mWakeFd >= 0) ::close(mWakeFd);
+    if (mEpollFd >= 0) ::close(mEpollFd);
+}
+
+bool GameServer::start() {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(mOptions.port));
+    if (::inet_pton(AF_INET, mOptions.host.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "Invalid address " << mOptions.host << std::endl;
+        return false;
+    }
+
+    mListenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if (mListenFd < 0 || ::setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 || ::bind(mListenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(mListenFd, SOMAXCONN) != 0) {
+        std::cerr << "Unable to listen on " << mOptions.host << ":" << mOptions.port << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    mWakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mEpollFd < 0 || mWakeFd < 0) {
+        std::cerr << "Unable to create the event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = mListenFd;
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mListenFd, &event);
+    event.data.fd = mWakeFd;
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &event);
+
+    unsigned workers = mOptions.workers ? mOptions.workers : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < workers; ++i) mSearches.push_back(std::make_unique<Search>(mOptions.hash));
+    for (unsigned i = 0; i < workers; ++i) mWorkers.emplace_back(&GameServer::runWorker, this, i);
+
+    serverMetrics();
+    return true;
+}
+
+void GameServer::stop() {
+    mStopping.store(true);
+    std::uint64_t one = 1;
+    ssize_t written = ::write(mWakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+void GameServer::run() {
+    setTraceThreadName("server");
+    epoll_event events[MAX_EVENTS];
+
+    while (!mStopping.load()) {
+        int count = ::epoll_wait(mEpollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        TRACE_ZONE("server", "events");
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == mListenFd) {
+                acceptConnections();
+            } else if (fd == mWakeFd) {
+                std::uint64_t value;
+                while (::read(mWakeFd, &value, sizeof(value)) > 0) {}
+                handleEngineReplies();
+            } else {
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) readConnection(fd);
+                auto found = mConnections.find(fd);
+                if (found != mConnections.end() && (events[i].events & EPOLLOUT) && !found->second.dirty) {
+                    found->second.dirty = true;
+                    mDirty.push_back(fd);
+                }
+            }
+        }
+
+        /* Every answer of the iteration is written at once, in one send per connection */
+        flushConnections();
+    }
+}
+
+/* ##### Connections ##### */
+void GameServer::acceptConnections() {
+    for (;;) {
+        int fd = ::accept4(mListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        /* The answers are small and latency matters more than packing them */
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+
+        mConnections[fd].socket = LineSocket(fd);
+        ++mStats.connections;
+        serverMetrics().connections.add();
+    }
+}
+
+void GameServer::readConnection(int fd) {
+    auto found = mConnections.find(fd);
+    if (found == mConnections.end()) return;
+
+    LineSocket & socket = found->second.socket;
+    bool open = socket.receive();
+    std::string_view line;
+    while (socket.nextLine(line)) handleCommand(fd, line);
+    if (!open) closeConnection(fd);
+}
+
+/* The games of the connection are lost by it, and the opponents are told */
+void GameServer::closeConnection(int fd) {
+    auto found = mConnections.find(fd);
+    if (found == mConnections.end()) return;
+
+    std::vector<std::uint64_t> games = std::move(found->second.games);
+    for (std::uint64_t id : games) {
+        Game * game = findGame(id);
+        if (!game) continue;
+
+        /* Playing both colors abandons the side to move */
+        bool white = game->players[0] == fd, black = game->players[1] == fd;
+        if (game->started) game->game.abandon(white && black ? game->game.getTurn() : (white ? Color::White : Color::Black));
+        if (white) game->players[0] = -1;
+        if (black) game->players[1] = -1;
+        finishGame(id);
+    }
+
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    mConnections.erase(fd);
+}
+
+void GameServer::send(int fd, std::string_view text) {
+    auto found = mConnections.find(fd);
+    if (found == mConnections.end()) return;
+
+    Connection & connection = found->second;
+    connection.socket.send(text);
+    if (!connection.dirty) {
+        connection.dirty = true;
+        mDirty.push_back(fd);
+    }
+}
+
+/* Writes what each socket accepts. The ones left with output are watched for EPOLLOUT until they drain */
+void GameServer::flushConnections() {
+    std::vector<int> dirty;
+    while (!mDirty.empty()) { /* Closing a connection tells its opponents, which makes more output */
+        dirty.clear();
+        dirty.swap(mDirty);
+        for (int fd : dirty) flushConnection(fd);
+    }
+}
+
+void GameServer::flushConnection(int fd) {
+    auto found = mConnections.find(fd);
+    if (found == mConnections.end()) return;
+
+    Connection & connection = found->second;
+    connection.dirty = false;
+    if (!connection.socket.flush()) {
+        closeConnection(fd);
+        return;
+    }
+
+    bool writing = connection.socket.hasOutput();
+    if (writing != connection.writing) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | (writing ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+        event.data.fd = fd;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, fd, &event);
+        connection.writing = writing;
+    }
+}
+
+/* ##### Commands ##### */
+void GameServer::handleCommand(int fd, std::string_view line) {
+    std::vector<std::string_view> & words = mWords;
+    splitWords(line, words);
+    if (words.empty()) return;
+
+    std::string_view command = words[0];
+    if (command == "create") {
+        createGame(fd, words);
+        return;
+    }
+    if (command == "stats") {
+        send(fd, "stats " + std::to_string(mGames.size()) + " " + std::to_string(mConnections.size()) + " " + std::to_string(mStats.moves) + "\n");
+        return;
+    }
+
+    std::uint64_t id = 0;
+    bool hasId = words.size() >= 2 && parseId(words[1], id);
+    if (command == "join" && hasId) joinGame(fd, id);
+    else if (command == "move" && hasId && words.size() >= 3) playMove(fd, id, words[2]);
+    else if (command == "resign" && hasId) resignGame(fd, id);
+    else if (command == "fen" && hasId) sendFEN(fd, id);
+    else send(fd, "error " + std::string(command) + " invalid command\n");
+}
+
+void GameServer::createGame(int fd, const std::vector<std::string_view> & words) {
+    if (mGames.size() >= mOptions.maxGames) {
+        send(fd, "error create too many games\n");
+        return;
+    }
+
+    Color color = Color::White;
+    bool engine = false;
+    for (std::size_t i = 1; i < words.size(); ++i) {
+        if (words[i] == "white") color = Color::White;
+        else if (words[i] == "black") color = Color::Black;
+        else if (words[i] == "engine") engine = true;
+        else {
+            send(fd, "error create invalid option " + std::string(words[i]) + "\n");
+            return;
+        }
+    }
+
+    std::uint64_t id = mNextGameId++;
+    Game & game = mGames[id];
+    game.players[color == Color::White ? 0 : 1] = fd;
+    game.engine = engine;
+    game.started = engine;
+    mConnections[fd].games.push_back(id);
+    ++mStats.gamesCreated;
+    serverMetrics().games.add();
+
+    send(fd, "created " + std::to_string(id) + " " + colorName(color) + "\n");
+    if (engine && game.game.getTurn() != color && !queueEngineMove(id, game)) {
+        send(fd, "error create " + std::to_string(id) + " engine busy\n");
+        finishGame(id);
+    }
+}
+
+void GameServer::joinGame(int fd, std::uint64_t id) {
+    Game * game = findGame(id);
+    if (!game || game->started) {
+        send(fd, "error join " + std::to_string(id) + " not available\n");
+        return;
+    }
+
+    int seat = game->players[0] == -1 ? 0 : 1;
+    int creator = game->players[1 - seat];
+    game->players[seat] = fd;
+    game->started = true;
+    if (creator != fd) mConnections[fd].games.push_back(id);
+
+    send(fd, "joined " + std::to_string(id) + " " + colorName(seat == 0 ? Color::White : Color::Black) + "\n");
+    if (creator != fd) send(creator, "started " + std::to_string(id) + "\n");
+}
+
+void GameServer::playMove(int fd, std::uint64_t id, std::string_view text) {
+    Game * game = findGame(id);
+    if (!game) {
+        send(fd, "error move " + std::to_string(id) + " unknown game\n");
+        return;
+    }
+
+    int side = game->game.getTurn() == Color::White ? 0 : 1;
+    if (!game->started || game->players[side] != fd) {
+        send(fd, "error move " + std::to_string(id) + " not your turn\n");
+        return;
+    }
+
+    Move move;
+    if (!game->game.playMove(text, move)) {
+        send(fd, "error move " + std::to_string(id) + " illegal move " + std::string(text) + "\n");
+        return;
+    }
+
+    char uci[UCI_BUFFER_SIZE];
+    writeUCI(move, uci, sizeof(uci));
+    ++mStats.moves;
+    serverMetrics().moves.add();
+
+    int opponent = game->players[1 - side];
+    send(fd, "ok " + std::to_string(id) + " " + uci + "\n");
+    if (opponent != -1 && opponent != fd) send(opponent, "moved " + std::to_string(id) + " " + uci + "\n");
+    afterMove(id, *game);
+}
+
+void GameServer::resignGame(int fd, std::uint64_t id) {
+    Game * game = findGame(id);
+    if (!game || (game->players[0] != fd && game->players[1] != fd)) {
+        send(fd, "error resign " + std::to_string(id) + " unknown game\n");
+        return;
+    }
+
+    /* Playing both colors resigns the side to move */
+    Color color = game->players[0] == fd ? Color::White : Color::Black;
+    if (game->players[0] == fd && game->players[1] == fd) color = game->game.getTurn();
+    game->game.resign(color);
+    finishGame(id);
+}
+
+void GameServer::sendFEN(int fd, std::uint64_t id) {
+    Game * game = findGame(id);
+    if (!game) {
+        send(fd, "error fen " + std::to_string(id) + " unknown game\n");
+        return;
+    }
+
+    char fen[FEN_BUFFER_SIZE];
+    game->game.getBoard().toFEN(fen, sizeof(fen));
+    send(fd, "fen " + std::to_string(id) + " " + fen + "\n");
+}
+
+/* ##### Games ##### */
+GameServer::Game * GameServer::findGame(std::uint64_t id) {
+    auto found = mGames.find(id);
+    return found == mGames.end() ? nullptr : &found->second;
+}
+
+void GameServer::afterMove(std::uint64_t id, Game & game) {
+    if (game.game.isOver()) {
+        finishGame(id);
+        return;
+    }
+
+    int side = game.game.getTurn() == Color::White ? 0 : 1;
+    if (game.engine && game.players[side] == -1 && !queueEngineMove(id, game)) {
+        send(game.players[1 - side], "error move " + std::to_string(id) + " engine busy\n");
+        finishGame(id);
+    }
+}
+
+/* Tells the players how the game ended and forgets it */
+void GameServer::finishGame(std::uint64_t id) {
+    auto found = mGames.find(id);
+    if (found == mGames.end()) return;
+
+    Game & game = found->second;
+    std::string end = "end " + std::to_string(id) + " " + game.game.getResult() + " " + (game.game.isOver() ? gameEndName(game.game.getEnd()) : "cancelled") + "\n";
+    for (int i = 0; i < 2; ++i) {
+        int fd = game.players[i];
+        if (fd == -1 || (i == 1 && fd == game.players[0])) continue;
+        send(fd, end);
+
+        auto connection = mConnections.find(fd);
+        if (connection == mConnections.end()) continue;
+        std::vector<std::uint64_t> & games = connection->second.games;
+        games.erase(std::remove(games.begin(), games.end(), id), games.end());
+    }
+
+    ++mStats.gamesFinished;
+    mGames.erase(found);
+}
+
+/* Never waits for the workers, as it runs on the event loop. Returns false if the queue is full */
+bool GameServer::queueEngineMove(std::uint64_t id, const Game & game) {
+    EngineJob job;
+    job.gameId = id;
+    job.ply = game.game.getPlies();
+    job.board = std::make_unique<Board>(game.game.getBoard());
+    job.history.assign(game.game.getKeys().begin(), game.game.getKeys().end() - 1);
+    job.queued = std::chrono::steady_clock::now();
+    return mJobs.tryPush(std::move(job));
+}
+
+/* Moves of games which ended, or went on, while the engine was thinking are dropped */
+void GameServer::handleEngineReplies() {
+    std::vector<EngineReply> replies;
+    {
+        std::lock_guard<std::mutex> lock(mRepliesMutex);
+        replies.swap(mReplies);
+    }
+
+    for (const EngineReply & reply : replies) {
+        Game * game = findGame(reply.gameId);
+        if (!game || game->game.getPlies() != reply.ply || !game->game.playMove(reply.move)) continue;
+
+        char uci[UCI_BUFFER_SIZE];
+        writeUCI(reply.move, uci, sizeof(uci));
+        ++mStats.moves;
+        ++mStats.engineMoves;
+        serverMetrics().moves.add();
+        serverMetrics().engineLatency.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - reply.queued).count());
+
+        int human = game->players[game->game.getTurn() == Color::White ? 0 : 1];
+        if (human != -1) send(human, "moved " + std::to_string(reply.gameId) + " " + uci + "\n");
+        afterMove(reply.gameId, *game);
+    }
+}
+
+void GameServer::runWorker(std::size_t index) {
+    setTraceThreadName("engine worker");
+    Search & search = *mSearches[index];
+    SearchLimits limits = mOptions.engineLimits;
+    limits.useBook = false;
+    limits.useTablebase = false;
+
+    EngineJob job;
+    while (mJobs.pop(job)) {
+        if (mStopping.load()) continue;
+        SearchResult result = search.think(*job.board, limits, job.history);
+        if (mStopping.load()) continue;
+        if (result.bestMove.from < 0) continue; /* The game was already over */
+
+        {
+            std::lock_guard<std::mutex> lock(mRepliesMutex);
+            mReplies.push_back({job.gameId, job.ply, result.bestMove, job.queued});
+        }
+        std::uint64_t one = 1;
+        ssize_t written = ::write(mWakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
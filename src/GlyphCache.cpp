@@ -0,0 +1,78 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <iostream>
+
+/* Include other defined headers */
+#include "GlyphCache.hpp"
+
+/* Lines kept in the cache. The GUI only draws a few different ones, so it is simply emptied when full */
+static const std::size_t MAX_CACHED_LINES = 256;
+
+GlyphCache::GlyphCache() : mHeight(0) {
+    mAdvance.fill(0);
+    mSprite.fill(-1);
+    mSize.fill({0, 0});
+}
+
+void GlyphCache::clear() {
+    mHeight = 0;
+    mAdvance.fill(0);
+    mSprite.fill(-1);
+    mSize.fill({0, 0});
+    mLines.clear();
+}
+
+/* Every glyph is rendered as a one character string, so it has the height of the font and is placed on the baseline like in a line rendered by SDL_ttf */
+bool GlyphCache::render(TTF_Font * font, std::vector<SDL_Surface *> & images) {
+    clear();
+    if (font == nullptr) return false;
+
+    mHeight = TTF_FontHeight(font);
+    int sprite = static_cast<int>(images.size());
+    for (char glyph = FIRST_GLYPH; glyph <= LAST_GLYPH; ++glyph) {
+        int slot = glyph - FIRST_GLYPH;
+        int minX, maxX, minY, maxY;
+        if (TTF_GlyphMetrics(font, static_cast<Uint16>(glyph), &minX, &maxX, &minY, &maxY, &mAdvance[slot]) != 0) continue;
+        if (glyph == ' ') continue; /* Nothing to draw */
+
+        const char text[2] = {glyph, '\0'};
+        SDL_Surface * image = TTF_RenderText_Blended(font, text, {0xFF, 0xFF, 0xFF, 0xFF});
+        if (image == nullptr) {
+            std::cerr << "Unable to render glyph " << glyph << "! SDL_ttf Error: " << TTF_GetError() << std::endl;
+            continue;
+        }
+        images.push_back(image);
+        mSprite[slot] = sprite++;
+        mSize[slot] = {image->w, image->h};
+    }
+    return true;
+}
+
+const TextLine & GlyphCache::layout(const std::string & text) {
+    auto cached = mLines.find(text);
+    if (cached != mLines.end()) return cached->second;
+
+    if (mLines.size() >= MAX_CACHED_LINES) mLines.clear();
+
+    TextLine line;
+    line.height = mHeight;
+    int x = 0;
+    for (char glyph : text) {
+        if (glyph < FIRST_GLYPH || glyph > LAST_GLYPH) glyph = '?';
+        int slot = glyph - FIRST_GLYPH;
+        if (mSprite[slot] >= 0) {
+            line.glyphs.push_back({mSprite[slot], {x, 0, mSize[slot].x, mSize[slot].y}});
+            line.width = std::max(line.width, x + mSize[slot].x);
+        }
+        x += mAdvance[slot];
+    }
+    line.width = std::max(line.width, x);
+    return mLines.emplace(text, std::move(line)).first->second;
+}
+
+void GlyphCache::draw(SpriteBatch & batch, const std::string & text, float x, float y, SDL_Color color, float scale) {
+    for (const GlyphQuad & glyph : layout(text).glyphs) {
+        SDL_FRect dstRect = {x + glyph.rect.x / scale, y + glyph.rect.y / scale, glyph.rect.w / scale, glyph.rect.h / scale};
+        batch.addF(glyph.sprite, dstRect, color);
+    }
+}
@@ -6,18 +6,23 @@
 #include "SDL_mixer.h"
 #include "SDL_video.h"
 #include "Texture.hpp"
+#include "TextureAtlas.hpp"
 #include "Piece.hpp"
 #include "Pawn.hpp"
 #include "ChessGUI.hpp"
+#include "Trace.hpp"
 
 /* ##### Standard Libraries ##### */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <cassert>
+#include <iterator>
 #include <stdexcept>
+#include <thread>
 
 /* ##### Window properties according to the size of the board ##### */
-const int ROW = 8;
-const int COL = 8;
 int SQUARE_SIZE = 90; /* Suggested: 90 */
 int BORDER_SIZE = 50; /* Suggested: 45 */
 
@@ -38,23 +43,24 @@ const SDL_Color DEFAULT_BKGD_COLOR = {0x16, 0x15, 0x12, 0xFF};
 SDL_Color WHITE_SQUARE;
 SDL_Color BLACK_SQUARE;
 SDL_Color BKGD_COLOR;
-const SDL_Color HIGHLIGHT = {0x7F, 0x17, 0x1F, 0x80};
+const SDL_Color HIGHLIGHT = {0x7F, 0x17, 0x1F, 0xFF}; /* Opaque, as it was always drawn without blending */
 const SDL_Color BOARD_TEXT = {0xFF, 0xFF, 0xFF, 0xFF};
 const SDL_Color STATUS_TEXT = {0xFF, 0xFF, 0xFF, 0xFF};
 
 /* Move Animations */
 int durationMs = 150;
-const int fps = 120;
-
-/* ##### Global Textures ##### */
-std::array<Texture, 7> whitePieces;
-std::array<Texture, 7> blackPieces;
-Texture moveDot;
-Texture kingInCheck;
-Texture capture;
-Texture hoverSquare;
-std::array<Texture, 8> boardLetters;
-std::array<Texture, 8> boardNumbers;
+
+/* ##### Sprites of the Atlas, in the order they are loaded ##### */
+const int SPRITE_WHITE_PIECES = 0; /* Pawn, Knight, Bishop, Rook, Queen, King */
+const int SPRITE_BLACK_PIECES = 6;
+const int SPRITE_MOVE_DOT = 12;
+const int SPRITE_KING_IN_CHECK = 13;
+const int SPRITE_CAPTURE = 14;
+const int SPRITE_HOVER_SQUARE = 15;
+
+static int pieceSprite(Color color, PieceType type) {
+    return (color == Color::White ? SPRITE_WHITE_PIECES : SPRITE_BLACK_PIECES) + static_cast<int>(type) - static_cast<int>(PieceType::Pawn);
+}
 
 /* ##### Sound Effects ##### */
 Mix_Chunk * gameStartSound = nullptr;
@@ -68,21 +74,18 @@ Mix_Chunk * illegalMoveSound = nullptr;
 
 /* Fonts */
 const int boardMarkingsFontSize = 24;
-const int statusFontSize = 56;
-
-TTF_Font * boardFont;
-TTF_Font * statusFont;
 
 /* ##### Static Variables ##### */
 //bool Graphics::instantiated = false;
+static int graphicsInstances = 0; /* The SDL subsystems and sounds are shared, and only freed with the last instance */
 
-/* Graphics Constructor. It initializes all the SDL Subsystems, taking care of the MacBook Pro 14" High DPI Display and also precomputes the mSquares of the board */
-Graphics::Graphics() {
+/* Graphics Constructor. It initializes all the SDL Subsystems, taking care of the MacBook Pro 14" High DPI Display and also precomputes the mSquares of the board. In Offscreen mode there is no window nor audio: a software renderer draws on a surface of the window size, so it runs without a display and each thread can have its own instance */
+Graphics::Graphics(RenderMode mode) : mMode(mode), mWindow(nullptr), mRenderer(nullptr), mSurface(nullptr), mSprites(mAtlas) {
     
     //assert(!instantiated && "More than one instance of the Class Graphics is not allowed!");
     //instantiated = true;
 
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    if (SDL_Init(mMode == RenderMode::Window ? SDL_INIT_VIDEO : 0) < 0) {
         std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError(); // Implement error handling
         throw std::runtime_error(std::string("SDL could not initialize! SDL Error: ") + SDL_GetError());
     }
@@ -96,31 +99,12 @@ Graphics::Graphics() {
     SDL_SetHint(SDL_HINT_IME_SHOW_UI, "1");
     #endif
 
-    /* Create WINDOW */
-    mWindow = SDL_CreateWindow("CPPChess", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WIN_WIDTH, WIN_HEIGHT, SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI);
-    
-    if (mWindow == nullptr) {
-        std::cerr << "Window could not be created! SDL Error: " << SDL_GetError(); // Implement error handling
-        SDL_Quit();
-        throw std::runtime_error(std::string("SDL Window could not be created! SDL Error: ") + SDL_GetError());
+    if (mMode == RenderMode::Window) {
+        createWindow();
+    } else {
+        createOffscreen();
     }
 
-    /* Get Retina Scaling Factors - HIGH DPI Macbook Screen - Scale of 2.0 */
-    SDL_GL_GetDrawableSize(mWindow, &physW, &physH);
-    scaleX = physW / static_cast<float>(WIN_WIDTH); // logical width
-    scaleY = physH / static_cast <float> (WIN_HEIGHT);  // logical height
-
-    /* Create RENDERER for the Window*/
-    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    SDL_RenderSetIntegerScale(mRenderer, SDL_TRUE);
-    if(mRenderer == nullptr) {
-        std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError();
-        SDL_Quit();
-        throw std::runtime_error(std::string("SDL Renderer could not be created! SDL Error: ") + SDL_GetError());
-    }
-    SDL_RenderSetScale(mRenderer, scaleX, scaleY);
-    SDL_SetRenderDrawColor(mRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-
     /* Initialize PNG Loading */
     int imgFlags = IMG_INIT_PNG;
     if(!(IMG_Init(imgFlags) & imgFlags)) {
@@ -129,7 +113,7 @@ Graphics::Graphics() {
     }
 
     /* Initialize SDL_Mixer */
-    if(Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 2048 ) < 0) {
+    if(mMode == RenderMode::Window && Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 2048 ) < 0) {
         std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
         throw std::runtime_error(std::string("SDL_Mixer could not initialize! SDL_Mixer Error: ") + Mix_GetError());
     }
@@ -165,16 +149,85 @@ Graphics::Graphics() {
 
     /* Initialise ChessGUI pointer to null */ 
     mGuiPtr = nullptr;
+    ++graphicsInstances;
+
+    /* The scene is created on the first render */
+    mSceneTexture = nullptr;
+    mSceneColors = {WHITE_SQUARE, BLACK_SQUARE, BKGD_COLOR};
+    mSceneFlipped = false;
+    mSceneMarkings = true;
+    mSceneWidth = 0;
+    mSceneHeight = 0;
+    invalidateScene();
     
 }
 
+/* Creates the window and its renderer, with vsync */
+void Graphics::createWindow() {
+    /* Create WINDOW */
+    mWindow = SDL_CreateWindow("CPPChess", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WIN_WIDTH, WIN_HEIGHT, SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI);
+    
+    if (mWindow == nullptr) {
+        std::cerr << "Window could not be created! SDL Error: " << SDL_GetError(); // Implement error handling
+        SDL_Quit();
+        throw std::runtime_error(std::string("SDL Window could not be created! SDL Error: ") + SDL_GetError());
+    }
+
+    /* Get Retina Scaling Factors - HIGH DPI Macbook Screen - Scale of 2.0 */
+    SDL_GL_GetDrawableSize(mWindow, &physW, &physH);
+    scaleX = physW / static_cast<float>(WIN_WIDTH); // logical width
+    scaleY = physH / static_cast <float> (WIN_HEIGHT);  // logical height
+
+    /* Create RENDERER for the Window*/
+    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    SDL_RenderSetIntegerScale(mRenderer, SDL_TRUE);
+    if(mRenderer == nullptr) {
+        std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError();
+        SDL_Quit();
+        throw std::runtime_error(std::string("SDL Renderer could not be created! SDL Error: ") + SDL_GetError());
+    }
+    SDL_RenderSetScale(mRenderer, scaleX, scaleY);
+    SDL_SetRenderDrawColor(mRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+}
+
+/* Creates a software renderer drawing on a surface of the window size, without scaling */
+void Graphics::createOffscreen() {
+    mSurface = SDL_CreateRGBSurfaceWithFormat(0, WIN_WIDTH, WIN_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    if (mSurface == nullptr)
+        throw std::runtime_error(std::string("SDL Surface could not be created! SDL Error: ") + SDL_GetError());
+
+    mRenderer = SDL_CreateSoftwareRenderer(mSurface);
+    if (mRenderer == nullptr) {
+        SDL_FreeSurface(mSurface);
+        mSurface = nullptr;
+        throw std::runtime_error(std::string("SDL Software Renderer could not be created! SDL Error: ") + SDL_GetError());
+    }
+
+    physW = WIN_WIDTH;
+    physH = WIN_HEIGHT;
+    scaleX = 1.0f;
+    scaleY = 1.0f;
+    SDL_SetRenderDrawColor(mRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+}
+
 /* Graphics class destructor. It deallocates all SDL subsystem textures, chunks and windows, then quits the subsystems */
 Graphics::~Graphics() {
+	/* Destroy the textures before their renderer */
+	if (mSceneTexture != nullptr)
+	    SDL_DestroyTexture(mSceneTexture);
+	mAtlas.free();
+
 	//Destroy window	
 	if (mWindow != nullptr)
 	    SDL_DestroyWindow(mWindow);
     if (mRenderer != nullptr)    
         SDL_DestroyRenderer(mRenderer);
+    if (mSurface != nullptr)
+        SDL_FreeSurface(mSurface);
+
+    /* The sounds and subsystems are shared by the instances */
+    if (--graphicsInstances > 0)
+        return;
 
     /* Free Sound Effects */
     Mix_FreeChunk(gameStartSound);
@@ -208,168 +261,144 @@ Graphics::~Graphics() {
     TTF_Quit();
 }
 
+/* ##### Assets ##### */
+/* Bundle packed by the build (cppchess-pack), next to the executable */
+const char * ASSET_BUNDLE_NAME = "cppchess-assets.bin";
+
+/* The order of the images is the order of the sprites (SPRITE_WHITE_PIECES...) */
+static const char * const SPRITE_ASSETS[] = {
+    "pieces/default/white/WhitePawn.png",
+    "pieces/default/white/WhiteKnight.png",
+    "pieces/default/white/WhiteBishop.png",
+    "pieces/default/white/WhiteRook.png",
+    "pieces/default/white/WhiteQueen.png",
+    "pieces/default/white/WhiteKing.png",
+    "pieces/default/black/BlackPawn.png",
+    "pieces/default/black/BlackKnight.png",
+    "pieces/default/black/BlackBishop.png",
+    "pieces/default/black/BlackRook.png",
+    "pieces/default/black/BlackQueen.png",
+    "pieces/default/black/BlackKing.png",
+    "MoveDot.png",
+    "KingInCheck.png",
+    "Capture.png",
+    "HoverSquare.png",
+};
+
+/* Sound effects and the global each one is loaded into */
+static const char * const SOUND_ASSETS[] = {
+    "sounds/game-start.wav",
+    "sounds/game-end.wav",
+    "sounds/capture.wav",
+    "sounds/castle.wav",
+    "sounds/move.wav",
+    "sounds/move-check.wav",
+    "sounds/promote.wav",
+    "sounds/illegal.wav",
+};
+static Mix_Chunk ** const SOUND_EFFECTS[] = {&gameStartSound, &gameEndSound, &captureSound, &castleSound, &moveSound, &moveCheckSound, &promoteSound, &illegalMoveSound};
+
+static const char * const FONT_ASSET = "fonts/Fira_Sans/FiraSans-Medium.ttf";
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* Reads an asset from the mapped bundle, without copying it. Returns nullptr if there is no such asset, which the SDL loaders report as an error */
+SDL_RWops * Graphics::openAsset(const char * name) const {
+    std::size_t size = 0;
+    const char * data = mAssets.find(name, size);
+    return data ? SDL_RWFromConstMem(data, static_cast<int>(size)) : nullptr;
+}
+
 /* Source of the Files: 
 Pieces: https://commons.wikimedia.org/wiki/Category:SVG_chess_pieces 
 Sounds: https://www.chess.com/forum/view/general/chessboard-sound-files?page=2
 Font: Fira Sans, from Google Fonts
-*/
+
+The assets come from the bundle, which is memory mapped. The images and sounds are decoded in parallel by worker threads, then the textures are created on this thread, which owns the renderer. The time of each phase is logged */
 bool Graphics::loadMedia() {
+    TRACE_ZONE("graphics", "loadMedia");
     bool success = true;
-    
-    /* ##### White Pieces ##### */
-    /* loadTexture returns true if it is successful, false otherwise. So if it is not true, it means it failed */
-
-    if(!whitePieces[static_cast<int>(PieceType::Pawn)].loadTexture("../assets/pieces/default/white/WhitePawn.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!whitePieces[static_cast<int>(PieceType::Knight)].loadTexture("../assets/pieces/default/white/WhiteKnight.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!whitePieces[static_cast<int>(PieceType::Bishop)].loadTexture("../assets/pieces/default/white/WhiteBishop.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!whitePieces[static_cast<int>(PieceType::Rook)].loadTexture("../assets/pieces/default/white/WhiteRook.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!whitePieces[static_cast<int>(PieceType::Queen)].loadTexture("../assets/pieces/default/white/WhiteQueen.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!whitePieces[static_cast<int>(PieceType::King)].loadTexture("../assets/pieces/default/white/WhiteKing.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    
-    /* ##### Black Pieces ##### */
-    if(!blackPieces[static_cast<int>(PieceType::Pawn)].loadTexture("../assets/pieces/default/black/BlackPawn.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!blackPieces[static_cast<int>(PieceType::Knight)].loadTexture("../assets/pieces/default/black/BlackKnight.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!blackPieces[static_cast<int>(PieceType::Bishop)].loadTexture("../assets/pieces/default/black/BlackBishop.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!blackPieces[static_cast<int>(PieceType::Rook)].loadTexture("../assets/pieces/default/black/BlackRook.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!blackPieces[static_cast<int>(PieceType::Queen)].loadTexture("../assets/pieces/default/black/BlackQueen.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-    if(!blackPieces[static_cast<int>(PieceType::King)].loadTexture("../assets/pieces/default/black/BlackKing.png", mRenderer)) {
-        std::cerr << "Failed to load texture! " << std::endl;
-        success = false;
-    }
-
-    /* ##### Move Dot ##### */
-    if(!moveDot.loadTexture("../assets/MoveDot.png", mRenderer)) {
-        std::cerr << "Failed to load texture!" << std::endl;
-        success = false;
-    }
-
-    /* ##### King in Check Highlight ##### */
-    if(!kingInCheck.loadTexture("../assets/KingInCheck.png", mRenderer)) {
-        std::cerr << "Failed to load texture!" << std::endl;
-        success = false;
-    }
-
-    /* ##### Capture a Piece Highlight ##### */
-    if(!capture.loadTexture("../assets/Capture.png", mRenderer)) {
-        std::cerr << "Failed to load texture!" << std::endl;
-        success = false;
-    }
-
-    /* ##### Square that appears when the mouse is hovering */
-    if(!hoverSquare.loadTexture("../assets/HoverSquare.png", mRenderer)) {
-        std::cerr << "Failed to load texture!" << std::endl;
-        success = false;
-    }
-
-    /* ##### LOAD SOUND EFFECTS */
-    gameStartSound = Mix_LoadWAV("../assets/sounds/game-start.wav");
-    if(gameStartSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    gameEndSound = Mix_LoadWAV("../assets/sounds/game-end.wav");
-    if(gameEndSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    captureSound = Mix_LoadWAV("../assets/sounds/capture.wav");
-    if(captureSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    castleSound = Mix_LoadWAV("../assets/sounds/castle.wav");
-    if(castleSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    moveSound = Mix_LoadWAV("../assets/sounds/move.wav");
-    if(moveSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    moveCheckSound = Mix_LoadWAV("../assets/sounds/move-check.wav");
-    if(moveCheckSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    promoteSound = Mix_LoadWAV("../assets/sounds/promote.wav");
-    if(promoteSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
-    }
-
-    illegalMoveSound = Mix_LoadWAV("../assets/sounds/illegal.wav");
-    if(illegalMoveSound == nullptr) {
-        std::cerr << "Failure to load sound effect! " << Mix_GetError() << std::endl;
-        success = false;
+    auto start = std::chrono::steady_clock::now();
+
+    /* The bundle is next to the executable, so the game runs from any working directory */
+    std::string bundlePath = ASSET_BUNDLE_NAME;
+    if (char * basePath = SDL_GetBasePath()) {
+        bundlePath = std::string(basePath) + ASSET_BUNDLE_NAME;
+        SDL_free(basePath);
+    }
+    if (!mAssets.open(bundlePath)) {
+        std::cerr << "Failure to open the asset bundle " << bundlePath << std::endl;
+        throw std::runtime_error("Game resources could not be open");
+    }
+    double openMs = millisecondsSince(start);
+
+    /* ##### Decoding, every asset to its own slot. Sounds only with a window ##### */
+    auto decodeStart = std::chrono::steady_clock::now();
+    const int imageCount = static_cast<int>(std::size(SPRITE_ASSETS));
+    const int soundCount = mMode == RenderMode::Window ? static_cast<int>(std::size(SOUND_ASSETS)) : 0;
+    std::vector<SDL_Surface *> images(imageCount, nullptr);
+    std::vector<Mix_Chunk *> sounds(soundCount, nullptr);
+
+    std::atomic<int> next(0);
+    auto decode = [&] {
+        for (int job = next++; job < imageCount + soundCount; job = next++) {
+            if (job < imageCount)
+                images[job] = IMG_Load_RW(openAsset(SPRITE_ASSETS[job]), 1);
+            else
+                sounds[job - imageCount] = Mix_LoadWAV_RW(openAsset(SOUND_ASSETS[job - imageCount]), 1);
+        }
+    };
+
+    /* This thread decodes too */
+    unsigned threads = std::clamp(std::thread::hardware_concurrency(), 1u, static_cast<unsigned>(imageCount + soundCount));
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back(decode);
+    decode();
+    for (std::thread & thread : pool)
+        thread.join();
+    double decodeMs = millisecondsSince(decodeStart);
+
+    /* ##### Textures, Sounds and Fonts ##### */
+    auto uploadStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < imageCount; ++i) {
+        if (images[i] == nullptr) {
+            std::cerr << "Failed to load texture " << SPRITE_ASSETS[i] << "!" << std::endl;
+            success = false;
+        }
     }
 
-    /* Load Necessary Fonts */
-    int scaledFontSize = boardMarkingsFontSize * scaleY;
-    boardFont = TTF_OpenFont("../assets/fonts/Fira_Sans/FiraSans-Medium.ttf", scaledFontSize);
+    /* The glyphs of the markings and status text are packed with the sprites, so the text is drawn in the same batches. The font is only needed to render them */
+    TTF_Font * boardFont = TTF_OpenFontRW(openAsset(FONT_ASSET), 1, boardMarkingsFontSize * scaleY);
     if (boardFont == nullptr) {
         std::cerr << "Failure to load boardFont! SDL_ttf Error: " << TTF_GetError() << std::endl;
         success = false;
+    } else {
+        mBoardText.render(boardFont, images);
+        TTF_CloseFont(boardFont);
     }
 
-    scaledFontSize = statusFontSize * scaleY;
-    statusFont = TTF_OpenFont("../assets/fonts/Fira_Sans/FiraSans-Medium.ttf", scaledFontSize);
-    if (statusFont == nullptr) {
-        std::cerr << "Failure to load boardFont! SDL_ttf Error: " << TTF_GetError() << std::endl;
+    /* Pieces, Markings and Glyphs, packed in one texture */
+    if (success && !mAtlas.build(images, mRenderer)) {
+        std::cerr << "Failed to load texture atlas! " << std::endl;
         success = false;
     }
+    for (SDL_Surface * image : images)
+        SDL_FreeSurface(image);
 
-    /* Create the Board Letters and Numbers */
-    for (int i = 0; i < ROW; ++i) {
-        char fileChar = 'a' + i;
-        std::string fileStr(1, fileChar);
-        boardLetters[i].loadFromRenderedText(mRenderer, boardFont, fileStr, BOARD_TEXT);
+    for (int i = 0; i < soundCount; ++i) {
+        if (sounds[i] == nullptr) {
+            std::cerr << "Failure to load sound effect " << SOUND_ASSETS[i] << "!" << std::endl;
+            success = false;
+        }
+        Mix_FreeChunk(*SOUND_EFFECTS[i]);
+        *SOUND_EFFECTS[i] = sounds[i];
     }
+    double uploadMs = millisecondsSince(uploadStart);
 
-    for (int i = 0; i < ROW; ++i) {
-        char fileChar = '1' + i;
-        std::string ranksStr(1, fileChar);
-        boardNumbers[i].loadFromRenderedText(mRenderer, boardFont, ranksStr, BOARD_TEXT);
-    }
+    std::cout << "[Startup] Assets loaded in " << millisecondsSince(start) << " ms: bundle " << openMs << " ms, decoding " << decodeMs << " ms on " << threads << " threads, glyphs and textures " << uploadMs << " ms" << std::endl;
 
     if (success)
         return true;
@@ -385,9 +414,25 @@ void Graphics::clearWindow() {
 
 /* Updates the Window */
 void Graphics::updateWindow() {
+    TRACE_ZONE("graphics", "updateWindow");
+    flushSprites();
     SDL_RenderPresent(mRenderer);
 }
 
+/* Draws the sprites queued since the last flush, in a single call. Anything drawn without the batch (text, the GUI) must come after a flush to stay on top */
+void Graphics::flushSprites() {
+    TRACE_ZONE("graphics", "flushSprites");
+    mSprites.flush(mRenderer);
+}
+
+/* Both textures have 4 bytes per pixel */
+std::size_t Graphics::getTextureMemory() const {
+    std::size_t bytes = static_cast<std::size_t>(mAtlas.getWidth()) * mAtlas.getHeight() * 4;
+    if (mSceneTexture != nullptr)
+        bytes += static_cast<std::size_t>(mSceneWidth) * mSceneHeight * 4;
+    return bytes;
+}
+
 /* Renders a board square with the correct color, according to the row and column */
 void Graphics::renderBoardSquare(int col, int row) {
     if (col < 0 || row < 0 || col >= COL || row >= ROW) return;   
@@ -395,40 +440,28 @@ void Graphics::renderBoardSquare(int col, int row) {
     int index = Board::squareToIndex(row, col);
     const SDL_Rect& fillRect = mSquares[index];
 
-    if ((row + col) % 2 != 0) {
-        SDL_SetRenderDrawColor(mRenderer, WHITE_SQUARE.r, WHITE_SQUARE.g, WHITE_SQUARE.b, WHITE_SQUARE.a);
-    } else {
-        SDL_SetRenderDrawColor(mRenderer, BLACK_SQUARE.r, BLACK_SQUARE.g, BLACK_SQUARE.b, BLACK_SQUARE.a);
-    }
-
-    SDL_RenderFillRect(mRenderer, &fillRect);
+    mSprites.addRect(fillRect, (row + col) % 2 != 0 ? WHITE_SQUARE : BLACK_SQUARE);
 }
 
-/* Renders the letters and numbers on the side of the board, which is used for notation */
+/* Renders the letters and numbers on the side of the board, which is used for notation. They are glyphs of the atlas, added to the sprite batch */
 void Graphics::renderMarkings() {
+    float letterOffset = mBoardText.getWidth("f")/(2*scaleX); /* Space below the board, as when the letters were textures */
 
-    if(!isBoardFlipped) {
+    for (int i = 0; i < COL; ++i) {
         /* File Markings */
-        for (int i = 0; i < COL; ++i) {
-            boardLetters[i].renderText(mRenderer, BOTTOM_BORDER_SIZE - 1 + (SQUARE_SIZE * i) + (static_cast<int>(SQUARE_SIZE/2) - boardLetters[i].getWidth()/(2*scaleX)), WIN_HEIGHT - BOTTOM_BORDER_SIZE + boardLetters[5].getWidth()/(2*scaleX), scaleY);
-        }
-        /* Row Markings */
-        for (int i = 0; i < ROW; ++i) {
-            boardNumbers[ROW - 1 - i].renderText(mRenderer, static_cast<int>(BORDER_SIZE/2) - boardNumbers[i].getWidth()/(2*scaleX), BORDER_SIZE - 1 + (SQUARE_SIZE * i) + (static_cast<int>(SQUARE_SIZE/2) - boardNumbers[i].getHeight()/(2*scaleY)), scaleY);
-        }
-    } else { /* Flipped Markings*/
+        std::string letter(1, static_cast<char>('a' + (isBoardFlipped ? COL - 1 - i : i)));
+        float x = BOTTOM_BORDER_SIZE - 1 + (SQUARE_SIZE * i) + (static_cast<int>(SQUARE_SIZE/2) - mBoardText.getWidth(letter)/(2*scaleX));
+        float y = (isBoardFlipped ? WIN_HEIGHT - BORDER_SIZE : WIN_HEIGHT - BOTTOM_BORDER_SIZE) + letterOffset;
+        mBoardText.draw(mSprites, letter, x, y, BOARD_TEXT, scaleY);
+    }
 
-        for (int i = 0; i < COL; ++i) {
-            boardLetters[COL - 1 - i].renderText(mRenderer, BOTTOM_BORDER_SIZE - 1 + (SQUARE_SIZE * i) + (static_cast<int>(SQUARE_SIZE/2) - boardLetters[i].getWidth()/(2*scaleX)), WIN_HEIGHT - BORDER_SIZE + boardLetters[5].getWidth()/(2*scaleX), scaleY);
-        }
+    for (int i = 0; i < ROW; ++i) {
         /* Row Markings */
-        for (int i = 0; i < ROW; ++i) {
-            boardNumbers[i].renderText(mRenderer, static_cast<int>(BORDER_SIZE/2) - boardNumbers[i].getWidth()/(2*scaleX), BORDER_SIZE - 1 + (SQUARE_SIZE * i) + (static_cast<int>(SQUARE_SIZE/2) - boardNumbers[i].getHeight()/(2*scaleY)), scaleY);
-        }
-
-
+        std::string number(1, static_cast<char>('1' + (isBoardFlipped ? i : ROW - 1 - i)));
+        float x = static_cast<int>(BORDER_SIZE/2) - mBoardText.getWidth(number)/(2*scaleX);
+        float y = BORDER_SIZE - 1 + (SQUARE_SIZE * i) + (static_cast<int>(SQUARE_SIZE/2) - mBoardText.getHeight()/(2*scaleY));
+        mBoardText.draw(mSprites, number, x, y, BOARD_TEXT, scaleY);
     }
-    
 }
 
 /* Renders the full board together with the markings */
@@ -443,6 +476,7 @@ void Graphics::renderBoard() {
         
 	}
     if (showMarkings) renderMarkings();
+    flushSprites();
 }
 
 /* Renders a piece placed in the board, in the position provided by index */
@@ -454,32 +488,26 @@ void Graphics::renderPiece(const Board & board, int index) {
     Color color;
 	PieceType piece;
 
-    if(board.board[index] != nullptr) {
+    if(board.board[index] != nullptr && !isAnimatedSquare(index)) {
         color = board.board[index]->getColor();
         piece = board.board[index]->getType();
-        int pieceID = static_cast<int>(piece);
 
         const SDL_Rect& dstRect = mSquares[index];
 
         if(piece == PieceType::King) {
             King * king = static_cast<King *>(board.board[index]);
             if (king->isChecked()) {
-                kingInCheck.renderTexture(mRenderer, dstRect.x, dstRect.y);
+                mSprites.add(SPRITE_KING_IN_CHECK, dstRect);
             }
         }
         
-        if (color == Color::White)
-            whitePieces[pieceID].renderTexture(mRenderer, dstRect.x, dstRect.y);
-        
-        if (color == Color::Black)
-            blackPieces[pieceID].renderTexture(mRenderer, dstRect.x, dstRect.y);
+        mSprites.add(pieceSprite(color, piece), dstRect);
     }
 }
 
 /* Renders the marking which represents the King in check */
 void Graphics::renderKingInCheck(int index) {
-    const SDL_Rect dstRect = mSquares[index];
-    kingInCheck.renderTexture(mRenderer, dstRect.x, dstRect.y);
+    mSprites.add(SPRITE_KING_IN_CHECK, mSquares[index]);
     
 }
 
@@ -492,22 +520,17 @@ void Graphics::renderPieces(const Board & board) {
 
 /* Highlights a square according to the index */
 void Graphics::highlightSquare(int index) {
-    //SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(mRenderer, HIGHLIGHT.r, HIGHLIGHT.g, HIGHLIGHT.b, HIGHLIGHT.a);
-	SDL_RenderFillRect(mRenderer, &mSquares[index]);
-    //SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    mSprites.addRect(mSquares[index], HIGHLIGHT);
 }
 
 /* Places a dot in the provided index */
 void Graphics::highlightMove(int index) {
-    const SDL_Rect dstRect = mSquares[index];
-    moveDot.renderTexture(mRenderer, dstRect.x, dstRect.y);
+    mSprites.add(SPRITE_MOVE_DOT, mSquares[index]);
 }
 
 /* Places a marking of capture on the specified index */
 void Graphics::highlightCapture(int index) {
-    const SDL_Rect dstRect = mSquares[index];
-    capture.renderTexture(mRenderer, dstRect.x, dstRect.y);
+    mSprites.add(SPRITE_CAPTURE, mSquares[index]);
 }
 
 /* Highlights the possible moves of a piece in the board, according to the given index. The possible moves are generated by the respective pieces. Check the class Board methods to find more information about the Move Generation mechanism */
@@ -528,21 +551,112 @@ void Graphics::highlightPossibleMoves(const Board & board, int index) {
 
 /* Selects a piece in board according to the index, which means highlighting it and showing all possible moves. It calls the methods defined in Graphics, in a sequential form, to allow a layering. SDL does not provide a layering system, which requires to manually create layers by rendering in order */
 void Graphics::selectPiece(const Board & board, int index) {
-    //clearWindow();
-	renderBoard();
-	highlightSquare(index);
-	renderPieces(board);
+    renderScene(board, 1ULL << index);
     highlightPossibleMoves(board, index);
-	//updateWindow();
 }
 
 /* Renders the full board with all the pieces according to the placement in a Board class */
 void Graphics::renderBoardWithPieces(const Board & board) {
-    //clearWindow();
-    renderBoard();
-    highlightAttacks(board); // New
-	renderPieces(board);
-	//updateWindow();
+    /* Attacked squares are highlighted under the pieces */
+    std::uint64_t highlights = 0;
+    for (int i = 0; i < 64; ++i) {
+        if ((whiteAttack && board.whiteAttackBoard[i]) || (blackAttack && board.blackAttackBoard[i]))
+            highlights |= 1ULL << i;
+    }
+    renderScene(board, highlights);
+}
+
+/* Content of a square of the scene: the piece on it, the King in check marking and the highlight. A square is only drawn again if it changes */
+int Graphics::sceneKey(const Board & board, int index, std::uint64_t highlights) const {
+    int key = (highlights >> index) & 1;
+    const Piece * piece = board.board[index];
+    if (piece != nullptr && !isAnimatedSquare(index)) {
+        key |= (static_cast<int>(piece->getType()) << 1) | (piece->getColor() == Color::Black ? 16 : 0);
+        if (piece->getType() == PieceType::King && static_cast<const King *>(piece)->isChecked())
+            key |= 32;
+    }
+    return key;
+}
+
+/* Creates the scene texture for the current size of the renderer, and draws the board on it if any of its properties changed. Returns false if the renderer does not support render targets */
+bool Graphics::updateSceneTexture() {
+    TRACE_ZONE("graphics", "updateSceneTexture");
+    int width, height;
+    if (SDL_GetRendererOutputSize(mRenderer, &width, &height) != 0)
+        return false;
+
+    if (mSceneTexture == nullptr || width != mSceneWidth || height != mSceneHeight) {
+        if (mSceneTexture != nullptr)
+            SDL_DestroyTexture(mSceneTexture);
+        mSceneTexture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (mSceneTexture == nullptr)
+            return false;
+        SDL_SetTextureBlendMode(mSceneTexture, SDL_BLENDMODE_NONE);
+        mSceneWidth = width;
+        mSceneHeight = height;
+        invalidateScene();
+    }
+
+    const std::array<SDL_Color, 3> colors = {WHITE_SQUARE, BLACK_SQUARE, BKGD_COLOR};
+    bool sameColors = std::equal(colors.begin(), colors.end(), mSceneColors.begin(), [](const SDL_Color & a, const SDL_Color & b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    });
+
+    if (!sameColors || mSceneFlipped != isBoardFlipped || mSceneMarkings != showMarkings || mSceneKeys[0] < 0) {
+        mSceneColors = colors;
+        mSceneFlipped = isBoardFlipped;
+        mSceneMarkings = showMarkings;
+
+        /* The target has its own scale, so the board is drawn with the same logical coordinates */
+        flushSprites();
+        SDL_SetRenderTarget(mRenderer, mSceneTexture);
+        SDL_RenderSetScale(mRenderer, scaleX, scaleY);
+        renderBoard();
+        SDL_SetRenderTarget(mRenderer, nullptr);
+        mSceneKeys.fill(0); /* Every square holds an empty square now */
+    }
+    return true;
+}
+
+/* Marks the whole scene to be drawn again, e.g. after the render targets were lost */
+void Graphics::invalidateScene() {
+    mSceneKeys.fill(-1);
+}
+
+/* Renders the board and its pieces through the retained scene, where only the squares which changed since the last frame are drawn again. The squares set in highlights are highlighted under their piece. Without render targets, everything is drawn every frame */
+void Graphics::renderScene(const Board & board, std::uint64_t highlights) {
+    TRACE_ZONE("graphics", "renderScene");
+    if (!updateSceneTexture()) {
+        renderBoard();
+        for (int i = 0; i < 64; ++i) {
+            if ((highlights >> i) & 1) highlightSquare(i);
+        }
+        renderPieces(board);
+        return;
+    }
+
+    bool targetSet = false;
+    for (int i = 0; i < 64; ++i) {
+        int key = sceneKey(board, i, highlights);
+        if (key == mSceneKeys[i]) continue;
+
+        if (!targetSet) {
+            flushSprites();
+            SDL_SetRenderTarget(mRenderer, mSceneTexture);
+            SDL_RenderSetScale(mRenderer, scaleX, scaleY);
+            targetSet = true;
+        }
+        renderBoardSquare(Board::indexToColumn(i), Board::indexToRow(i));
+        if (key & 1) highlightSquare(i);
+        renderPiece(board, i);
+        mSceneKeys[i] = key;
+    }
+    if (targetSet) {
+        flushSprites(); /* All the squares which changed, in one batch */
+        SDL_SetRenderTarget(mRenderer, nullptr);
+    }
+
+    SDL_RenderCopy(mRenderer, mSceneTexture, nullptr, nullptr);
 }
 
 /* Renders a white marking on the square which is the piece is currently hovering */
@@ -558,7 +672,7 @@ void Graphics::renderHoverSquare(int mouseX, int mouseY) {
     }
 
     if (hoverCol > -1 && hoverRow > -1)
-        hoverSquare.renderTexture(mRenderer, LEFT_BORDER_SIZE - 1 + SQUARE_SIZE * hoverCol, TOP_BORDER_SIZE - 1 + SQUARE_SIZE * hoverRow);
+        mSprites.add(SPRITE_HOVER_SQUARE, {LEFT_BORDER_SIZE - 1 + SQUARE_SIZE * hoverCol, TOP_BORDER_SIZE - 1 + SQUARE_SIZE * hoverRow, SQUARE_SIZE, SQUARE_SIZE});
 }
 
 
@@ -572,86 +686,131 @@ void Graphics::renderDraggedPiece(const Board & board, int index, int mouseX, in
 	PieceType piece;
     color = board.board[index]->getColor();
 	piece = board.board[index]->getType();
-    int pieceID = static_cast<int>(piece);
 
-    //clearWindow();
-	renderBoard();
+    renderScene(board, 1ULL << index);
     renderHoverSquare(mouseX, mouseY);
-	renderPieces(board);
-    highlightSquare(index);
     highlightPossibleMoves(board, index);
-
-    if (color == Color::White)
-		whitePieces[pieceID].renderTexture(mRenderer, mouseX - SQUARE_SIZE/2, mouseY - SQUARE_SIZE/2);
-			
-	if (color == Color::Black)
-		blackPieces[pieceID].renderTexture(mRenderer, mouseX - SQUARE_SIZE/2, mouseY - SQUARE_SIZE/2);
+    renderPieceTexture(color, piece, mouseX - SQUARE_SIZE/2, mouseY - SQUARE_SIZE/2);
 
     //updateWindow();
 }
 
-/* Renders a piece moving from the origin index to the destination index. It is called only if the user executed a move by pressing in a valid move square. I used the help of DeepSeek, which gave me the idea of using linear interpolation. It renders according to the given frames per seconds. As the screen of my computer is 120Hz, I set it up to render at 120fps */
-void Graphics::animatePieceMoving(const Board & board, int fromIndex, int toIndex) {
-    int fromCol = Board::indexToColumn(fromIndex);
-    int fromRow = Board::indexToRow(fromIndex);
+/* Starts the animation of a move, before it is played on the board. The piece slides to its destination (unless it was dropped there, when slide is false), the Rook slides along with a castling King and a captured piece fades out. Nothing is rendered here: the main loop advances the animations with updateAnimations and draws them with renderAnimations every frame, so events keep being handled while they run. The original version used linear interpolation in a blocking loop, an idea given by DeepSeek */
+void Graphics::animatePieceMoving(const Board & board, int fromIndex, int toIndex, bool slide) {
+    Piece * movingPiece = board.board[fromIndex];
+    if (!movingPiece || durationMs <= 0) return;
+
+    /* A piece moved again before its animation ended simply stops animating */
+    mTweens.erase(std::remove_if(mTweens.begin(), mTweens.end(), [&](const PieceTween & tween) {
+        return tween.toIndex == fromIndex || tween.toIndex == toIndex;
+    }), mTweens.end());
+
+    /* Captured piece, which is beside the destination for en passant */
+    int capturedIndex = toIndex;
+    if (movingPiece->getType() == PieceType::Pawn && toIndex == board.getEnPassantIndex())
+        capturedIndex = Board::squareToIndex(Board::indexToRow(fromIndex), Board::indexToColumn(toIndex));
+    if (board.board[capturedIndex] != nullptr)
+        addTween(board, capturedIndex, capturedIndex, true);
+
+    if (slide)
+        addTween(board, fromIndex, toIndex, false);
+
+    /* Castling, the Rook jumps over the King */
+    if (movingPiece->getType() == PieceType::King && abs(toIndex - fromIndex) == 2) {
+        bool kingSide = toIndex > fromIndex;
+        int rookFrom = Board::squareToIndex(Board::indexToRow(fromIndex), kingSide ? COL - 1 : 0);
+        int rookTo = kingSide ? toIndex - 1 : toIndex + 1;
+        addTween(board, rookFrom, rookTo, false);
+    }
+}
 
-    int startX = mSquares[fromIndex].x;
-    int startY = mSquares[fromIndex].y;
-    int endX = mSquares[toIndex].x;
-    int endY = mSquares[toIndex].y;
+/* Adds the animation of the piece on fromIndex */
+void Graphics::addTween(const Board & board, int fromIndex, int toIndex, bool fade) {
+    const Piece * piece = board.board[fromIndex];
+    if (!piece) return;
+    mTweens.push_back({piece->getColor(), piece->getType(), fromIndex, toIndex, 0.0f, durationMs / 1000.0f, fade});
+}
 
-    Piece* movingPiece = board.board[fromIndex];
-    if (!movingPiece) return;
+/* Advances the animations by the real time elapsed since the last frame, and removes the finished ones */
+void Graphics::updateAnimations(float seconds) {
+    for (PieceTween & tween : mTweens)
+        tween.elapsed += seconds;
 
-    const int frameDelay = 1000 / fps;
-    const int totalFrames = durationMs / frameDelay;
+    mTweens.erase(std::remove_if(mTweens.begin(), mTweens.end(), [](const PieceTween & tween) {
+        return tween.elapsed >= tween.duration;
+    }), mTweens.end());
+}
 
-    for (int frame = 0; frame <= totalFrames; ++frame) {
-        float t = static_cast<float>(frame) / totalFrames;
-        int currentX = static_cast<int>(startX + (endX - startX) * t);
-        int currentY = static_cast<int>(startY + (endY - startY) * t);
+/* Renders the animated pieces on top of the board. The fading pieces go first, so the piece capturing them passes over them */
+void Graphics::renderAnimations() {
+    TRACE_ZONE("graphics", "renderAnimations");
+    for (const PieceTween & tween : mTweens) {
+        if (!tween.fade) continue;
+        float t = std::min(tween.elapsed / tween.duration, 1.0f);
+        const SDL_Rect & square = mSquares[tween.fromIndex];
+        renderPieceTexture(tween.color, tween.type, square.x, square.y, static_cast<Uint8>(0xFF * (1.0f - t)));
+    }
+
+    for (const PieceTween & tween : mTweens) {
+        if (tween.fade) continue;
+        float t = std::min(tween.elapsed / tween.duration, 1.0f);
+        const SDL_Rect & start = mSquares[tween.fromIndex];
+        const SDL_Rect & end = mSquares[tween.toIndex];
+        int currentX = static_cast<int>(start.x + (end.x - start.x) * t);
+        int currentY = static_cast<int>(start.y + (end.y - start.y) * t);
+        renderPieceTexture(tween.color, tween.type, currentX, currentY);
+    }
+}
 
-        // Clear screen and render base board
-        //clearWindow();
-        renderBoard();
+/* The board already holds the moved pieces, which are hidden on their destination until they get there */
+bool Graphics::isAnimatedSquare(int index) const {
+    for (const PieceTween & tween : mTweens) {
+        if (!tween.fade && tween.toIndex == index) return true;
+    }
+    return false;
+}
 
-        // Draw all other pieces
-        renderPieces(board);
+/* Renders the sprite of a piece at the given position, faded by alpha */
+void Graphics::renderPieceTexture(Color color, PieceType type, int x, int y, Uint8 alpha) {
+    mSprites.add(pieceSprite(color, type), {x, y, SQUARE_SIZE, SQUARE_SIZE}, {0xFF, 0xFF, 0xFF, alpha});
+}
 
-        // Redraw the square where the moving piece was, to "hide" it
-        renderBoardSquare(fromCol, fromRow);
+/* Prints a given text on the center of the screen. The Board parameter is necessary for the renderPieces method */
+void Graphics::printText(const Board & board, const std::string & text) {
+    /* First, render the board normally */
+    renderScene(board);
+    renderText(text);
+    flushSprites();
+}
 
-        // Draw the moving piece at its interpolated position
-        if (movingPiece->getColor() == Color::White)
-            whitePieces[static_cast<int>(movingPiece->getType())].renderTexture(mRenderer, currentX, currentY);
-        else
-            blackPieces[static_cast<int>(movingPiece->getType())].renderTexture(mRenderer, currentX, currentY);
+/* Renders a text on the center of the screen, on top of what was rendered before. The line is laid out once and its glyphs go in the sprite batch */
+void Graphics::renderText(const std::string & text) {
+    TRACE_ZONE("graphics", "renderText");
+    /* Center text*/
+    float x = (WIN_WIDTH - mBoardText.getWidth(text))/2;
+    float y = (WIN_HEIGHT - mBoardText.getHeight())/2;
 
-        /* Render GUI while animating */
-        mGuiPtr->render();
-        updateWindow();
-        SDL_Delay(frameDelay);
-    }
-    
+    mBoardText.draw(mSprites, text, x, y, STATUS_TEXT);
 }
 
-/* Prints a given text on the center of the screen. The Board parameter is necessary for the renderPieces method */
-void Graphics::printText(const Board & board, std::string & text) {
-    /* First, render the board normally */
-    //clearWindow();
+/* Renders a position on the offscreen surface and saves it as a PNG image. The piece on selectedIndex, if any, is highlighted together with its moves, as when it is selected in the GUI */
+bool Graphics::saveBoardImage(const Board & board, const std::string & path, int selectedIndex) {
+    TRACE_ZONE("graphics", "saveBoardImage");
+    if (mSurface == nullptr) return false;
+
+    bool selected = Board::isValidIndex(selectedIndex) && board.board[selectedIndex] != nullptr;
     renderBoard();
+    if (selected) highlightSquare(selectedIndex);
 	renderPieces(board);
+    if (selected) highlightPossibleMoves(board, selectedIndex);
+    flushSprites();
+    SDL_RenderFlush(mRenderer); /* The software renderer draws on the surface when flushed */
 
-    /* Then, create the texture and render the text*/
-    Texture renderText;
-    renderText.loadFromRenderedText(mRenderer, boardFont, text, STATUS_TEXT);
-
-    /* Center text*/
-    int x = (WIN_WIDTH - renderText.getWidth())/2;
-    int y = (WIN_HEIGHT - renderText.getHeight())/2;
-
-    renderText.renderText(mRenderer, x, y);
-    updateWindow();
+    if (IMG_SavePNG(mSurface, path.c_str()) != 0) {
+        std::cerr << "Unable to save " << path << "! SDL_Image Error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+    return true;
 }
 
 /* Flips the board */
@@ -0,0 +1,54 @@
+/* Include other defined headers */
+#include "HeadlessGame.hpp"
+#include "Notation.hpp"
+#include "Piece.hpp"
+#include "Zobrist.hpp"
+
+HeadlessGame::HeadlessGame() : mEnd(GameEnd::None), mResult("*") {
+    start();
+}
+
+bool HeadlessGame::start(std::string_view fen) {
+    if (mBoard.parseFEN(fen) != FENError::None) return false;
+
+    mKeys.clear();
+    mKeys.push_back(computeZobristKey(mBoard));
+    mResult = "*";
+    mEnd = adjudicate(mBoard, mKeys, nullptr, mResult);
+    return true;
+}
+
+/* UCI is tried first: a SAN move never starts with two squares, so the two cannot be confused */
+bool HeadlessGame::playMove(std::string_view text, Move & played) {
+    if (isOver()) return false;
+    if (!parseUCI(mBoard, text, played) && !parseSAN(mBoard, text, played)) return false;
+    return playMove(played);
+}
+
+bool HeadlessGame::playMove(const Move & move) {
+    if (isOver()) return false;
+
+    /* Only the validated moves of the side to move, so the Board is never left half moved */
+    if (!Board::isValidIndex(move.from) || !Board::isValidIndex(move.to)) return false;
+    Piece * piece = mBoard.board[move.from];
+    if (!piece || piece->getColor() != mBoard.getTurn() || !piece->isValidMove(move.to)) return false;
+    if (!mBoard.playMove(move)) return false;
+
+    mKeys.push_back(computeZobristKey(mBoard));
+    mEnd = adjudicate(mBoard, mKeys, nullptr, mResult);
+    return true;
+}
+
+void HeadlessGame::resign(Color color) {
+    forfeit(color, GameEnd::Resignation);
+}
+
+void HeadlessGame::abandon(Color color) {
+    forfeit(color, GameEnd::Abandoned);
+}
+
+void HeadlessGame::forfeit(Color color, GameEnd end) {
+    if (isOver()) return;
+    mEnd = end;
+    mResult = (color == Color::White) ? "0-1" : "1-0";
+}
@@ -19,8 +19,8 @@ King::King(Color color, int position, Board * board, bool hasMoved) : Piece(colo
 }
 
 /* Clones the piece to a new address */
-Piece * King::clone(Board* newBoard) const {
-    King * copy = new King(getColor(), getPosition(), newBoard, getHasMoved());
+Piece * King::clone(Board* newBoard, void * memory) const {
+    King * copy = new (memory) King(getColor(), getPosition(), newBoard, getHasMoved());
     copy->mKingSideCastle = mKingSideCastle;
     copy->mQueenSideCastle = mQueenSideCastle;
     copy->mInCheck = mInCheck;
@@ -90,8 +90,8 @@ void King::computeCastling() {
         /* Is the King in Check */
         if (mInCheck) canCastle = false;
 
-        /* If the in between squares and final square are not attacked by enemy pieces */
-        for (int i = 1; i <= 3; ++i) {
+        /* If the in between square and final square are not attacked by enemy pieces */
+        for (int i = 1; i <= 2; ++i) {
             int offset = kingSquare + i;
             if (mColor == Color::White) {
                 if(mBoard->blackAttackBoard[offset]) canCastle = false;
@@ -119,8 +119,8 @@ void King::computeCastling() {
         /* Is the King in Check */
         if (mInCheck) canCastle = false;
 
-        /* If the in between squares and final square are not attacked by enemy pieces */
-        for (int i = 1; i <= 3; ++i) {
+        /* If the in between square and final square are not attacked by enemy pieces. The b-file square only has to be empty */
+        for (int i = 1; i <= 2; ++i) {
             int offset = kingSquare - i;
             if (mColor == Color::White) {
                 if(mBoard->blackAttackBoard[offset]) canCastle = false;
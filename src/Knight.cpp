@@ -15,8 +15,8 @@
 /* ##### Static Variables ##### */
 std::array<const int, 8> Knight::mOffsets = {-17, -15, -10, -6, 6, 10, 15, 17};
 
-Piece * Knight::clone(Board* newBoard) const {
-    Piece * copy = new Knight(mColor, mPosition, newBoard);
+Piece * Knight::clone(Board* newBoard, void * memory) const {
+    Piece * copy = new (memory) Knight(mColor, mPosition, newBoard);
     copy->validMoves = validMoves;
     return copy;
 }
@@ -0,0 +1,67 @@
+/* Standard Libraries */
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* Include other defined headers */
+#include "LineSocket.hpp"
+
+bool LineSocket::receive() {
+
+    /* The lines already taken are dropped first, so the buffer only holds the incomplete one */
+    mInput.erase(0, mInputOffset);
+    mInputOffset = 0;
+
+    char buffer[16384];
+    for (;;) {
+        ssize_t count = ::recv(mFd, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            mInput.append(buffer, static_cast<std::size_t>(count));
+            continue;
+        }
+        if (count == 0) return false; /* Closed by the peer */
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+        break;
+    }
+
+    /* A peer sending no end of line would make the buffer grow forever */
+    std::size_t last = mInput.rfind('\n');
+    return mInput.size() - (last == std::string::npos ? 0 : last + 1) <= MAX_LINE;
+}
+
+bool LineSocket::nextLine(std::string_view & line) {
+    std::size_t end = mInput.find('\n', mInputOffset);
+    if (end == std::string::npos) return false;
+
+    line = std::string_view(mInput).substr(mInputOffset, end - mInputOffset);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    mInputOffset = end + 1;
+    return true;
+}
+
+bool LineSocket::flush() {
+    while (hasOutput()) {
+        ssize_t count = ::send(mFd, mOutput.data() + mOutputOffset, mOutput.size() - mOutputOffset, MSG_NOSIGNAL);
+        if (count > 0) {
+            mOutputOffset += static_cast<std::size_t>(count);
+            continue;
+        }
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break; /* Full, the rest is written when it is writable again */
+        return false;
+    }
+
+    if (!hasOutput()) {
+        mOutput.clear();
+        mOutputOffset = 0;
+    }
+    return true;
+}
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
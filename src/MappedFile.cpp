@@ -0,0 +1,52 @@
+/* Standard Libraries */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Include other defined headers */
+#include "MappedFile.hpp"
+
+MappedFile::MappedFile() : mData(nullptr), mSize(0), mOpen(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+/* Maps the file into memory. An empty file is valid, but has no data */
+bool MappedFile::open(const std::string & path, bool sequential) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    mSize = static_cast<std::size_t>(info.st_size);
+    if (mSize > 0) {
+        void * address = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            mSize = 0;
+            return false;
+        }
+        if (sequential) madvise(address, mSize, MADV_SEQUENTIAL);
+        mData = static_cast<const char *>(address);
+    }
+
+    /* The mapping stays valid after closing the descriptor */
+    ::close(fd);
+    mOpen = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mData) munmap(const_cast<char *>(mData), mSize);
+    mData = nullptr;
+    mSize = 0;
+    mOpen = false;
+}
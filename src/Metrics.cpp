@@ -0,0 +1,225 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/* Include other defined headers */
+#include "Metrics.hpp"
+
+/* ##### Counter ##### */
+Counter::Counter(const std::string & name, const std::string & help) : mName(name), mHelp(help) {
+    MetricsRegistry::instance().add(this);
+}
+
+Counter::~Counter() {
+    MetricsRegistry::instance().remove(this);
+}
+
+std::uint64_t Counter::getValue() const {
+    std::uint64_t total = 0;
+    for (const Shard & shard : mShards) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+/* ##### Histogram ##### */
+Histogram::Histogram(const std::string & name, const std::string & help, const std::vector<double> & bounds) : mName(name), mHelp(help), mBounds(bounds) {
+    std::sort(mBounds.begin(), mBounds.end());
+    if (mBounds.size() > MAX_HISTOGRAM_BUCKETS) mBounds.resize(MAX_HISTOGRAM_BUCKETS);
+    MetricsRegistry::instance().add(this);
+}
+
+Histogram::~Histogram() {
+    MetricsRegistry::instance().remove(this);
+}
+
+void Histogram::observe(double value) {
+    std::size_t bucket = std::lower_bound(mBounds.begin(), mBounds.end(), value) - mBounds.begin();
+    Shard & shard = mShards[metricShard()];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+
+    /* No fetch_add for doubles before C++20. The shard is rarely shared, so this almost never loops */
+    double sum = shard.sum.load(std::memory_order_relaxed);
+    while (!shard.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+}
+
+Histogram::Snapshot Histogram::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.counts.assign(mBounds.size() + 1, 0);
+    for (const Shard & shard : mShards) {
+        for (std::size_t i = 0; i < snapshot.counts.size(); ++i) snapshot.counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+        snapshot.count += shard.count.load(std::memory_order_relaxed);
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+/* ##### MetricsRegistry ##### */
+MetricsRegistry & MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void MetricsRegistry::add(Counter * counter) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCounters.push_back(counter);
+}
+
+void MetricsRegistry::add(Histogram * histogram) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mHistograms.push_back(histogram);
+}
+
+void MetricsRegistry::remove(const Counter * counter) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCounters.erase(std::remove(mCounters.begin(), mCounters.end(), counter), mCounters.end());
+}
+
+void MetricsRegistry::remove(const Histogram * histogram) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mHistograms.erase(std::remove(mHistograms.begin(), mHistograms.end(), histogram), mHistograms.end());
+}
+
+/* Shortest text which reads back as the same double, so 0.0005 is not written 0.00050000000000000001 */
+static std::string formatDouble(double value) {
+    char text[32];
+    for (int precision = 15; precision <= 17; ++precision) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtod(text, nullptr) == value) break;
+    }
+    return text;
+}
+
+std::string MetricsRegistry::toJSON() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::ostringstream output;
+    output << "{\"timestamp\":" << std::time(nullptr) << ",\"counters\":{";
+    for (std::size_t i = 0; i < mCounters.size(); ++i)
+        output << (i ? "," : "") << "\"" << mCounters[i]->getName() << "\":" << mCounters[i]->getValue();
+
+    output << "},\"histograms\":{";
+    for (std::size_t i = 0; i < mHistograms.size(); ++i) {
+        const Histogram & histogram = *mHistograms[i];
+        Histogram::Snapshot snapshot = histogram.getSnapshot();
+        output << (i ? "," : "") << "\"" << histogram.getName() << "\":{\"count\":" << snapshot.count << ",\"sum\":" << formatDouble(snapshot.sum) << ",\"buckets\":[";
+        for (std::size_t b = 0; b < snapshot.counts.size(); ++b) {
+            output << (b ? "," : "") << "{\"le\":";
+            if (b < histogram.getBounds().size()) output << formatDouble(histogram.getBounds()[b]);
+            else output << "\"+Inf\"";
+            output << ",\"count\":" << snapshot.counts[b] << "}";
+        }
+        output << "]}";
+    }
+    output << "}}\n";
+    return output.str();
+}
+
+/* Histograms are written with cumulative buckets, as Prometheus expects */
+std::string MetricsRegistry::toPrometheus() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::ostringstream output;
+    for (const Counter * counter : mCounters) {
+        output << "# HELP " << counter->getName() << " " << counter->getHelp() << "\n";
+        output << "# TYPE " << counter->getName() << " counter\n";
+        output << counter->getName() << " " << counter->getValue() << "\n";
+    }
+
+    for (const Histogram * histogram : mHistograms) {
+        Histogram::Snapshot snapshot = histogram->getSnapshot();
+        const std::string & name = histogram->getName();
+        output << "# HELP " << name << " " << histogram->getHelp() << "\n";
+        output << "# TYPE " << name << " histogram\n";
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < snapshot.counts.size(); ++b) {
+            cumulative += snapshot.counts[b];
+            std::string bound = b < histogram->getBounds().size() ? formatDouble(histogram->getBounds()[b]) : "+Inf";
+            output << name << "_bucket{le=\"" << bound << "\"} " << cumulative << "\n";
+        }
+        output << name << "_sum " << formatDouble(snapshot.sum) << "\n";
+        output << name << "_count " << snapshot.count << "\n";
+    }
+    return output.str();
+}
+
+/* ##### Engine Metrics ##### */
+EngineMetrics & engineMetrics() {
+    static EngineMetrics metrics;
+    return metrics;
+}
+
+/* ##### Export ##### */
+bool writeMetrics(const std::string & path, MetricsFormat format) {
+    std::string text = MetricsRegistry::instance().format(format);
+    if (path == "-") {
+        std::cout << text << std::flush;
+        return static_cast<bool>(std::cout);
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream output(temporary, std::ios::trunc);
+        if (!output) return false;
+        output << text;
+        if (!output) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool parseMetricsArgument(int argc, char * argv[], int & i, MetricsOptions & options) {
+    if (i + 1 >= argc) return false;
+
+    if (std::strcmp(argv[i], "--metrics") == 0) {
+        options.path = argv[++i];
+    } else if (std::strcmp(argv[i], "--metrics-format") == 0) {
+        const char * format = argv[++i];
+        if (std::strcmp(format, "json") == 0) options.format = MetricsFormat::JSON;
+        else if (std::strcmp(format, "prometheus") == 0) options.format = MetricsFormat::Prometheus;
+        else std::cerr << "Unknown metrics format " << format << ", using " << (options.format == MetricsFormat::JSON ? "json" : "prometheus") << std::endl;
+    } else if (std::strcmp(argv[i], "--metrics-interval") == 0) {
+        double interval = std::atof(argv[++i]);
+        if (interval > 0.0) options.interval = interval;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/* ##### MetricsExporter ##### */
+MetricsExporter::MetricsExporter(const MetricsOptions & options) : mOptions(options), mStop(false) {
+    if (mOptions.path.empty()) return;
+
+    /* The metrics of the engine exist before the first snapshot, even if nothing used them yet */
+    engineMetrics();
+
+    mThread = std::thread([this] {
+        auto interval = std::chrono::duration<double>(mOptions.interval);
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (!mWake.wait_for(lock, interval, [this] { return mStop; })) {
+            lock.unlock();
+            if (!writeMetrics(mOptions.path, mOptions.format))
+                std::cerr << "Unable to write the metrics to " << mOptions.path << std::endl;
+            lock.lock();
+        }
+    });
+}
+
+MetricsExporter::~MetricsExporter() {
+    if (!mThread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_one();
+    mThread.join();
+
+    if (!writeMetrics(mOptions.path, mOptions.format))
+        std::cerr << "Unable to write the metrics to " << mOptions.path << std::endl;
+}
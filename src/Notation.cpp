@@ -0,0 +1,248 @@
+/* Standard Libraries */
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+
+/* Include other defined headers */
+#include "Notation.hpp"
+#include "Piece.hpp"
+
+/* Returns the SAN letter of a piece. Pawns (and empty squares) have none */
+char pieceToLetter(PieceType type) {
+    switch (type) {
+        case PieceType::Knight: return 'N';
+        case PieceType::Bishop: return 'B';
+        case PieceType::Rook: return 'R';
+        case PieceType::Queen: return 'Q';
+        case PieceType::King: return 'K';
+        default: return '\0';
+    }
+}
+
+/* Returns the piece of a SAN letter, or PieceType::Empty if it is not a piece letter */
+PieceType letterToPiece(char letter) {
+    switch (letter) {
+        case 'N': return PieceType::Knight;
+        case 'B': return PieceType::Bishop;
+        case 'R': return PieceType::Rook;
+        case 'Q': return PieceType::Queen;
+        case 'K': return PieceType::King;
+        default: return PieceType::Empty;
+    }
+}
+
+/* Parses a SAN move. The move is matched against the validated moves of the pieces of the side to move, so the board must have its next player moves validated (as done by loadFromFEN and playMove). The piece letter, destination square, disambiguation and promotion are read from the text, while captures, checks and annotations are ignored, as they are implied by the position */
+bool parseSAN(const Board & board, std::string_view san, Move & move) {
+
+    /* Strip check, checkmate and annotation suffixes */
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+        san.remove_suffix(1);
+    if (san.size() < 2) return false;
+
+    Color turn = board.getTurn();
+    int homeRow = (turn == Color::White) ? 0 : ROW - 1;
+
+    /* Castling, which some files write with zeros */
+    bool kingSide = (san == "O-O" || san == "0-0");
+    bool queenSide = (san == "O-O-O" || san == "0-0-0");
+    if (kingSide || queenSide) {
+        int from = Board::squareToIndex(homeRow, 4);
+        int to = Board::squareToIndex(homeRow, kingSide ? 6 : 2);
+        Piece * king = board.board[from];
+        if (!king || king->getType() != PieceType::King || king->getColor() != turn || !king->isValidMove(to))
+            return false;
+
+        move = {from, to, PieceType::Empty};
+        return true;
+    }
+
+    /* Piece letter, pawns have none */
+    PieceType type = PieceType::Pawn;
+    std::size_t begin = 0;
+    if (letterToPiece(san[0]) != PieceType::Empty) {
+        type = letterToPiece(san[0]);
+        begin = 1;
+    }
+
+    /* Promotion, either e8=Q or e8Q */
+    PieceType promotion = PieceType::Empty;
+    std::size_t end = san.size();
+    if (type == PieceType::Pawn) {
+        if (end >= 2 && san[end - 2] == '=') {
+            promotion = letterToPiece(san[end - 1]);
+            end -= 2;
+        } else if (letterToPiece(san[end - 1]) != PieceType::Empty) {
+            promotion = letterToPiece(san[end - 1]);
+            end -= 1;
+        }
+        if (promotion == PieceType::King) return false;
+        if (end < san.size() && promotion == PieceType::Empty) return false;
+    }
+
+    /* Destination square */
+    if (end < begin + 2) return false;
+    char file = san[end - 2];
+    char rank = san[end - 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') return false;
+    int toCol = file - 'a';
+    int toRow = rank - '1';
+    int to = Board::squareToIndex(toRow, toCol);
+
+    /* Disambiguation, ignoring the capture marker and the long algebraic hyphen */
+    int fromCol = -1;
+    int fromRow = -1;
+    for (std::size_t i = begin; i < end - 2; ++i) {
+        char c = san[i];
+        if (c == 'x' || c == '-' || c == ':') continue;
+        if (c >= 'a' && c <= 'h') fromCol = c - 'a';
+        else if (c >= '1' && c <= '8') fromRow = c - '1';
+        else return false;
+    }
+
+    /* A pawn without a file only moves forward, captures always name the origin file */
+    if (type == PieceType::Pawn && fromCol == -1)
+        fromCol = toCol;
+
+    /* Find the only piece that can legally perform the move */
+    int from = -1;
+    for (int i = 0; i < 64; ++i) {
+        Piece * piece = board.board[i];
+        if (!piece || piece->getColor() != turn || piece->getType() != type) continue;
+        if (fromCol != -1 && Board::indexToColumn(i) != fromCol) continue;
+        if (fromRow != -1 && Board::indexToRow(i) != fromRow) continue;
+        if (!piece->isValidMove(to)) continue;
+
+        if (from != -1) return false; /* Ambiguous */
+        from = i;
+    }
+    if (from == -1) return false;
+
+    /* Pawns reaching the last rank must promote. Old files sometimes omit the piece, which means a Queen */
+    bool lastRank = (type == PieceType::Pawn) && (toRow == 0 || toRow == ROW - 1);
+    if (lastRank && promotion == PieceType::Empty) promotion = PieceType::Queen;
+    if (!lastRank && promotion != PieceType::Empty) return false;
+
+    move = {from, to, promotion};
+    return true;
+}
+
+/* Writes the SAN of a move. The text is built in a small local buffer and copied to the caller's. Without after, the check suffix needs a copy of the board (and of its pieces) to play the move on, so callers that play the move anyway should pass the position after it */
+std::size_t writeSAN(const Board & board, const Move & move, char * buffer, std::size_t size, const Board * after) {
+    if (!Board::isValidIndex(move.from) || !Board::isValidIndex(move.to)) return 0;
+
+    Piece * piece = board.board[move.from];
+    if (!piece || piece->getColor() != board.getTurn() || !piece->isValidMove(move.to)) return 0;
+
+    char san[SAN_BUFFER_SIZE];
+    std::size_t length = 0;
+    PieceType type = piece->getType();
+    int fromCol = Board::indexToColumn(move.from);
+    int toCol = Board::indexToColumn(move.to);
+    int toRow = Board::indexToRow(move.to);
+
+    if (type == PieceType::King && std::abs(toCol - fromCol) == 2) {
+        /* Castling */
+        const char * castle = (toCol > fromCol) ? "O-O" : "O-O-O";
+        std::size_t castleLength = std::strlen(castle);
+        std::memcpy(san, castle, castleLength);
+        length = castleLength;
+
+    } else if (type == PieceType::Pawn) {
+        /* Pawns: the origin file is only written for captures, which include en passant */
+        if (fromCol != toCol) {
+            san[length++] = 'a' + fromCol;
+            san[length++] = 'x';
+        }
+        san[length++] = 'a' + toCol;
+        san[length++] = '1' + toRow;
+
+        if (toRow == 0 || toRow == ROW - 1) {
+            PieceType promotion = (move.promotion == PieceType::Knight || move.promotion == PieceType::Bishop || move.promotion == PieceType::Rook) ? move.promotion : PieceType::Queen;
+            san[length++] = '=';
+            san[length++] = pieceToLetter(promotion);
+        }
+
+    } else {
+        /* Pieces: disambiguate by file, then by rank, then by both, only against pieces of the same type that can also legally reach the square */
+        bool ambiguous = false, sameFile = false, sameRank = false;
+        for (int i = 0; i < 64; ++i) {
+            Piece * other = board.board[i];
+            if (i == move.from || !other || other->getColor() != piece->getColor() || other->getType() != type) continue;
+            if (!other->isValidMove(move.to)) continue;
+
+            ambiguous = true;
+            if (Board::indexToColumn(i) == fromCol) sameFile = true;
+            if (Board::indexToRow(i) == Board::indexToRow(move.from)) sameRank = true;
+        }
+
+        san[length++] = pieceToLetter(type);
+        if (ambiguous && (!sameFile || sameRank)) san[length++] = 'a' + fromCol;
+        if (ambiguous && sameFile) san[length++] = '1' + Board::indexToRow(move.from);
+        if (board.board[move.to]) san[length++] = 'x';
+        san[length++] = 'a' + toCol;
+        san[length++] = '1' + toRow;
+    }
+
+    /* Check and checkmate, from the position after the move */
+    std::optional<Board> simulated;
+    if (!after) {
+        simulated.emplace(board);
+        if (!simulated->playMove(move)) return 0;
+        after = &*simulated;
+    }
+
+    const King * king = after->getKing(after->getTurn());
+    if (king && king->isChecked())
+        san[length++] = (after->moveCount == 0) ? '#' : '+';
+
+    if (length + 1 > size) return 0;
+    std::memcpy(buffer, san, length);
+    buffer[length] = '\0';
+    return length;
+}
+
+/* Parses a UCI move. The squares are checked against the validated moves of the piece, like parseSAN */
+bool parseUCI(const Board & board, std::string_view uci, Move & move) {
+    if (uci.size() != 4 && uci.size() != 5) return false;
+    for (std::size_t i = 0; i < 4; i += 2) {
+        if (uci[i] < 'a' || uci[i] > 'h' || uci[i + 1] < '1' || uci[i + 1] > '8') return false;
+    }
+
+    int from = Board::squareToIndex(uci[1] - '1', uci[0] - 'a');
+    int to = Board::squareToIndex(uci[3] - '1', uci[2] - 'a');
+    Piece * piece = board.board[from];
+    if (!piece || piece->getColor() != board.getTurn() || !piece->isValidMove(to)) return false;
+
+    PieceType promotion = PieceType::Empty;
+    if (uci.size() == 5) {
+        promotion = letterToPiece(static_cast<char>(std::toupper(static_cast<unsigned char>(uci[4]))));
+        if (promotion != PieceType::Knight && promotion != PieceType::Bishop && promotion != PieceType::Rook && promotion != PieceType::Queen) return false;
+    }
+
+    int toRow = Board::indexToRow(to);
+    bool lastRank = (piece->getType() == PieceType::Pawn) && (toRow == 0 || toRow == ROW - 1);
+    if (lastRank && promotion == PieceType::Empty) promotion = PieceType::Queen;
+    if (!lastRank && promotion != PieceType::Empty) return false;
+
+    move = {from, to, promotion};
+    return true;
+}
+
+std::size_t writeUCI(const Move & move, char * buffer, std::size_t size) {
+    if (!Board::isValidIndex(move.from) || !Board::isValidIndex(move.to)) return 0;
+
+    char uci[UCI_BUFFER_SIZE];
+    std::size_t length = 0;
+    uci[length++] = 'a' + Board::indexToColumn(move.from);
+    uci[length++] = '1' + Board::indexToRow(move.from);
+    uci[length++] = 'a' + Board::indexToColumn(move.to);
+    uci[length++] = '1' + Board::indexToRow(move.to);
+    if (move.promotion == PieceType::Knight || move.promotion == PieceType::Bishop || move.promotion == PieceType::Rook || move.promotion == PieceType::Queen)
+        uci[length++] = static_cast<char>(std::tolower(static_cast<unsigned char>(pieceToLetter(move.promotion))));
+
+    if (length + 1 > size) return 0;
+    std::memcpy(buffer, uci, length);
+    buffer[length] = '\0';
+    return length;
+}
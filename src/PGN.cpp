@@ -0,0 +1,283 @@
+/* Standard Libraries */
+#include <cctype>
+#include <sstream>
+
+/* Include other defined headers */
+#include "PGN.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
+#include "Notation.hpp"
+
+/* ##### PGNGame ##### */
+void PGNGame::clear() {
+    tags.clear();
+    moves.clear();
+    result.clear();
+}
+
+const std::string * PGNGame::findTag(const std::string & name) const {
+    for (const PGNTag & tag : tags) {
+        if (tag.name == name) return &tag.value;
+    }
+    return nullptr;
+}
+
+/* ##### PGNReader ##### */
+/* Stream constructor. Nothing is read until the first game is requested */
+PGNReader::PGNReader(std::istream & input, std::size_t bufferSize) : mInput(&input), mBuffer(bufferSize), mOffset(0), mGamesRead(0), mLastChar('\n') {
+    mBegin = mCursor = mEnd = mBuffer.data();
+}
+
+/* Memory constructor. The whole input is already available, so there is nothing to refill */
+PGNReader::PGNReader(const char * data, std::size_t size) : mInput(nullptr), mOffset(0), mGamesRead(0), mLastChar('\n') {
+    mBegin = mCursor = data;
+    mEnd = data + size;
+}
+
+/* Reads the next chunk of the stream into the buffer. Returns false at the end of the input */
+bool PGNReader::refill() {
+    if (!mInput) return false;
+
+    mOffset += mEnd - mBegin;
+    mInput->read(mBuffer.data(), mBuffer.size());
+    std::streamsize count = mInput->gcount();
+    if (count <= 0) {
+        mBegin = mCursor = mEnd = mBuffer.data();
+        return false;
+    }
+
+    mBegin = mCursor = mBuffer.data();
+    mEnd = mBegin + count;
+    return true;
+}
+
+/* Consumes one character */
+int PGNReader::get() {
+    int c = peek();
+    if (c != EOF) {
+        ++mCursor;
+        mLastChar = c;
+    }
+    return c;
+}
+
+/* Reads a tag pair: [Name "Value"]. Backslashes escape quotes and backslashes inside the value */
+void PGNReader::readTag(PGNGame & game) {
+    get(); /* '[' */
+    game.tags.emplace_back();
+    PGNTag & tag = game.tags.back();
+
+    int c;
+    while ((c = peek()) == ' ' || c == '\t') get();
+    while ((c = peek()) != EOF && !std::isspace(c) && c != '"' && c != ']') tag.name += static_cast<char>(get());
+    while ((c = peek()) == ' ' || c == '\t') get();
+
+    if (peek() == '"') {
+        get();
+        while ((c = get()) != EOF && c != '"' && c != '\n') {
+            if (c == '\\' && (peek() == '"' || peek() == '\\')) c = get();
+            tag.value += static_cast<char>(c);
+        }
+    }
+
+    /* Skip whatever is left until the closing bracket */
+    while ((c = peek()) != EOF && c != '\n') {
+        get();
+        if (c == ']') break;
+    }
+}
+
+/* Reads a symbol token (move number, move or result) into mToken. Tokens end at white space or at the start of another PGN element */
+void PGNReader::readToken() {
+    mToken.clear();
+    int c;
+    while ((c = peek()) != EOF && !std::isspace(c) && c != '{' && c != '}' && c != '(' && c != ')' && c != '[' && c != ']' && c != ';' && c != '$' && c != '"')
+        mToken += static_cast<char>(get());
+}
+
+/* Skips a rest of line comment, or a line escaped with % */
+void PGNReader::skipLine() {
+    int c;
+    while ((c = get()) != EOF && c != '\n') {}
+}
+
+/* Skips a brace comment. They do not nest */
+void PGNReader::skipComment() {
+    int c;
+    while ((c = get()) != EOF && c != '}') {}
+}
+
+/* Skips a (possibly nested) variation, together with the comments inside it, which may contain parentheses */
+void PGNReader::skipVariation() {
+    get(); /* '(' */
+    int depth = 1;
+    int c;
+    while (depth > 0 && (c = peek()) != EOF) {
+        if (c == '{') { skipComment(); continue; }
+        if (c == ';') { skipLine(); continue; }
+        get();
+        if (c == '(') ++depth;
+        else if (c == ')') --depth;
+    }
+}
+
+/* Reads a full game. The main line moves are stored as SAN tokens, with move numbers, comments, NAGs, annotation glyphs and variations removed. A game ends with its result token, or when a new tag section starts */
+bool PGNReader::readGame(PGNGame & game) {
+    TRACE_ZONE("pgn", "readGame");
+    std::uint64_t start = getBytesRead();
+    bool read = parseGame(game);
+    engineMetrics().pgnBytesParsed.add(getBytesRead() - start);
+    return read;
+}
+
+bool PGNReader::parseGame(PGNGame & game) {
+    game.clear();
+    bool hasContent = false;
+
+    int c;
+    while ((c = peek()) != EOF) {
+
+        if (std::isspace(c)) { get(); continue; }
+
+        /* Lines starting with % are escaped */
+        if (c == '%' && mLastChar == '\n') { skipLine(); continue; }
+
+        switch (c) {
+        case '[':
+            /* Tags after moves belong to the next game, which has no result token */
+            if (!game.moves.empty()) {
+                ++mGamesRead;
+                return true;
+            }
+            readTag(game);
+            hasContent = true;
+            continue;
+
+        case '{': skipComment(); continue;
+        case ';': skipLine(); continue;
+        case '(': skipVariation(); continue;
+
+        case '$': /* Numeric Annotation Glyph */
+            get();
+            while (std::isdigit(peek())) get();
+            continue;
+
+        case '*':
+            get();
+            game.result = "*";
+            ++mGamesRead;
+            return true;
+
+        default: break;
+        }
+
+        /* Skip stray characters, such as unmatched closing brackets */
+        if (!std::isalnum(c)) { get(); continue; }
+
+        readToken();
+        hasContent = true;
+
+        /* Game termination markers */
+        if (mToken == "1-0" || mToken == "0-1" || mToken == "1/2-1/2") {
+            game.result = mToken;
+            ++mGamesRead;
+            return true;
+        }
+
+        /* Move numbers (12. or 12...), which may be glued to the move itself (12.e4) */
+        std::size_t start = 0;
+        if (std::isdigit(static_cast<unsigned char>(mToken[0])) && mToken.compare(0, 3, "0-0") != 0) {
+            while (start < mToken.size() && std::isdigit(static_cast<unsigned char>(mToken[start]))) ++start;
+            while (start < mToken.size() && mToken[start] == '.') ++start;
+        }
+
+        /* Annotation glyphs (!, ?, !?, ...) are not part of the move */
+        std::size_t end = mToken.size();
+        while (end > start && (mToken[end - 1] == '!' || mToken[end - 1] == '?')) --end;
+
+        if (end > start)
+            game.moves.emplace_back(mToken, start, end - start);
+    }
+
+    /* End of the input. The last game may miss its result */
+    if (hasContent) {
+        ++mGamesRead;
+        return true;
+    }
+    return false;
+}
+
+/* ##### Replay ##### */
+/* Replays the main line of a game on the board. A custom starting position is given by the FEN tag */
+bool replayGame(const PGNGame & game, Board & board, std::vector<Move> * moves) {
+    TRACE_ZONE("pgn", "replayGame");
+    const std::string * fen = game.findTag("FEN");
+
+    FENError error = fen ? board.parseFEN(*fen) : board.parseFEN();
+    if (error != FENError::None) return false;
+
+    if (moves) moves->clear();
+    for (const std::string & san : game.moves) {
+        Move move;
+        if (!parseSAN(board, san, move) || !board.playMove(move))
+            return false;
+        if (moves) moves->push_back(move);
+    }
+
+    engineMetrics().gamesReplayed.add();
+    return true;
+}
+
+/* ##### Writer ##### */
+/* Writes a tag value, escaping quotes and backslashes */
+static void writeTagValue(std::ostream & output, const std::string & value) {
+    for (char c : value) {
+        if (c == '"' || c == '\\') output << '\\';
+        output << c;
+    }
+}
+
+void writePGN(std::ostream & output, const PGNGame & game) {
+    TRACE_ZONE("pgn", "writePGN");
+    for (const PGNTag & tag : game.tags) {
+        output << '[' << tag.name << " \"";
+        writeTagValue(output, tag.value);
+        output << "\"]\n";
+    }
+    output << '\n';
+
+    /* The side to move and the move number are the second and last fields of the FEN */
+    int number = 1;
+    bool white = true;
+    if (const std::string * fen = game.findTag("FEN")) {
+        std::istringstream fields(*fen);
+        std::string placement, turn, castling, enPassant;
+        int halfMoves = 0;
+        fields >> placement >> turn >> castling >> enPassant >> halfMoves >> number;
+        white = (turn != "b");
+        if (number < 1) number = 1;
+    }
+
+    const std::size_t lineWidth = 80;
+    std::string line;
+    auto append = [&](const std::string & token) {
+        if (!line.empty() && line.size() + 1 + token.size() > lineWidth) {
+            output << line << '\n';
+            line.clear();
+        }
+        if (!line.empty()) line += ' ';
+        line += token;
+    };
+
+    for (std::size_t i = 0; i < game.moves.size(); ++i) {
+        if (white) append(std::to_string(number) + '.');
+        else if (i == 0) append(std::to_string(number) + "...");
+        append(game.moves[i]);
+
+        if (!white) ++number;
+        white = !white;
+    }
+
+    append(game.result.empty() ? "*" : game.result);
+    output << line << "\n\n";
+}
@@ -0,0 +1,209 @@
+/* Standard Libraries */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
+/* Include other defined headers */
+#include "PGNPipeline.hpp"
+#include "Trace.hpp"
+#include "BoundedQueue.hpp"
+#include "MappedFile.hpp"
+
+/* ##### Work Items ##### */
+/* Byte range of the input holding one game (or more, if some games have no [Event tag) */
+struct GameRange {
+    std::uint64_t index;
+    std::size_t begin;
+    std::size_t end;
+};
+
+/* Games parsed from one range */
+struct RangeResult {
+    std::uint64_t index;
+    std::vector<PGNPipelineGame> games;
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* Finds the next [Event tag at the beginning of a line */
+std::size_t findNextGame(const char * data, std::size_t size, std::size_t offset) {
+    static const char tag[] = "[Event ";
+    const std::size_t tagLength = sizeof(tag) - 1;
+
+    while (offset < size) {
+        const void * found = std::memchr(data + offset, '[', size - offset);
+        if (!found) return size;
+
+        std::size_t position = static_cast<const char *>(found) - data;
+        if ((position == 0 || data[position - 1] == '\n') && size - position >= tagLength && std::memcmp(data + position, tag, tagLength) == 0)
+            return position;
+        offset = position + 1;
+    }
+    return size;
+}
+
+PGNPipeline::PGNPipeline(const PGNPipelineOptions & options) : mOptions(options) {
+    if (mOptions.threads == 0) mOptions.threads = std::thread::hardware_concurrency();
+    if (mOptions.threads == 0) mOptions.threads = 1;
+    if (mOptions.maxInFlight == 0) mOptions.maxInFlight = 1;
+}
+
+/* Maps the file and runs the pipeline on its contents */
+bool PGNPipeline::run(const std::string & path, const Sink & sink) {
+    MappedFile file;
+    if (!file.open(path, true)) return false;
+
+    run(file.getData(), file.getSize(), sink);
+    return true;
+}
+
+void PGNPipeline::run(const char * data, std::size_t size, const Sink & sink) {
+    mStats = PGNPipelineStats();
+    mStats.workers = mOptions.threads;
+    auto start = std::chrono::steady_clock::now();
+
+    BoundedQueue<GameRange> ranges(mOptions.queueCapacity);
+    BoundedQueue<RangeResult> results(mOptions.queueCapacity);
+
+    /* Flow control between the splitter and the sink, so the reordering buffer stays bounded even if one game takes much longer than the others */
+    std::mutex flightMutex;
+    std::condition_variable flightChanged;
+    std::uint64_t delivered = 0;
+    bool aborted = false;
+
+    /* ##### Stage 1: Splitter ##### */
+    std::thread splitter([&] {
+        setTraceThreadName("pgn splitter");
+        double busy = 0.0;
+        std::uint64_t index = 0;
+
+        auto busyStart = std::chrono::steady_clock::now();
+        std::size_t begin = 0;
+        std::size_t next = findNextGame(data, size, 0);
+        if (next < size) next = findNextGame(data, size, next + 1); /* Anything before the first game belongs to it */
+        busy += secondsSince(busyStart);
+
+        while (begin < size) {
+            {
+                std::unique_lock<std::mutex> lock(flightMutex);
+                flightChanged.wait(lock, [&] { return aborted || index - delivered < mOptions.maxInFlight; });
+                if (aborted) break;
+            }
+            if (!ranges.push({index++, begin, next})) break;
+
+            busyStart = std::chrono::steady_clock::now();
+            begin = next;
+            next = findNextGame(data, size, begin + 1);
+            busy += secondsSince(busyStart);
+        }
+
+        ranges.close();
+        mStats.ranges = index;
+        mStats.bytes = size;
+        mStats.splitSeconds = busy;
+    });
+
+    /* ##### Stage 2: Workers ##### */
+    std::mutex statsMutex;
+    std::atomic<unsigned> activeWorkers(mOptions.threads);
+    std::vector<std::thread> workers;
+
+    for (unsigned i = 0; i < mOptions.threads; ++i) {
+        workers.emplace_back([&, i] {
+            setTraceThreadName("pgn worker " + std::to_string(i + 1));
+            Board board;
+            std::uint64_t games = 0, moves = 0, failed = 0;
+            double busy = 0.0;
+
+            GameRange range;
+            while (ranges.pop(range)) {
+                auto busyStart = std::chrono::steady_clock::now();
+                RangeResult result;
+                result.index = range.index;
+
+                PGNReader reader(data + range.begin, range.end - range.begin);
+                PGNPipelineGame item;
+                while (reader.readGame(item.game)) {
+                    item.replayed = mOptions.replay && replayGame(item.game, board, &item.moves);
+                    if (mOptions.replay && !item.replayed) ++failed;
+                    ++games;
+                    moves += item.game.moves.size();
+                    result.games.push_back(std::move(item));
+                    item = PGNPipelineGame();
+                }
+                busy += secondsSince(busyStart);
+
+                if (!results.push(std::move(result))) break;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                mStats.games += games;
+                mStats.moves += moves;
+                mStats.failed += failed;
+                mStats.workerSeconds += busy;
+            }
+
+            /* The last worker tells the sink there is nothing else coming */
+            if (--activeWorkers == 0) results.close();
+        });
+    }
+
+    /* ##### Stage 3: Ordered Sink ##### */
+    std::exception_ptr error;
+    std::map<std::uint64_t, RangeResult> pending;
+    std::uint64_t nextIndex = 0;
+    double sinkBusy = 0.0;
+
+    RangeResult result;
+    while (results.pop(result)) {
+        if (error) continue; /* Drain, so the workers can finish */
+
+        auto busyStart = std::chrono::steady_clock::now();
+        pending.emplace(result.index, std::move(result));
+        if (pending.size() > mStats.reorderMax) mStats.reorderMax = pending.size();
+
+        try {
+            auto it = pending.begin();
+            while (it != pending.end() && it->first == nextIndex) {
+                for (PGNPipelineGame & game : it->second.games) {
+                    game.index = mStats.delivered++;
+                    sink(game);
+                }
+                it = pending.erase(it);
+                ++nextIndex;
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(flightMutex);
+            delivered = nextIndex;
+            if (error) aborted = true;
+        }
+        flightChanged.notify_one();
+        if (error) ranges.close();
+
+        sinkBusy += secondsSince(busyStart);
+    }
+
+    splitter.join();
+    for (std::thread & worker : workers) worker.join();
+
+    mStats.sinkSeconds = sinkBusy;
+    mStats.rangeQueueMax = ranges.getMaxDepth();
+    mStats.rangeQueueAverage = ranges.getAverageDepth();
+    mStats.resultQueueMax = results.getMaxDepth();
+    mStats.resultQueueAverage = results.getAverageDepth();
+    mStats.seconds = secondsSince(start);
+
+    if (error) std::rethrow_exception(error);
+}
@@ -3,8 +3,8 @@
 #include "King.hpp"
 
 /* Clones the piece to a new index */
-Piece * Pawn::clone(Board* newBoard) const {
-    Piece * copy = new Pawn(getColor(), getPosition(), newBoard, getHasMoved());
+Piece * Pawn::clone(Board* newBoard, void * memory) const {
+    Piece * copy = new (memory) Pawn(getColor(), getPosition(), newBoard, getHasMoved());
     copy->validMoves = validMoves;
     return copy;
 }
@@ -0,0 +1,67 @@
+/* Standard Libraries */
+#include <new>
+
+/* Include other defined headers */
+#include "PieceArena.hpp"
+#include "King.hpp"
+#include "Queen.hpp"
+#include "Rook.hpp"
+#include "Bishop.hpp"
+#include "Knight.hpp"
+#include "Pawn.hpp"
+
+static_assert(sizeof(King) <= PIECE_SLOT_SIZE && sizeof(Queen) <= PIECE_SLOT_SIZE && sizeof(Rook) <= PIECE_SLOT_SIZE, "A piece does not fit in an arena slot");
+static_assert(sizeof(Bishop) <= PIECE_SLOT_SIZE && sizeof(Knight) <= PIECE_SLOT_SIZE && sizeof(Pawn) <= PIECE_SLOT_SIZE, "A piece does not fit in an arena slot");
+
+static thread_local PieceAllocationCounters counters;
+
+const PieceAllocationCounters & getPieceAllocationCounters() {
+    return counters;
+}
+
+void resetPieceAllocationCounters() {
+    counters = PieceAllocationCounters();
+}
+
+void * PieceArena::allocate(int preferredSlot) {
+    int slot = preferredSlot;
+    if (slot < 0 || slot >= CAPACITY || (mUsed >> slot) & 1) {
+        std::uint32_t free = ~mUsed;
+        if (!free) {
+            ++counters.heapAllocations;
+            return ::operator new(PIECE_SLOT_SIZE);
+        }
+        slot = __builtin_ctz(free);
+    }
+    mUsed |= std::uint32_t(1) << slot;
+    ++counters.arenaAllocations;
+    return mStorage[slot];
+}
+
+int PieceArena::getSlot(const Piece * piece) const {
+    const unsigned char * address = reinterpret_cast<const unsigned char *>(piece);
+    if (address < mStorage[0] || address >= mStorage[0] + sizeof(mStorage)) return -1;
+    return static_cast<int>((address - mStorage[0]) / PIECE_SLOT_SIZE);
+}
+
+void PieceArena::release(Piece * piece) {
+    if (!piece) return;
+    int slot = getSlot(piece);
+    piece->~Piece();
+    ++counters.releases;
+    if (slot < 0) ::operator delete(piece);
+    else mUsed &= ~(std::uint32_t(1) << slot);
+}
+
+void PieceArena::reset() {
+    while (mUsed) {
+        int slot = __builtin_ctz(mUsed);
+        std::launder(reinterpret_cast<Piece *>(mStorage[slot]))->~Piece();
+        ++counters.releases;
+        mUsed &= mUsed - 1;
+    }
+}
+
+int PieceArena::getUsedCount() const {
+    return __builtin_popcount(mUsed);
+}
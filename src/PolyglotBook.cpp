@@ -0,0 +1,214 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+/* Include other defined headers */
+#include "PolyglotBook.hpp"
+#include "Notation.hpp"
+#include "Zobrist.hpp"
+
+/* ##### Big Endian Helpers ##### */
+static std::uint64_t readBigEndian(const unsigned char * data, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value = (value << 8) | data[i];
+    return value;
+}
+
+static void writeBigEndian(std::ostream & output, std::uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) output.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/* ##### Move Conversion ##### */
+static int promotionToPolyglot(PieceType type) {
+    switch (type) {
+        case PieceType::Knight: return 1;
+        case PieceType::Bishop: return 2;
+        case PieceType::Rook: return 3;
+        case PieceType::Queen: return 4;
+        default: return 0;
+    }
+}
+
+static PieceType polyglotToPromotion(int promotion) {
+    switch (promotion) {
+        case 1: return PieceType::Knight;
+        case 2: return PieceType::Bishop;
+        case 3: return PieceType::Rook;
+        case 4: return PieceType::Queen;
+        default: return PieceType::Empty;
+    }
+}
+
+std::uint16_t encodePolyglotMove(const Board & board, const Move & move) {
+    int to = move.to;
+    const Piece * piece = Board::isValidIndex(move.from) ? board.board[move.from] : nullptr;
+
+    /* Castling is written as the King taking its Rook */
+    if (piece && piece->getType() == PieceType::King && Board::indexToColumn(move.from) == 4 && (Board::indexToColumn(to) == 6 || Board::indexToColumn(to) == 2))
+        to = (Board::indexToColumn(to) == 6) ? move.from + 3 : move.from - 4;
+
+    int promotion = 0;
+    if (piece && piece->getType() == PieceType::Pawn) promotion = promotionToPolyglot(move.promotion);
+
+    /* Our indexes are row * 8 + col, the same bits as Polyglot's row (3 bits) and file (3 bits) */
+    return static_cast<std::uint16_t>(to | (move.from << 6) | (promotion << 12));
+}
+
+/* Finds the legal move of a book move. The legal moves are given, so a position with several book moves only generates them once */
+static bool matchPolyglotMove(const Board & board, const std::vector<Move> & legalMoves, std::uint16_t polyglotMove, Move & move) {
+    int to = polyglotMove & 63;
+    int from = (polyglotMove >> 6) & 63;
+    PieceType promotion = polyglotToPromotion((polyglotMove >> 12) & 7);
+
+    const Piece * piece = board.board[from];
+    const Piece * target = board.board[to];
+    if (piece && piece->getType() == PieceType::King && target && target->getType() == PieceType::Rook && target->getColor() == piece->getColor())
+        to = (to > from) ? from + 2 : from - 2;
+
+    for (const Move & legal : legalMoves) {
+        if (legal.from == from && legal.to == to && legal.promotion == promotion) {
+            move = legal;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Decodes a book move and checks that it is legal, as a key collision could give a move of another position */
+bool decodePolyglotMove(const Board & board, std::uint16_t polyglotMove, Move & move) {
+    std::vector<Move> legalMoves;
+    board.generateLegalMoves(legalMoves);
+    return matchPolyglotMove(board, legalMoves, polyglotMove, move);
+}
+
+/* ##### PolyglotBook ##### */
+PolyglotBook::PolyglotBook() : mData(nullptr), mCount(0) {}
+
+bool PolyglotBook::open(const std::string & path) {
+    close();
+    if (!mFile.open(path)) return false;
+
+    mData = reinterpret_cast<const unsigned char *>(mFile.getData());
+    mCount = mFile.getSize() / POLYGLOT_ENTRY_SIZE;
+
+    /* Said once, as the GUI and the tools can open many books */
+    static const bool polyglotKeys = hasPolyglotKeys();
+    static bool warned = false;
+    if (!polyglotKeys && !warned) {
+        std::cerr << "Warning: the Zobrist keys are not all those of Polyglot (see cppchess-book verify-keys), so only books written by cppchess-book will be found" << std::endl;
+        warned = true;
+    }
+    return true;
+}
+
+void PolyglotBook::close() {
+    mFile.close();
+    mData = nullptr;
+    mCount = 0;
+}
+
+PolyglotEntry PolyglotBook::getEntry(std::size_t index) const {
+    const unsigned char * data = mData + index * POLYGLOT_ENTRY_SIZE;
+    return {readBigEndian(data, 8), static_cast<std::uint16_t>(readBigEndian(data + 8, 2)), static_cast<std::uint16_t>(readBigEndian(data + 10, 2)), static_cast<std::uint32_t>(readBigEndian(data + 12, 4))};
+}
+
+void PolyglotBook::findMoves(const Board & board, std::vector<BookMove> & moves) const {
+    moves.clear();
+    if (mCount == 0) return;
+
+    /* First entry of the key */
+    std::uint64_t key = computeZobristKey(board);
+    std::size_t low = 0, high = mCount;
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (readBigEndian(mData + middle * POLYGLOT_ENTRY_SIZE, 8) < key) low = middle + 1;
+        else high = middle;
+    }
+
+    if (low == mCount || readBigEndian(mData + low * POLYGLOT_ENTRY_SIZE, 8) != key) return;
+
+    std::vector<Move> legalMoves;
+    board.generateLegalMoves(legalMoves);
+    for (std::size_t i = low; i < mCount; ++i) {
+        PolyglotEntry entry = getEntry(i);
+        if (entry.key != key) break;
+
+        Move move;
+        if (matchPolyglotMove(board, legalMoves, entry.move, move)) moves.push_back({move, entry.weight});
+    }
+
+    std::stable_sort(moves.begin(), moves.end(), [](const BookMove & a, const BookMove & b) { return a.weight > b.weight; });
+}
+
+bool PolyglotBook::pickMove(const Board & board, std::mt19937_64 & random, Move & move) const {
+    std::vector<BookMove> moves;
+    findMoves(board, moves);
+
+    std::uint64_t total = 0;
+    for (const BookMove & bookMove : moves) total += bookMove.weight;
+    if (total == 0) return false; /* Not in the book, or only moves with weight 0, which should not be played */
+
+    std::uint64_t pick = std::uniform_int_distribution<std::uint64_t>(0, total - 1)(random);
+    for (const BookMove & bookMove : moves) {
+        if (pick < bookMove.weight) {
+            move = bookMove.move;
+            return true;
+        }
+        pick -= bookMove.weight;
+    }
+    return false;
+}
+
+/* ##### PolyglotBookBuilder ##### */
+PolyglotBookBuilder::PolyglotBookBuilder(int maxPly, std::uint32_t minCount) : mMaxPly(maxPly), mMinCount(minCount) {}
+
+bool PolyglotBookBuilder::addGame(const PGNGame & game) {
+    const std::string * fen = game.findTag("FEN");
+    if ((fen ? mBoard.parseFEN(*fen) : mBoard.parseFEN()) != FENError::None) return false;
+
+    int ply = 0;
+    for (const std::string & san : game.moves) {
+        if (ply++ >= mMaxPly) break;
+
+        Move move;
+        if (!parseSAN(mBoard, san, move)) return false;
+
+        ++mCounts[{computeZobristKey(mBoard), encodePolyglotMove(mBoard, move)}];
+        if (!mBoard.playMove(move)) return false;
+    }
+    return true;
+}
+
+bool PolyglotBookBuilder::write(const std::string & path) const {
+    std::vector<PolyglotEntry> entries;
+    std::uint32_t maxCount = 0;
+    for (const auto & count : mCounts) {
+        if (count.second < mMinCount) continue;
+        entries.push_back({count.first.key, count.first.move, 0, count.second});
+        maxCount = std::max(maxCount, count.second);
+    }
+
+    /* Scale the counts into weights, keeping every move playable */
+    for (PolyglotEntry & entry : entries) {
+        std::uint64_t weight = (maxCount > 0xFFFF) ? static_cast<std::uint64_t>(entry.learn) * 0xFFFF / maxCount : entry.learn;
+        entry.weight = static_cast<std::uint16_t>(std::max<std::uint64_t>(weight, 1));
+        entry.learn = 0;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const PolyglotEntry & a, const PolyglotEntry & b) {
+        if (a.key != b.key) return a.key < b.key;
+        if (a.weight != b.weight) return a.weight > b.weight;
+        return a.move < b.move;
+    });
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    for (const PolyglotEntry & entry : entries) {
+        writeBigEndian(file, entry.key, 8);
+        writeBigEndian(file, entry.move, 2);
+        writeBigEndian(file, entry.weight, 2);
+        writeBigEndian(file, entry.learn, 4);
+    }
+    return static_cast<bool>(file);
+}
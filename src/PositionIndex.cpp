@@ -0,0 +1,386 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <queue>
+
+/* Include other defined headers */
+#include "PositionIndex.hpp"
+#include "Zobrist.hpp"
+
+static_assert(sizeof(PositionIndexHeader) == 64, "Unexpected PositionIndexHeader layout");
+static_assert(sizeof(PositionEntry) == 16, "Unexpected PositionEntry layout");
+
+static bool entryLess(const PositionEntry & a, const PositionEntry & b) {
+    if (a.key != b.key) return a.key < b.key;
+    if (a.game != b.game) return a.game < b.game;
+    return a.ply < b.ply;
+}
+
+/* ##### Material Signature ##### */
+static int materialShift(PieceType type, Color color) {
+    return 4 * ((color == Color::White ? 0 : 5) + static_cast<int>(type) - static_cast<int>(PieceType::Pawn));
+}
+
+std::uint64_t materialSignature(const Board & board) {
+    std::uint64_t signature = 0;
+    for (int i = 0; i < 64; ++i) {
+        const Piece * piece = board.board[i];
+        if (piece && piece->getType() != PieceType::King) signature += std::uint64_t(1) << materialShift(piece->getType(), piece->getColor());
+    }
+    return signature;
+}
+
+bool parseMaterialSignature(std::string_view text, std::uint64_t & signature) {
+    static const PieceType TYPES[] = {PieceType::Pawn, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen};
+    static const char LETTERS[] = {'P', 'N', 'B', 'R', 'Q'};
+    int kings[2] = {0, 0};
+    signature = 0;
+
+    for (char letter : text) {
+        Color color = std::isupper(static_cast<unsigned char>(letter)) ? Color::White : Color::Black;
+        char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(letter)));
+        if (upper == 'K') {
+            ++kings[color == Color::White ? 0 : 1];
+            continue;
+        }
+
+        const char * found = std::find(std::begin(LETTERS), std::end(LETTERS), upper);
+        if (found == std::end(LETTERS)) return false;
+
+        int shift = materialShift(TYPES[found - LETTERS], color);
+        if (((signature >> shift) & 0xF) == 0xF) return false;
+        signature += std::uint64_t(1) << shift;
+    }
+    return kings[0] == 1 && kings[1] == 1;
+}
+
+/* ##### Run Reader ##### */
+/* Reads the sorted entries of a run file through a small buffer, for the merge */
+class PositionRunReader {
+public:
+    explicit PositionRunReader(const std::string & path) : mFile(path, std::ios::binary), mBuffer(1 << 16), mCursor(0), mCount(0) {}
+
+    bool next(PositionEntry & entry) {
+        if (mCursor == mCount) {
+            mFile.read(reinterpret_cast<char *>(mBuffer.data()), mBuffer.size() * sizeof(PositionEntry));
+            mCount = static_cast<std::size_t>(mFile.gcount()) / sizeof(PositionEntry);
+            mCursor = 0;
+            if (mCount == 0) return false;
+        }
+        entry = mBuffer[mCursor++];
+        return true;
+    }
+
+private:
+    std::ifstream mFile;
+    std::vector<PositionEntry> mBuffer;
+    std::size_t mCursor;
+    std::size_t mCount;
+};
+
+/* ##### Index Writer ##### */
+/* Writes the sorted entries after the header, counting the entries of each key prefix for the directory written after them, then the sorted material entries */
+class PositionIndexWriter {
+public:
+    explicit PositionIndexWriter(const std::string & path) : mFile(path, std::ios::binary | std::ios::trunc), mDirectory((std::size_t(1) << POSITION_INDEX_BUCKET_BITS) + 1, 0), mCount(0), mMaterialCount(0), mMaterial(false) {
+        PositionIndexHeader header = {};
+        mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        mBuffer.reserve(1 << 16);
+    }
+
+    void write(const PositionEntry & entry) {
+        ++mDirectory[(entry.key >> (64 - POSITION_INDEX_BUCKET_BITS)) + 1];
+        mBuffer.push_back(entry);
+        if (mBuffer.size() == mBuffer.capacity()) flush();
+        ++mCount;
+    }
+
+    /* Ends the positions with their directory. The material entries are written after it */
+    void beginMaterial() {
+        if (mMaterial) return;
+        mMaterial = true;
+        flush();
+
+        /* Bucket counts to the offset of the first entry of each bucket */
+        for (std::size_t i = 1; i < mDirectory.size(); ++i) mDirectory[i] += mDirectory[i - 1];
+        mFile.write(reinterpret_cast<const char *>(mDirectory.data()), mDirectory.size() * sizeof(std::uint64_t));
+    }
+
+    void writeMaterial(const PositionEntry & entry) {
+        mBuffer.push_back(entry);
+        if (mBuffer.size() == mBuffer.capacity()) flush();
+        ++mMaterialCount;
+    }
+
+    bool finish(std::uint64_t gameCount) {
+        beginMaterial();
+        flush();
+
+        PositionIndexHeader header = {};
+        std::memcpy(header.magic, POSITION_INDEX_MAGIC, sizeof(header.magic));
+        header.version = POSITION_INDEX_VERSION;
+        header.bucketBits = POSITION_INDEX_BUCKET_BITS;
+        header.entryCount = mCount;
+        header.gameCount = gameCount;
+        header.entriesOffset = sizeof(PositionIndexHeader);
+        header.directoryOffset = header.entriesOffset + mCount * sizeof(PositionEntry);
+        header.materialCount = mMaterialCount;
+        header.materialOffset = header.directoryOffset + mDirectory.size() * sizeof(std::uint64_t);
+
+        mFile.seekp(0);
+        mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        bool good = static_cast<bool>(mFile);
+        mFile.close();
+        return good;
+    }
+
+    bool isOpen() const { return static_cast<bool>(mFile); }
+
+private:
+    std::ofstream mFile;
+    std::vector<PositionEntry> mBuffer;
+    std::vector<std::uint64_t> mDirectory;
+    std::uint64_t mCount;
+    std::uint64_t mMaterialCount;
+    bool mMaterial; /* The directory is written */
+
+    void flush() {
+        mFile.write(reinterpret_cast<const char *>(mBuffer.data()), mBuffer.size() * sizeof(PositionEntry));
+        mBuffer.clear();
+    }
+};
+
+/* ##### PositionIndexBuilder ##### */
+PositionIndexBuilder::PositionIndexBuilder(std::size_t runEntries) : mRunEntries(std::max<std::size_t>(runEntries, 1)), mEntryCount(0), mMaterialCount(0), mGameCount(0), mOpen(false) {}
+
+PositionIndexBuilder::~PositionIndexBuilder() {
+    removeRuns();
+}
+
+bool PositionIndexBuilder::open(const std::string & path) {
+    /* Fail early if the index cannot be created */
+    if (!std::ofstream(path, std::ios::binary | std::ios::trunc)) return false;
+
+    removeRuns();
+    mPath = path;
+    mEntries.clear();
+    mMaterialEntries.clear();
+    mEntryCount = 0;
+    mMaterialCount = 0;
+    mGameCount = 0;
+    mOpen = true;
+    return true;
+}
+
+bool PositionIndexBuilder::addGame(const GameArchive & archive, std::uint64_t index) {
+    if (!mOpen || index > std::numeric_limits<std::uint32_t>::max()) return false;
+    if (!archive.loadStartPosition(index, mBoard)) return false;
+
+    const ArchiveGameEntry & entry = archive.getEntry(index);
+    const std::uint8_t * encoded = archive.getMoveIndexes(index);
+    std::size_t first = mEntries.size();
+    std::size_t firstMaterial = mMaterialEntries.size();
+
+    /* The ply is 16 bits, longer games are only indexed up to it */
+    std::uint32_t plies = std::min<std::uint32_t>(entry.moveCount, std::numeric_limits<std::uint16_t>::max());
+    for (std::uint32_t ply = 0; ; ++ply) {
+        mEntries.push_back({computeZobristKey(mBoard), static_cast<std::uint32_t>(index), static_cast<std::uint16_t>(ply), entry.result, 0});
+
+        /* Only the first ply of each material, the material of most plies is the one of the ply before */
+        std::uint64_t material = materialSignature(mBoard);
+        if (mMaterialEntries.size() == firstMaterial || mMaterialEntries.back().key != material)
+            mMaterialEntries.push_back({material, static_cast<std::uint32_t>(index), static_cast<std::uint16_t>(ply), entry.result, 0});
+        if (ply == plies) break;
+
+        sortedLegalMoves(mBoard, mLegalMoves);
+        if (encoded[ply] >= mLegalMoves.size() || !mBoard.playMove(mLegalMoves[encoded[ply]])) {
+            mEntries.resize(first);
+            mMaterialEntries.resize(firstMaterial);
+            return false;
+        }
+    }
+
+    mEntryCount += mEntries.size() - first;
+    mMaterialCount += mMaterialEntries.size() - firstMaterial;
+    ++mGameCount;
+    if (mEntries.size() >= mRunEntries && !writeRun(mEntries, mRuns, "run")) return false;
+    if (mMaterialEntries.size() >= mRunEntries && !writeRun(mMaterialEntries, mMaterialRuns, "material")) return false;
+    return true;
+}
+
+/* Sorts the entries in memory and spills them to a new run file */
+bool PositionIndexBuilder::writeRun(std::vector<PositionEntry> & entries, std::vector<std::string> & runs, const char * name) {
+    std::sort(entries.begin(), entries.end(), entryLess);
+
+    std::string path = mPath + "." + name + std::to_string(runs.size());
+    std::ofstream run(path, std::ios::binary | std::ios::trunc);
+    runs.push_back(path);
+    run.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(PositionEntry));
+    entries.clear();
+    return static_cast<bool>(run);
+}
+
+void PositionIndexBuilder::removeRuns() {
+    for (const std::string & run : mRuns) std::remove(run.c_str());
+    for (const std::string & run : mMaterialRuns) std::remove(run.c_str());
+    mRuns.clear();
+    mMaterialRuns.clear();
+}
+
+/* Passes the entries to write in order. Without runs they are sorted in memory, otherwise the runs are merged, always taking the smallest entry at the head of a run */
+template <typename Write>
+static void writeSorted(std::vector<PositionEntry> & entries, const std::vector<std::string> & runs, Write write) {
+    if (runs.empty()) {
+        std::sort(entries.begin(), entries.end(), entryLess);
+        for (const PositionEntry & entry : entries) write(entry);
+        entries.clear();
+        return;
+    }
+
+    std::vector<std::unique_ptr<PositionRunReader>> readers;
+    using Head = std::pair<PositionEntry, std::size_t>;
+    auto greater = [](const Head & a, const Head & b) { return entryLess(b.first, a.first); };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+
+    for (const std::string & run : runs) {
+        readers.push_back(std::make_unique<PositionRunReader>(run));
+        PositionEntry entry;
+        if (readers.back()->next(entry)) heads.push({entry, readers.size() - 1});
+    }
+
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        write(head.first);
+        if (readers[head.second]->next(head.first)) heads.push(head);
+    }
+}
+
+bool PositionIndexBuilder::close() {
+    if (!mOpen) return false;
+    mOpen = false;
+
+    PositionIndexWriter writer(mPath);
+    if (!writer.isOpen()) return false;
+
+    /* What is left in memory goes to a last run when the others were spilled */
+    if ((!mRuns.empty() && !mEntries.empty() && !writeRun(mEntries, mRuns, "run"))
+        || (!mMaterialRuns.empty() && !mMaterialEntries.empty() && !writeRun(mMaterialEntries, mMaterialRuns, "material"))) {
+        removeRuns();
+        return false;
+    }
+
+    writeSorted(mEntries, mRuns, [&writer](const PositionEntry & entry) { writer.write(entry); });
+    writer.beginMaterial();
+    writeSorted(mMaterialEntries, mMaterialRuns, [&writer](const PositionEntry & entry) { writer.writeMaterial(entry); });
+
+    removeRuns();
+    return writer.finish(mGameCount);
+}
+
+/* ##### PositionIndex ##### */
+PositionIndex::PositionIndex() : mHeader(nullptr), mEntries(nullptr), mDirectory(nullptr), mMaterial(nullptr) {}
+
+bool PositionIndex::open(const std::string & path) {
+    close();
+    if (!mFile.open(path)) return false;
+
+    const char * data = mFile.getData();
+    std::uint64_t size = mFile.getSize();
+    if (size < sizeof(PositionIndexHeader)) { close(); return false; }
+
+    const PositionIndexHeader * header = reinterpret_cast<const PositionIndexHeader *>(data);
+    std::uint64_t directorySize = ((std::uint64_t(1) << POSITION_INDEX_BUCKET_BITS) + 1) * sizeof(std::uint64_t);
+    bool valid = std::memcmp(header->magic, POSITION_INDEX_MAGIC, sizeof(header->magic)) == 0 && header->version == POSITION_INDEX_VERSION
+        && header->bucketBits == POSITION_INDEX_BUCKET_BITS
+        && header->entriesOffset % 8 == 0 && header->entriesOffset <= size && header->entryCount <= (size - header->entriesOffset) / sizeof(PositionEntry)
+        && header->directoryOffset % 8 == 0 && header->directoryOffset <= size && directorySize <= size - header->directoryOffset
+        && header->materialOffset % 8 == 0 && header->materialOffset <= size && header->materialCount <= (size - header->materialOffset) / sizeof(PositionEntry);
+    if (!valid) { close(); return false; }
+
+    mHeader = header;
+    mEntries = reinterpret_cast<const PositionEntry *>(data + header->entriesOffset);
+    mDirectory = reinterpret_cast<const std::uint64_t *>(data + header->directoryOffset);
+    mMaterial = reinterpret_cast<const PositionEntry *>(data + header->materialOffset);
+
+    if (mDirectory[std::size_t(1) << POSITION_INDEX_BUCKET_BITS] != header->entryCount) { close(); return false; }
+    return true;
+}
+
+void PositionIndex::close() {
+    mFile.close();
+    mHeader = nullptr;
+    mEntries = nullptr;
+    mDirectory = nullptr;
+    mMaterial = nullptr;
+}
+
+std::pair<const PositionEntry *, const PositionEntry *> PositionIndex::find(std::uint64_t key) const {
+    if (!mHeader) return {nullptr, nullptr};
+
+    std::uint64_t bucket = key >> (64 - POSITION_INDEX_BUCKET_BITS);
+    std::uint64_t begin = std::min(mDirectory[bucket], mHeader->entryCount);
+    std::uint64_t end = std::min(std::max(mDirectory[bucket + 1], begin), mHeader->entryCount);
+
+    const PositionEntry * first = std::lower_bound(mEntries + begin, mEntries + end, key, [](const PositionEntry & entry, std::uint64_t value) { return entry.key < value; });
+    const PositionEntry * last = std::upper_bound(first, mEntries + end, key, [](std::uint64_t value, const PositionEntry & entry) { return value < entry.key; });
+    return {first, last};
+}
+
+std::pair<const PositionEntry *, const PositionEntry *> PositionIndex::findMaterial(std::uint64_t signature) const {
+    if (!mHeader) return {nullptr, nullptr};
+
+    const PositionEntry * end = mMaterial + mHeader->materialCount;
+    const PositionEntry * first = std::lower_bound(mMaterial, end, signature, [](const PositionEntry & entry, std::uint64_t value) { return entry.key < value; });
+    const PositionEntry * last = std::upper_bound(first, end, signature, [](std::uint64_t value, const PositionEntry & entry) { return value < entry.key; });
+    return {first, last};
+}
+
+/* Copies up to maxMatches entries of a range and counts its games */
+static void collectMatches(std::pair<const PositionEntry *, const PositionEntry *> range, std::vector<PositionEntry> & matches, PositionStats & stats, std::size_t maxMatches) {
+    stats.occurrences = range.second - range.first;
+
+    /* The entries of a position are sorted by game, so repeated visits of a game are next to each other */
+    const PositionEntry * previous = nullptr;
+    for (const PositionEntry * entry = range.first; entry != range.second; ++entry) {
+        if (matches.size() < maxMatches) matches.push_back(*entry);
+        if (previous && previous->game == entry->game) continue;
+        previous = entry;
+
+        ++stats.games;
+        switch (static_cast<ArchiveResult>(entry->result)) {
+            case ArchiveResult::WhiteWins: ++stats.whiteWins; break;
+            case ArchiveResult::BlackWins: ++stats.blackWins; break;
+            case ArchiveResult::Draw: ++stats.draws; break;
+            default: ++stats.unknown; break;
+        }
+    }
+}
+
+bool PositionIndex::query(const std::string & fen, std::vector<PositionEntry> & matches, PositionStats & stats, std::size_t maxMatches) const {
+    matches.clear();
+    stats = PositionStats();
+
+    Board board;
+    if (board.parseFEN(fen) != FENError::None) return false;
+
+    collectMatches(find(computeZobristKey(board)), matches, stats, maxMatches);
+    return true;
+}
+
+bool PositionIndex::queryMaterial(std::string_view material, std::vector<PositionEntry> & matches, PositionStats & stats, std::size_t maxMatches) const {
+    matches.clear();
+    stats = PositionStats();
+
+    std::uint64_t signature;
+    if (!parseMaterialSignature(material, signature)) return false;
+
+    collectMatches(findMaterial(signature), matches, stats, maxMatches);
+    return true;
+}
@@ -0,0 +1,76 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cstring>
+
+/* Include other defined headers */
+#include "PositionSet.hpp"
+
+static_assert(sizeof(PackedBoard) == 32, "Unexpected PackedBoard layout");
+
+/* Maximum load, as numerator over 10: linear probing slows down quickly above it */
+static const std::size_t MAX_LOAD_TENTHS = 7;
+
+/* The four 64 bit words of the position, mixed with the finalizer of MurmurHash3 */
+static std::uint64_t mix(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+std::uint64_t hashPackedBoard(const PackedBoard & packed) {
+    std::uint64_t words[4];
+    std::memcpy(words, &packed, sizeof(words));
+    std::uint64_t hash = mix(words[0]);
+    hash = mix(hash ^ words[1]);
+    hash = mix(hash ^ words[2]);
+    return mix(hash ^ words[3]);
+}
+
+PositionSet::PositionSet(std::size_t expected) : mMask(0), mSize(0) {
+    rehash(16);
+    reserve(expected);
+}
+
+void PositionSet::reserve(std::size_t expected) {
+    std::size_t capacity = mSlots.size();
+    while (expected * 10 > capacity * MAX_LOAD_TENTHS) capacity *= 2;
+    if (capacity != mSlots.size()) rehash(capacity);
+}
+
+void PositionSet::clear() {
+    std::fill(mSlots.begin(), mSlots.end(), PackedBoard());
+    mSize = 0;
+}
+
+/* Slot of the position, or the empty slot where it would be inserted */
+std::size_t PositionSet::findSlot(const PackedBoard & packed) const {
+    std::size_t slot = hashPackedBoard(packed) & mMask;
+    while (mSlots[slot].occupancy && mSlots[slot] != packed) slot = (slot + 1) & mMask;
+    return slot;
+}
+
+bool PositionSet::insert(const PackedBoard & packed) {
+    if (!packed.occupancy) return false;
+    if ((mSize + 1) * 10 > mSlots.size() * MAX_LOAD_TENTHS) rehash(mSlots.size() * 2);
+
+    std::size_t slot = findSlot(packed);
+    if (mSlots[slot].occupancy) return false;
+    mSlots[slot] = packed;
+    ++mSize;
+    return true;
+}
+
+bool PositionSet::contains(const PackedBoard & packed) const {
+    return packed.occupancy && mSlots[findSlot(packed)].occupancy;
+}
+
+void PositionSet::rehash(std::size_t capacity) {
+    std::vector<PackedBoard> old(capacity, PackedBoard());
+    old.swap(mSlots);
+    mMask = capacity - 1;
+    for (const PackedBoard & packed : old)
+        if (packed.occupancy) mSlots[findSlot(packed)] = packed;
+}
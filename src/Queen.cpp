@@ -15,8 +15,8 @@
 std::array<const int, 8> Queen::mOffsets = {-9, -8, -7, -1, +1, +7, +8, +9};
 
 /* Clone method to allow the piece to be copied into a new memory location. Useful for creating a copy of Board */
-Piece * Queen::clone(Board* newBoard) const {
-    Piece * copy = new Queen(getColor(), getPosition(), newBoard);
+Piece * Queen::clone(Board* newBoard, void * memory) const {
+    Piece * copy = new (memory) Queen(getColor(), getPosition(), newBoard);
     copy->validMoves = validMoves;
     return copy;
 }
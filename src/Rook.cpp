@@ -15,8 +15,9 @@
 std::array<const int, 4> Rook::mOffsets = {-8, -1, +1, +8};
 
 /* Clone method to allow the piece to be copied into a new memory location. Useful for creating a copy of Board */
-Piece * Rook::clone(Board* newBoard) const {
-    Piece * copy = new Rook(getColor(), getPosition(), newBoard);
+Piece * Rook::clone(Board* newBoard, void * memory) const {
+    Piece * copy = new (memory) Rook(getColor(), getPosition(), newBoard);
+    copy->setHasMoved(getHasMoved()); /* Keeps the castling rights */
     copy->validMoves = validMoves;
     return copy;
 }
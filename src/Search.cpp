@@ -0,0 +1,369 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <numeric>
+#include <optional>
+
+/* Include other defined headers */
+#include "Search.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
+#include "Evaluation.hpp"
+#include "Zobrist.hpp"
+
+static const Move NO_MOVE = {-1, -1, PieceType::Empty};
+
+/* ##### Helpers ##### */
+static bool isNoMove(const Move & move) {
+    return move.from < 0;
+}
+
+/* Mate and tablebase scores are stored relative to the node, so the same entry is right at any distance from the root */
+static int scoreToTable(int score, int ply) {
+    if (score > TB_WIN_BOUND) return score + ply;
+    if (score < -TB_WIN_BOUND) return score - ply;
+    return score;
+}
+
+static int scoreFromTable(int score, int ply) {
+    if (score > TB_WIN_BOUND) return score - ply;
+    if (score < -TB_WIN_BOUND) return score + ply;
+    return score;
+}
+
+static bool isCapture(const Board & board, const Move & move) {
+    const Piece * piece = board.board[move.from];
+    return board.board[move.to] != nullptr || (piece->getType() == PieceType::Pawn && move.to == board.getEnPassantIndex());
+}
+
+static bool isInCheck(const Board & board) {
+    const King * king = board.getKing(board.getTurn());
+    return king && king->isChecked();
+}
+
+/* ##### Search ##### */
+Search::Search(std::size_t hashMegabytes) : mTable(hashMegabytes), mBook(nullptr), mTablebase(nullptr), mProbeDepth(1), mProbeLimit(TB_MAX_PIECES), mStop(false), mAborted(false), mRootBest(NO_MOVE), mMoveLists(MAX_SEARCH_PLY + 1), mMoveScores(MAX_SEARCH_PLY + 1) {
+    clear();
+}
+
+void Search::clear() {
+    mTable.clear();
+    for (auto & killers : mKillers) killers.fill(NO_MOVE);
+}
+
+void Search::setBook(const PolyglotBook * book, std::uint64_t seed) {
+    mBook = book;
+    mRandom.seed(seed);
+}
+
+void Search::setTablebase(const Tablebase * tablebase, int probeDepth, int probeLimit) {
+    mTablebase = tablebase;
+    mProbeDepth = probeDepth;
+    mProbeLimit = probeLimit;
+}
+
+SearchResult Search::think(const Board & board, const SearchLimits & limits, const std::vector<std::uint64_t> & history) {
+    TRACE_ZONE("search", "think");
+    mStats = SearchStats();
+    mLimits = limits;
+    mStop = false;
+    mAborted = false;
+    mStart = std::chrono::steady_clock::now();
+    mTable.newSearch();
+    for (auto & killers : mKillers) killers.fill(NO_MOVE);
+
+    SearchResult result;
+    std::vector<Move> rootMoves;
+    board.generateLegalMoves(rootMoves);
+    if (rootMoves.empty()) return result;
+
+    /* Known openings are a table lookup */
+    if (limits.useBook && mBook && mBook->pickMove(board, mRandom, result.bestMove)) {
+        result.fromBook = true;
+        result.pv.push_back(result.bestMove);
+        return result;
+    }
+
+    /* Only the moves that keep the tablebase result are searched, the search picks the best of them */
+    mRootMoves = rootMoves;
+    WDLScore wdl;
+    if (limits.useTablebase && mTablebase && mTablebase->filterRootMoves(board, mRootMoves, wdl)) ++mStats.tbHits;
+
+    mKeys = history;
+    int maxDepth = std::clamp(limits.depth, 1, MAX_SEARCH_DEPTH);
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        TRACE_ZONE("search", "iteration");
+        mRootBest = NO_MOVE;
+        int score = searchNode(board, depth, -INFINITE_SCORE, INFINITE_SCORE, 0);
+
+        /* An unfinished iteration is discarded, unless it is the first one */
+        if (mAborted) {
+            if (isNoMove(result.bestMove)) result.bestMove = isNoMove(mRootBest) ? mRootMoves.front() : mRootBest;
+            break;
+        }
+
+        result.bestMove = isNoMove(mRootBest) ? mRootMoves.front() : mRootBest;
+        result.score = score;
+        result.depth = depth;
+        extractPV(board, depth, result.pv);
+        if (result.pv.empty() || !(result.pv.front() == result.bestMove)) result.pv.assign(1, result.bestMove);
+
+        mStats.depth = depth;
+        mStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+        if (mInfoCallback) mInfoCallback(result, mStats);
+
+        /* A mate found within the depth cannot get better */
+        if (std::abs(score) > MATE_BOUND && MATE_SCORE - std::abs(score) <= depth) break;
+
+        /* The next iteration takes longer than all the previous ones, do not start what cannot finish */
+        if (mLimits.seconds > 0.0 && mStats.seconds > mLimits.seconds * 0.5) break;
+    }
+
+    mStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+
+    /* The totals of the process, added once per search instead of at every node */
+    EngineMetrics & metrics = engineMetrics();
+    metrics.searchNodes.add(mStats.nodes);
+    metrics.ttProbes.add(mStats.ttProbes);
+    metrics.ttHits.add(mStats.ttHits);
+    metrics.cutoffs.add(mStats.cutoffs);
+    metrics.evalCalls.add(mStats.evalCalls);
+    return result;
+}
+
+/* The limits are checked every 64 nodes for the time, as reading the clock is slower than a node */
+bool Search::shouldStop() {
+    if (mAborted) return true;
+
+    if (mStop.load(std::memory_order_relaxed)) mAborted = true;
+    else if (mLimits.nodes && mStats.nodes >= mLimits.nodes) mAborted = true;
+    else if (mLimits.seconds > 0.0 && (mStats.nodes & 63) == 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count() >= mLimits.seconds) mAborted = true;
+
+    return mAborted;
+}
+
+/* A position repeated since the last capture or pawn move is scored as a draw, as the side that can repeat it could keep doing so */
+bool Search::isRepetition(std::uint64_t key, int halfMoveClock) const {
+    int size = static_cast<int>(mKeys.size());
+    for (int i = size - 2; i >= 0 && i >= size - halfMoveClock; i -= 2) {
+        if (mKeys[i] == key) return true;
+    }
+    return false;
+}
+
+/* Positions right after a capture or pawn move are probed, as the tables do not know the 50-move counter. Wins are scored below the mates, and the cursed ones (won but for the 50-move rule) as draws */
+bool Search::probeTablebase(const Board & board, int depth, int ply, int & score) {
+    if (!mTablebase || !mLimits.useTablebase || ply == 0 || board.getHalfMoveClock() != 0) return false;
+
+    int pieceCount = 0;
+    for (const Piece * piece : board.board) pieceCount += piece != nullptr;
+    int limit = std::min(mProbeLimit, mTablebase->getMaxPieces());
+    if (pieceCount > limit || (pieceCount == limit && depth < mProbeDepth)) return false;
+
+    WDLScore wdl;
+    if (!mTablebase->probeWDL(board, wdl)) return false;
+    ++mStats.tbHits;
+
+    switch (wdl) {
+        case WDLScore::Win: score = TB_WIN_SCORE - ply; break;
+        case WDLScore::Loss: score = -TB_WIN_SCORE + ply; break;
+        case WDLScore::CursedWin: score = 1; break;
+        case WDLScore::BlessedLoss: score = -1; break;
+        default: score = 0; break;
+    }
+    return true;
+}
+
+void Search::orderMoves(const Board & board, std::vector<Move> & moves, const Move & ttMove, int ply) {
+    std::vector<int> & scores = mMoveScores[ply];
+    scores.resize(moves.size());
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        const Move & move = moves[i];
+        int score = 0;
+        if (move == ttMove) score = 1000000;
+        else if (isCapture(board, move)) {
+            const Piece * victim = board.board[move.to];
+            score = 100000 + 10 * pieceValue(victim ? victim->getType() : PieceType::Pawn) - pieceValue(board.board[move.from]->getType()) / 10;
+        }
+        else if (move.promotion == PieceType::Queen) score = 90000;
+        else if (move == mKillers[ply][0]) score = 80000;
+        else if (move == mKillers[ply][1]) score = 79000;
+        scores[i] = score;
+    }
+
+    /* Sort the moves by their scores, keeping the generation order of ties so the search is deterministic */
+    std::vector<std::size_t> order(moves.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return scores[a] > scores[b]; });
+
+    std::vector<Move> sorted;
+    sorted.reserve(moves.size());
+    for (std::size_t index : order) sorted.push_back(moves[index]);
+    moves.swap(sorted);
+}
+
+int Search::searchNode(const Board & board, int depth, int alpha, int beta, int ply) {
+    if (depth <= 0 || ply >= MAX_SEARCH_PLY) return quiescence(board, alpha, beta, ply);
+
+    ++mStats.nodes;
+    if (shouldStop()) return 0;
+
+    std::uint64_t key = computeZobristKey(board);
+    if (ply > 0 && (board.getHalfMoveClock() >= 100 || isRepetition(key, board.getHalfMoveClock()))) return 0;
+
+    /* Transposition table: the move is always useful for ordering, the score only if it was searched deep enough */
+    Move ttMove = NO_MOVE;
+    ++mStats.ttProbes;
+    if (const TTEntry * entry = mTable.probe(key)) {
+        ++mStats.ttHits;
+        ttMove = unpackMove(entry->move);
+
+        int score = scoreFromTable(entry->score, ply);
+        if (ply > 0 && entry->depth >= depth) {
+            if (entry->bound == Bound::Exact) return score;
+            if (entry->bound == Bound::Lower && score >= beta) return score;
+            if (entry->bound == Bound::Upper && score <= alpha) return score;
+        }
+    }
+
+    int tbScore;
+    if (probeTablebase(board, depth, ply, tbScore)) {
+        mTable.store(key, NO_MOVE, scoreToTable(tbScore, ply), std::min(depth + 6, MAX_SEARCH_DEPTH), Bound::Exact);
+        return tbScore;
+    }
+
+    std::vector<Move> & moves = mMoveLists[ply];
+    if (ply == 0) moves = mRootMoves;
+    else board.generateLegalMoves(moves);
+    bool inCheck = isInCheck(board);
+    if (moves.empty()) return inCheck ? -MATE_SCORE + ply : 0;
+
+    orderMoves(board, moves, ttMove, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove = NO_MOVE;
+    mKeys.push_back(key);
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        const Move move = moves[i]; /* Copied, the children reuse the move lists of deeper plies only */
+        Board child(board);
+        child.playMove(move);
+
+        /* Check extension: checks are searched one ply deeper, so forced sequences are not cut at the horizon */
+        int childDepth = depth - 1 + (isInCheck(child) ? 1 : 0);
+
+        /* Principal variation search: after the first move, prove the others are worse with a null window, and only search them fully if that fails */
+        int score;
+        if (i == 0) {
+            score = -searchNode(child, childDepth, -beta, -alpha, ply + 1);
+        } else {
+            score = -searchNode(child, childDepth, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta && !mAborted)
+                score = -searchNode(child, childDepth, -beta, -alpha, ply + 1);
+        }
+
+        if (mAborted) {
+            mKeys.pop_back();
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (score > alpha) {
+            alpha = score;
+            if (ply == 0) mRootBest = move;
+        }
+        if (alpha >= beta) {
+            ++mStats.cutoffs;
+            if (!isCapture(board, move) && !(move == mKillers[ply][0])) {
+                mKillers[ply][1] = mKillers[ply][0];
+                mKillers[ply][0] = move;
+            }
+            break;
+        }
+    }
+
+    mKeys.pop_back();
+
+    Bound bound = (bestScore >= beta) ? Bound::Lower : (bestScore > originalAlpha) ? Bound::Exact : Bound::Upper;
+    mTable.store(key, bestMove, scoreToTable(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+/* Quiescence search: only captures and Queen promotions are played, until the position is quiet enough for the static evaluation. In check, every evasion is searched instead */
+int Search::quiescence(const Board & board, int alpha, int beta, int ply) {
+    ++mStats.nodes;
+    ++mStats.qnodes;
+    if (ply > mStats.selDepth) mStats.selDepth = ply;
+    if (shouldStop()) return 0;
+
+    ++mStats.evalCalls;
+    if (ply >= MAX_SEARCH_PLY) return evaluate(board);
+
+    bool inCheck = isInCheck(board);
+    std::vector<Move> & moves = mMoveLists[ply];
+    board.generateLegalMoves(moves);
+    if (moves.empty()) return inCheck ? -MATE_SCORE + ply : 0;
+
+    int bestScore = -INFINITE_SCORE;
+    if (!inCheck) {
+        /* Stand pat: the side to move is not forced to capture */
+        bestScore = evaluate(board);
+        if (bestScore >= beta) return bestScore;
+        if (bestScore > alpha) alpha = bestScore;
+
+        moves.erase(std::remove_if(moves.begin(), moves.end(), [&](const Move & move) {
+            return !isCapture(board, move) && move.promotion != PieceType::Queen;
+        }), moves.end());
+    }
+
+    orderMoves(board, moves, NO_MOVE, ply);
+
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        const Move move = moves[i];
+        Board child(board);
+        child.playMove(move);
+
+        int score = -quiescence(child, -beta, -alpha, ply + 1);
+        if (mAborted) return 0;
+
+        if (score > bestScore) bestScore = score;
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) {
+            ++mStats.cutoffs;
+            break;
+        }
+    }
+
+    return bestScore;
+}
+
+/* Follows the table moves from the root. Boards are alternated as the positions are played, as each one is only needed until the next move */
+void Search::extractPV(const Board & board, int depth, std::vector<Move> & pv) const {
+    pv.clear();
+    std::optional<Board> positions[2];
+    const Board * current = &board;
+    std::vector<Move> legalMoves;
+    std::vector<std::uint64_t> seen;
+
+    for (int ply = 0; ply < depth; ++ply) {
+        std::uint64_t key = computeZobristKey(*current);
+        const TTEntry * entry = mTable.probe(key);
+        if (!entry || std::find(seen.begin(), seen.end(), key) != seen.end()) break;
+
+        Move move = unpackMove(entry->move);
+        current->generateLegalMoves(legalMoves);
+        if (std::find(legalMoves.begin(), legalMoves.end(), move) == legalMoves.end()) break;
+
+        seen.push_back(key);
+        pv.push_back(move);
+
+        positions[ply % 2].emplace(*current);
+        positions[ply % 2]->playMove(move);
+        current = &*positions[ply % 2];
+    }
+}
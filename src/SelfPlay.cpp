@@ -0,0 +1,275 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+/* Include other defined headers */
+#include "SelfPlay.hpp"
+#include "Notation.hpp"
+#include "Zobrist.hpp"
+
+static const char * INITIAL_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+/* ##### Openings ##### */
+static bool hasExtension(const std::string & path, const std::string & extension) {
+    if (path.size() < extension.size()) return false;
+    return std::equal(extension.rbegin(), extension.rend(), path.rbegin(), [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+}
+
+bool loadOpenings(const std::string & path, int plies, std::vector<Opening> & openings) {
+    openings.clear();
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    if (hasExtension(path, ".epd")) {
+        /* EPD: the first four FEN fields, followed by operations that are not needed here */
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string placement, turn, castling, enPassant;
+            if (!(fields >> placement >> turn >> castling >> enPassant)) continue;
+            openings.push_back({placement + " " + turn + " " + castling + " " + enPassant + " 0 1", {}});
+        }
+    }
+    else {
+        PGNReader reader(file);
+        PGNGame game;
+        while (reader.readGame(game)) {
+            const std::string * fen = game.findTag("FEN");
+            Opening opening;
+            opening.fen = fen ? *fen : INITIAL_FEN;
+            std::size_t count = std::min<std::size_t>(game.moves.size(), std::max(plies, 0));
+            opening.moves.assign(game.moves.begin(), game.moves.begin() + count);
+            openings.push_back(std::move(opening));
+        }
+    }
+
+    return !openings.empty();
+}
+
+bool randomOpening(int plies, std::mt19937_64 & random, Opening & opening) {
+    opening.fen.clear();
+    opening.moves.clear();
+
+    std::optional<Board> positions[2];
+    positions[0].emplace();
+    positions[0]->loadFromFEN();
+    std::vector<Move> moves;
+    for (int ply = 0; ply < plies; ++ply) {
+        const Board & board = *positions[ply % 2];
+        board.generateLegalMoves(moves);
+        if (moves.empty()) return false;
+
+        const Move & move = moves[random() % moves.size()];
+        positions[1 - ply % 2].emplace(board);
+        positions[1 - ply % 2]->playMove(move);
+
+        char san[SAN_BUFFER_SIZE];
+        if (!writeSAN(board, move, san, sizeof(san), &*positions[1 - ply % 2])) return false;
+        opening.moves.push_back(san);
+    }
+    return true;
+}
+
+/* ##### Adjudication ##### */
+const char * gameEndName(GameEnd end) {
+    switch (end) {
+        case GameEnd::None: return "none";
+        case GameEnd::Checkmate: return "checkmate";
+        case GameEnd::Stalemate: return "stalemate";
+        case GameEnd::Repetition: return "threefold repetition";
+        case GameEnd::FiftyMoves: return "50-move rule";
+        case GameEnd::InsufficientMaterial: return "insufficient material";
+        case GameEnd::Tablebase: return "tablebase";
+        case GameEnd::MaxLength: return "maximum length";
+        case GameEnd::Resignation: return "resignation";
+        case GameEnd::Abandoned: return "abandoned";
+    }
+    return "unknown";
+}
+
+/* Kings alone, or with a single Knight or Bishop */
+static bool isInsufficientMaterial(const Board & board) {
+    int minors = 0;
+    for (const Piece * piece : board.board) {
+        if (!piece) continue;
+        switch (piece->getType()) {
+            case PieceType::King: break;
+            case PieceType::Knight:
+            case PieceType::Bishop: ++minors; break;
+            default: return false;
+        }
+    }
+    return minors <= 1;
+}
+
+static const char * winner(Color color) {
+    return color == Color::White ? "1-0" : "0-1";
+}
+
+static Color opponent(Color color) {
+    return color == Color::White ? Color::Black : Color::White;
+}
+
+GameEnd adjudicate(const Board & board, const std::vector<std::uint64_t> & keys, const Tablebase * tablebase, std::string & result) {
+    Color turn = board.getTurn();
+
+    std::vector<Move> moves;
+    board.generateLegalMoves(moves);
+    if (moves.empty()) {
+        const King * king = board.getKing(turn);
+        if (king && king->isChecked()) {
+            result = winner(opponent(turn));
+            return GameEnd::Checkmate;
+        }
+        result = "1/2-1/2";
+        return GameEnd::Stalemate;
+    }
+
+    if (board.getHalfMoveClock() >= 100) {
+        result = "1/2-1/2";
+        return GameEnd::FiftyMoves;
+    }
+
+    /* Repetitions can only happen since the last capture or pawn move */
+    if (!keys.empty()) {
+        std::size_t first = keys.size() - 1 - std::min<std::size_t>(keys.size() - 1, board.getHalfMoveClock());
+        if (std::count(keys.begin() + first, keys.end(), keys.back()) >= 3) {
+            result = "1/2-1/2";
+            return GameEnd::Repetition;
+        }
+    }
+
+    if (isInsufficientMaterial(board)) {
+        result = "1/2-1/2";
+        return GameEnd::InsufficientMaterial;
+    }
+
+    WDLScore wdl;
+    if (tablebase && tablebase->probeWDL(board, wdl)) {
+        if (wdl == WDLScore::Win) result = winner(turn);
+        else if (wdl == WDLScore::Loss) result = winner(opponent(turn));
+        else result = "1/2-1/2";
+        return GameEnd::Tablebase;
+    }
+
+    return GameEnd::None;
+}
+
+/* ##### Games ##### */
+/* Positions are alternated between two boards, as each one is only needed until the next move */
+GameEnd playGame(const Opening & opening, Search & white, Search & black, const SelfPlayOptions & options, PGNGame & record, const SelfPlayCallback & callback) {
+    record.clear();
+    std::optional<Board> positions[2];
+    positions[0].emplace();
+    if (positions[0]->parseFEN(opening.fen.empty() ? INITIAL_FEN : opening.fen) != FENError::None) return GameEnd::None;
+    if (!opening.fen.empty() && opening.fen != INITIAL_FEN) {
+        record.tags.push_back({"SetUp", "1"});
+        record.tags.push_back({"FEN", opening.fen});
+    }
+
+    std::vector<std::uint64_t> keys;
+    keys.push_back(computeZobristKey(*positions[0]));
+    int current = 0;
+
+    auto play = [&](const Move & move) {
+        const Board & board = *positions[current];
+        positions[1 - current].emplace(board);
+        Board & after = *positions[1 - current];
+        if (!after.playMove(move)) return false;
+
+        char san[SAN_BUFFER_SIZE];
+        if (!writeSAN(board, move, san, sizeof(san), &after)) return false;
+        record.moves.push_back(san);
+        keys.push_back(computeZobristKey(after));
+        current = 1 - current;
+        return true;
+    };
+
+    for (const std::string & san : opening.moves) {
+        Move move;
+        if (!parseSAN(*positions[current], san, move) || !play(move)) return GameEnd::None;
+    }
+
+    white.clear();
+    black.clear();
+
+    for (;;) {
+        const Board & board = *positions[current];
+        GameEnd end = adjudicate(board, keys, options.tablebase, record.result);
+        if (end != GameEnd::None) return end;
+
+        if (static_cast<int>(record.moves.size()) >= options.maxPlies) {
+            record.result = "1/2-1/2";
+            return GameEnd::MaxLength;
+        }
+
+        /* The engine gets the previous positions, for its own repetition detection */
+        int side = board.getTurn() == Color::White ? 0 : 1;
+        Search & engine = side == 0 ? white : black;
+        std::vector<std::uint64_t> history(keys.begin(), keys.end() - 1);
+        SearchResult searched = engine.think(board, options.limits[side], history);
+        if (searched.bestMove.from < 0) return GameEnd::None;
+
+        if (callback) callback(board, searched);
+        if (!play(searched.bestMove)) return GameEnd::None;
+    }
+}
+
+/* ##### Match Statistics ##### */
+double scoreToElo(double score) {
+    score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double eloToScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double MatchScore::getScore() const {
+    std::uint64_t games = getGames();
+    return games ? (wins + 0.5 * draws) / games : 0.5;
+}
+
+double MatchScore::getElo() const {
+    return scoreToElo(getScore());
+}
+
+/* Variance of the score of a single game, from the observed wins, draws and losses */
+static double gameVariance(const MatchScore & match) {
+    double games = static_cast<double>(match.getGames());
+    double score = match.getScore();
+    return (match.wins * (1.0 - score) * (1.0 - score) + match.draws * (0.5 - score) * (0.5 - score) + match.losses * score * score) / games;
+}
+
+double MatchScore::getEloMargin() const {
+    std::uint64_t games = getGames();
+    if (games < 2) return 0.0;
+
+    double deviation = std::sqrt(gameVariance(*this) / games);
+    double score = getScore();
+    return (scoreToElo(score + 1.96 * deviation) - scoreToElo(score - 1.96 * deviation)) / 2.0;
+}
+
+double MatchScore::getLLR(double elo0, double elo1) const {
+    std::uint64_t games = getGames();
+    if (games < 2) return 0.0;
+
+    double variance = gameVariance(*this);
+    if (variance <= 0.0) return 0.0;
+
+    double score0 = eloToScore(elo0);
+    double score1 = eloToScore(elo1);
+    return games * (score1 - score0) * (2.0 * getScore() - score0 - score1) / (2.0 * variance);
+}
+
+double sprtLowerBound(double alpha, double beta) {
+    return std::log(beta / (1.0 - alpha));
+}
+
+double sprtUpperBound(double alpha, double beta) {
+    return std::log((1.0 - beta) / alpha);
+}
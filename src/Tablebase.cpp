@@ -0,0 +1,933 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+/* Include other defined headers */
+#include "Tablebase.hpp"
+#include "MappedFile.hpp"
+
+/* The probing code follows the layout of the Syzygy files, as described by their author (Ronald de Man) and in the chessprogramming wiki. Squares are numbered a1 = 0 to h8 = 63, as in the Board, and pieces are coded as in the files: 1 to 6 for the white Pawn to King, plus 8 for black */
+
+static const std::uint8_t WDL_MAGIC[4] = {0x71, 0xE8, 0x23, 0x5D};
+static const std::uint8_t DTZ_MAGIC[4] = {0xD7, 0x66, 0x0C, 0xA5};
+
+/* Flags of each compressed table */
+enum TableFlag {TB_STM = 1, TB_MAPPED = 2, TB_WIN_PLIES = 4, TB_LOSS_PLIES = 8, TB_WIDE = 16, TB_SINGLE_VALUE = 128};
+
+/* Rank of a root move that wins (or loses) for sure, whatever the 50-move counter */
+static const int MAX_DTZ = 1 << 18;
+
+/* ##### Encoding Tables ##### */
+static int mapPawns[64];
+static int mapB1H1H7[64];
+static int mapA1D1D4[64];
+static int mapKK[10][64];
+static std::uint64_t binomial[TB_MAX_PIECES][64];
+static std::uint64_t leadPawnIndex[TB_MAX_PIECES][64];
+static std::uint64_t leadPawnsSize[TB_MAX_PIECES][4];
+
+static int squareFile(int square) { return square & 7; }
+static int squareRank(int square) { return square >> 3; }
+static int flipFile(int square) { return square ^ 7; }
+static int flipRank(int square) { return square ^ 56; }
+
+/* Negative below the a1-h8 diagonal, positive above it */
+static int offDiagonal(int square) {
+    return squareRank(square) - squareFile(square);
+}
+
+static bool pawnsLess(int a, int b) {
+    return mapPawns[a] < mapPawns[b];
+}
+
+static void initEncodingTables() {
+    /* Squares below the a1-h8 diagonal to 0...27 */
+    int code = 0;
+    for (int square = 0; square < 64; ++square) {
+        if (offDiagonal(square) < 0) mapB1H1H7[square] = code++;
+    }
+
+    /* Squares of the a1-d1-d4 triangle to 0...9, the ones on the diagonal last */
+    std::vector<int> diagonal;
+    code = 0;
+    for (int square = 0; square <= 27; ++square) {
+        if (squareFile(square) > 3) continue;
+        if (offDiagonal(square) < 0) mapA1D1D4[square] = code++;
+        else if (offDiagonal(square) == 0) diagonal.push_back(square);
+    }
+    for (int square : diagonal) mapA1D1D4[square] = code++;
+
+    /* The 462 legal placements of two Kings with the first one in the triangle. With the first King on the diagonal, the second is not above it. Placements with both on the diagonal come last */
+    std::vector<std::pair<int, int>> bothOnDiagonal;
+    code = 0;
+    for (int index = 0; index < 10; ++index) {
+        for (int first = 0; first <= 27; ++first) {
+            if (squareFile(first) > 3 || offDiagonal(first) > 0 || mapA1D1D4[first] != index) continue;
+            for (int second = 0; second < 64; ++second) {
+                if (std::abs(squareFile(first) - squareFile(second)) <= 1 && std::abs(squareRank(first) - squareRank(second)) <= 1) continue;
+                if (offDiagonal(first) == 0 && offDiagonal(second) > 0) continue;
+                if (offDiagonal(first) == 0 && offDiagonal(second) == 0) bothOnDiagonal.emplace_back(index, second);
+                else mapKK[index][second] = code++;
+            }
+        }
+    }
+    for (const auto & placement : bothOnDiagonal) mapKK[placement.first][placement.second] = code++;
+
+    /* binomial[k][n]: ways to choose k squares out of n */
+    binomial[0][0] = 1;
+    for (int n = 1; n < 64; ++n) {
+        for (int k = 0; k < TB_MAX_PIECES && k <= n; ++k)
+            binomial[k][n] = (k > 0 ? binomial[k - 1][n - 1] : 0) + (k < n ? binomial[k][n - 1] : 0);
+    }
+
+    /* Pawn squares a2-h7 to 47...0, the ones nearer the edges and the lower ranks first. The leading pawn is the one with the highest value, and each file of the leading pawn has its own table */
+    int available = 47;
+    for (int count = 1; count < TB_MAX_PIECES; ++count) {
+        for (int file = 0; file < 4; ++file) {
+            std::uint64_t index = 0;
+            for (int rank = 1; rank <= 6; ++rank) {
+                int square = rank * 8 + file;
+                if (count == 1) {
+                    mapPawns[square] = available--;
+                    mapPawns[flipFile(square)] = available--;
+                }
+                leadPawnIndex[count][square] = index;
+                index += binomial[count - 1][mapPawns[square]];
+            }
+            leadPawnsSize[count][file] = index;
+        }
+    }
+}
+
+/* ##### Material ##### */
+/* Piece counts of both sides packed in 4 bits each, the White pieces in the low bits */
+static std::uint64_t materialKey(const int counts[2][7]) {
+    std::uint64_t key = 0;
+    for (int color = 0; color < 2; ++color) {
+        for (int type = 1; type <= 6; ++type)
+            key |= std::uint64_t(counts[color][type]) << (4 * (color * 7 + type));
+    }
+    return key;
+}
+
+static int pieceCode(const Piece * piece) {
+    return static_cast<int>(piece->getType()) + (piece->getColor() == Color::Black ? 8 : 0);
+}
+
+static std::uint64_t boardMaterialKey(const Board & board, int & pieceCount) {
+    int counts[2][7] = {};
+    pieceCount = 0;
+    for (int i = 0; i < 64; ++i) {
+        const Piece * piece = board.board[i];
+        if (!piece) continue;
+        ++counts[piece->getColor() == Color::Black ? 1 : 0][static_cast<int>(piece->getType())];
+        ++pieceCount;
+    }
+    return materialKey(counts);
+}
+
+/* Piece counts of a table name such as KRPvKR, the first side being White. False if it is not a table name */
+static bool parseTableName(const std::string & name, int counts[2][7]) {
+    std::memset(counts, 0, sizeof(int) * 14);
+    int side = 0;
+    for (char c : name) {
+        switch (c) {
+            case 'v': if (++side > 1) return false; break;
+            case 'P': ++counts[side][1]; break;
+            case 'N': ++counts[side][2]; break;
+            case 'B': ++counts[side][3]; break;
+            case 'R': ++counts[side][4]; break;
+            case 'Q': ++counts[side][5]; break;
+            case 'K': ++counts[side][6]; break;
+            default: return false;
+        }
+    }
+    return side == 1 && counts[0][6] == 1 && counts[1][6] == 1;
+}
+
+/* ##### Byte Readers ##### */
+static std::uint16_t readLE16(const std::uint8_t * data) {
+    return std::uint16_t(data[0] | (data[1] << 8));
+}
+
+static std::uint32_t readLE32(const std::uint8_t * data) {
+    return std::uint32_t(data[0]) | (std::uint32_t(data[1]) << 8) | (std::uint32_t(data[2]) << 16) | (std::uint32_t(data[3]) << 24);
+}
+
+static std::uint64_t readBE64(const std::uint8_t * data) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value = (value << 8) | data[i];
+    return value;
+}
+
+static std::uint32_t readBE32(const std::uint8_t * data) {
+    return (std::uint32_t(data[0]) << 24) | (std::uint32_t(data[1]) << 16) | (std::uint32_t(data[2]) << 8) | std::uint32_t(data[3]);
+}
+
+/* ##### Tables ##### */
+/* One compressed table: the values of every position of a side to move (and file of the leading pawn), as a sequence of symbols compressed by recursive pairing and then Huffman coded in blocks */
+struct PairsData {
+    int flags = 0;
+    int minSymLen = 0;
+    int maxSymLen = 0;
+    std::uint32_t numBlocks = 0;
+    std::uint64_t blockSize = 0;
+    std::uint64_t span = 0;
+    std::uint64_t sparseIndexSize = 0;
+    std::uint64_t blockLengthSize = 0;
+    const std::uint8_t * sparseIndex = nullptr; /* 4 bytes block, 2 bytes offset per entry */
+    const std::uint8_t * blockLength = nullptr; /* 16 bits per block */
+    const std::uint8_t * data = nullptr;
+    const std::uint8_t * lowestSym = nullptr;
+    const std::uint8_t * btree = nullptr;       /* 3 bytes per symbol: two 12 bit children */
+    std::vector<std::uint64_t> base64;
+    std::vector<std::uint8_t> symLen;
+    int pieces[TB_MAX_PIECES] = {};
+    std::uint64_t groupIndex[TB_MAX_PIECES + 1] = {};
+    int groupLen[TB_MAX_PIECES + 1] = {};
+    std::uint16_t mapIndex[4] = {};             /* DTZ value maps of each WDL result */
+};
+
+struct TBTable {
+    std::string path;
+    bool dtz = false;
+    std::uint64_t key = 0;  /* Material with the first side of the name as White */
+    std::uint64_t key2 = 0; /* And as Black */
+    int pieceCount = 0;
+    bool hasPawns = false;
+    bool hasUniquePieces = false;
+    int pawnCount[2] = {};  /* Leading side first */
+    std::atomic<bool> ready{false};
+    bool valid = false;
+    MappedFile file;
+    const std::uint8_t * map = nullptr;
+    PairsData items[2][4];  /* [side to move][file of the leading pawn] */
+
+    PairsData * get(int stm, int file) { return &items[dtz ? 0 : stm % 2][hasPawns ? file : 0]; }
+};
+
+static std::uint16_t symbolLeft(const PairsData & d, int symbol) {
+    const std::uint8_t * lr = d.btree + 3 * symbol;
+    return std::uint16_t(((lr[1] & 0xF) << 8) | lr[0]);
+}
+
+static std::uint16_t symbolRight(const PairsData & d, int symbol) {
+    const std::uint8_t * lr = d.btree + 3 * symbol;
+    return std::uint16_t((lr[2] << 4) | (lr[1] >> 4));
+}
+
+/* Number of values a symbol expands to, minus one. Leaves have no right child */
+static int setSymbolLength(PairsData & d, int symbol, std::vector<bool> & visited) {
+    visited[symbol] = true;
+    int right = symbolRight(d, symbol);
+    if (right == 0xFFF) return 0;
+
+    int left = symbolLeft(d, symbol);
+    if (left >= static_cast<int>(d.symLen.size()) || right >= static_cast<int>(d.symLen.size())) return 0;
+    if (!visited[left]) d.symLen[left] = std::uint8_t(setSymbolLength(d, left, visited));
+    if (!visited[right]) d.symLen[right] = std::uint8_t(setSymbolLength(d, right, visited));
+    return d.symLen[left] + d.symLen[right] + 1;
+}
+
+/* Groups of identical pieces, encoded together, and the factor of each group in the index */
+static void setGroups(const TBTable & table, PairsData & d, const int order[2], int file) {
+    int n = 0;
+    int firstLen = table.hasPawns ? 0 : table.hasUniquePieces ? 3 : 2;
+    d.groupLen[n] = 1;
+
+    for (int i = 1; i < table.pieceCount; ++i) {
+        if (--firstLen > 0 || d.pieces[i] == d.pieces[i - 1]) d.groupLen[n]++;
+        else d.groupLen[++n] = 1;
+    }
+    d.groupLen[++n] = 0;
+
+    /* The groups are not multiplied in the order of the pieces: the leading group and the other side pawns have their own place */
+    bool bothPawns = table.hasPawns && table.pawnCount[1];
+    int next = bothPawns ? 2 : 1;
+    int freeSquares = 64 - d.groupLen[0] - (bothPawns ? d.groupLen[1] : 0);
+    std::uint64_t index = 1;
+
+    for (int k = 0; next < n || k == order[0] || k == order[1]; ++k) {
+        if (k == order[0]) {
+            d.groupIndex[0] = index;
+            index *= table.hasPawns ? leadPawnsSize[d.groupLen[0]][file] : table.hasUniquePieces ? 31332 : 462;
+        }
+        else if (k == order[1]) {
+            d.groupIndex[1] = index;
+            index *= binomial[d.groupLen[1]][48 - d.groupLen[0]];
+        }
+        else {
+            d.groupIndex[next] = index;
+            index *= binomial[d.groupLen[next]][freeSquares];
+            freeSquares -= d.groupLen[next++];
+        }
+    }
+    d.groupIndex[n] = index;
+}
+
+/* Reads the compression parameters of a table. Returns nullptr if they do not fit in the file */
+static const std::uint8_t * setSizes(PairsData & d, const std::uint8_t * data, const std::uint8_t * end) {
+    if (data + 1 > end) return nullptr;
+    d.flags = *data++;
+
+    if (d.flags & TB_SINGLE_VALUE) {
+        if (data + 1 > end) return nullptr;
+        d.numBlocks = 0;
+        d.blockLengthSize = 0;
+        d.span = 0;
+        d.sparseIndexSize = 0;
+        d.minSymLen = *data++; /* The value of every position */
+        return data;
+    }
+
+    if (data + 10 > end) return nullptr;
+    int groups = 0;
+    while (d.groupLen[groups]) ++groups;
+    std::uint64_t tableSize = d.groupIndex[groups];
+
+    d.blockSize = std::uint64_t(1) << *data++;
+    d.span = std::uint64_t(1) << *data++;
+    d.sparseIndexSize = (tableSize + d.span - 1) / d.span;
+    int padding = *data++;
+    d.numBlocks = readLE32(data);
+    data += 4;
+    d.blockLengthSize = std::uint64_t(d.numBlocks) + padding;
+    d.maxSymLen = *data++;
+    d.minSymLen = *data++;
+    d.lowestSym = data;
+    if (d.maxSymLen < d.minSymLen || d.maxSymLen > 64) return nullptr;
+
+    /* Canonical Huffman code: longer codes have lower values, so base64[i] holds the lowest code of length minSymLen + i, left aligned on 64 bits */
+    std::size_t lengths = d.maxSymLen - d.minSymLen + 1;
+    if (data + 2 * lengths + 2 > end) return nullptr;
+    d.base64.assign(lengths, 0);
+    for (int i = static_cast<int>(lengths) - 2; i >= 0; --i)
+        d.base64[i] = (d.base64[i + 1] + readLE16(d.lowestSym + 2 * i) - readLE16(d.lowestSym + 2 * (i + 1))) / 2;
+    for (std::size_t i = 0; i < lengths; ++i)
+        d.base64[i] <<= 64 - i - d.minSymLen;
+
+    data += 2 * lengths;
+    d.symLen.assign(readLE16(data), 0);
+    data += 2;
+    d.btree = data;
+    if (data + 3 * d.symLen.size() > end) return nullptr;
+
+    std::vector<bool> visited(d.symLen.size());
+    for (std::size_t symbol = 0; symbol < d.symLen.size(); ++symbol) {
+        if (!visited[symbol]) d.symLen[symbol] = std::uint8_t(setSymbolLength(d, static_cast<int>(symbol), visited));
+    }
+
+    return data + 3 * d.symLen.size() + (d.symLen.size() & 1);
+}
+
+static const std::uint8_t * alignTo(const std::uint8_t * data, const std::uint8_t * base, std::size_t alignment) {
+    std::size_t offset = static_cast<std::size_t>(data - base);
+    return base + (offset + alignment - 1) / alignment * alignment;
+}
+
+/* DTZ values are stored by frequency, the maps give them back for each WDL result */
+static const std::uint8_t * setDTZMap(TBTable & table, const std::uint8_t * data, const std::uint8_t * base, int maxFile) {
+    table.map = data;
+    for (int file = 0; file <= maxFile; ++file) {
+        PairsData * d = table.get(0, file);
+        if (!(d->flags & TB_MAPPED)) continue;
+
+        if (d->flags & TB_WIDE) {
+            data = alignTo(data, base, 2);
+            for (int i = 0; i < 4; ++i) {
+                d->mapIndex[i] = std::uint16_t((data - table.map) / 2 + 1);
+                data += 2 * readLE16(data) + 2;
+            }
+        }
+        else {
+            for (int i = 0; i < 4; ++i) {
+                d->mapIndex[i] = std::uint16_t(data - table.map + 1);
+                data += *data + 1;
+            }
+        }
+    }
+    return alignTo(data, base, 2);
+}
+
+/* Reads the table header: the order of the pieces, the groups, then the compression parameters and the position of the data of each table. The offsets in the file are relative to its start, which is 64 byte aligned by the mapping */
+static bool parseTable(TBTable & table, const std::uint8_t * base, const std::uint8_t * end) {
+    const std::uint8_t * data = base + 4;
+    if (data >= end) return false;
+
+    bool split = (*data & 1) != 0;
+    bool hasPawns = (*data & 2) != 0;
+    if (hasPawns != table.hasPawns || (!table.dtz && split != (table.key != table.key2))) return false;
+    ++data;
+
+    int sides = (!table.dtz && table.key != table.key2) ? 2 : 1;
+    int maxFile = table.hasPawns ? 3 : 0;
+    bool bothPawns = table.hasPawns && table.pawnCount[1];
+
+    for (int file = 0; file <= maxFile; ++file) {
+        if (data + 1 + bothPawns + table.pieceCount > end) return false;
+
+        int order[2][2] = {{*data & 0xF, bothPawns ? *(data + 1) & 0xF : 0xF}, {*data >> 4, bothPawns ? *(data + 1) >> 4 : 0xF}};
+        data += 1 + bothPawns;
+
+        for (int k = 0; k < table.pieceCount; ++k, ++data) {
+            for (int i = 0; i < sides; ++i) table.get(i, file)->pieces[k] = i ? *data >> 4 : *data & 0xF;
+        }
+        for (int i = 0; i < sides; ++i) setGroups(table, *table.get(i, file), order[i], file);
+    }
+
+    data = alignTo(data, base, 2);
+
+    for (int file = 0; file <= maxFile; ++file) {
+        for (int i = 0; i < sides; ++i) {
+            data = setSizes(*table.get(i, file), data, end);
+            if (!data) return false;
+        }
+    }
+
+    if (table.dtz) data = setDTZMap(table, data, base, maxFile);
+
+    for (int file = 0; file <= maxFile; ++file) {
+        for (int i = 0; i < sides; ++i) {
+            PairsData * d = table.get(i, file);
+            d->sparseIndex = data;
+            data += d->sparseIndexSize * 6;
+        }
+    }
+
+    for (int file = 0; file <= maxFile; ++file) {
+        for (int i = 0; i < sides; ++i) {
+            PairsData * d = table.get(i, file);
+            d->blockLength = data;
+            data += d->blockLengthSize * 2;
+        }
+    }
+
+    for (int file = 0; file <= maxFile; ++file) {
+        for (int i = 0; i < sides; ++i) {
+            data = alignTo(data, base, 64);
+            PairsData * d = table.get(i, file);
+            d->data = data;
+            data += std::uint64_t(d->numBlocks) * d->blockSize;
+        }
+    }
+
+    return data <= end;
+}
+
+/* Value of the position with the given index: the sparse index gives a block near it, the block lengths the exact block, then the symbols of the block are decoded until the one that covers the index, and expanded down to a single value */
+static int decompressPairs(const PairsData & d, std::uint64_t index) {
+    if (d.flags & TB_SINGLE_VALUE) return d.minSymLen;
+
+    std::uint64_t k = index / d.span;
+    const std::uint8_t * entry = d.sparseIndex + 6 * k;
+    std::uint32_t block = readLE32(entry);
+    std::int64_t offset = readLE16(entry + 4);
+
+    /* The sparse entry points to the middle of its span */
+    offset += std::int64_t(index % d.span) - std::int64_t(d.span / 2);
+
+    while (offset < 0) offset += readLE16(d.blockLength + 2 * --block) + 1;
+    while (offset > readLE16(d.blockLength + 2 * block)) offset -= readLE16(d.blockLength + 2 * block++) + 1;
+
+    const std::uint8_t * pointer = d.data + std::uint64_t(block) * d.blockSize;
+    std::uint64_t buffer = readBE64(pointer);
+    pointer += 8;
+    int bits = 0;
+    int symbol;
+
+    for (;;) {
+        int length = 0;
+        while (buffer < d.base64[length]) ++length;
+
+        symbol = static_cast<int>((buffer - d.base64[length]) >> (64 - length - d.minSymLen));
+        symbol += readLE16(d.lowestSym + 2 * length);
+
+        if (offset < d.symLen[symbol] + 1) break;
+        offset -= d.symLen[symbol] + 1;
+
+        length += d.minSymLen;
+        buffer <<= length;
+        bits += length;
+
+        /* Refill 32 bits when half of the buffer has been used */
+        if (bits >= 32) {
+            bits -= 32;
+            buffer |= std::uint64_t(readBE32(pointer)) << bits;
+            pointer += 4;
+        }
+    }
+
+    /* Walk down the pairs to the value */
+    while (d.symLen[symbol]) {
+        int left = symbolLeft(d, symbol);
+        if (offset < d.symLen[left] + 1) symbol = left;
+        else {
+            offset -= d.symLen[left] + 1;
+            symbol = symbolRight(d, symbol);
+        }
+    }
+
+    return symbolLeft(d, symbol);
+}
+
+/* ##### Tablebase ##### */
+Tablebase::Tablebase() : mWDLCount(0), mDTZCount(0), mMaxPieces(0) {
+    static std::once_flag encodingTables;
+    std::call_once(encodingTables, initEncodingTables);
+}
+
+Tablebase::~Tablebase() {}
+
+std::size_t Tablebase::init(const std::string & paths) {
+    mWDL.clear();
+    mDTZ.clear();
+    mTables.clear();
+    mWDLCount = 0;
+    mDTZCount = 0;
+    mMaxPieces = 0;
+
+#ifdef _WIN32
+    const char separator = ';';
+#else
+    const char separator = ':';
+#endif
+
+    std::size_t start = 0;
+    while (start <= paths.size()) {
+        std::size_t end = paths.find(separator, start);
+        if (end == std::string::npos) end = paths.size();
+        std::string directory = paths.substr(start, end - start);
+        start = end + 1;
+        if (directory.empty()) continue;
+
+        std::error_code error;
+        for (const auto & item : std::filesystem::directory_iterator(directory, error)) {
+            std::string extension = item.path().extension().string();
+            if (extension != ".rtbw" && extension != ".rtbz") continue;
+            addTable(item.path().string(), item.path().stem().string(), extension == ".rtbz");
+        }
+        if (error) std::cerr << "Unable to read tablebase directory " << directory << std::endl;
+    }
+
+    return mWDLCount;
+}
+
+void Tablebase::addTable(const std::string & path, const std::string & name, bool dtz) {
+    int counts[2][7];
+    if (!parseTableName(name, counts)) return;
+
+    auto table = std::make_unique<TBTable>();
+    table->path = path;
+    table->dtz = dtz;
+    table->key = materialKey(counts);
+
+    int swapped[2][7];
+    for (int type = 0; type < 7; ++type) {
+        swapped[0][type] = counts[1][type];
+        swapped[1][type] = counts[0][type];
+    }
+    table->key2 = materialKey(swapped);
+
+    for (int type = 1; type <= 6; ++type) {
+        table->pieceCount += counts[0][type] + counts[1][type];
+        if (type != 6 && (counts[0][type] == 1 || counts[1][type] == 1)) table->hasUniquePieces = true;
+    }
+    if (table->pieceCount > TB_MAX_PIECES) return;
+
+    /* With pawns on both sides, the side with fewer pawns leads as it compresses better */
+    table->hasPawns = counts[0][1] + counts[1][1] > 0;
+    bool whiteLeads = !counts[1][1] || (counts[0][1] && counts[1][1] >= counts[0][1]);
+    table->pawnCount[0] = whiteLeads ? counts[0][1] : counts[1][1];
+    table->pawnCount[1] = whiteLeads ? counts[1][1] : counts[0][1];
+
+    auto & tables = dtz ? mDTZ : mWDL;
+    if (tables.count(table->key)) return; /* Found in an earlier directory */
+
+    tables[table->key] = table.get();
+    tables[table->key2] = table.get();
+    if (dtz) ++mDTZCount;
+    else {
+        ++mWDLCount;
+        mMaxPieces = std::max(mMaxPieces, table->pieceCount);
+    }
+    mTables.push_back(std::move(table));
+}
+
+/* The file is only mapped on the first probe of its material. A file that cannot be used is never tried again */
+bool Tablebase::mapTable(TBTable & table) const {
+    if (table.ready.load(std::memory_order_acquire)) return table.valid;
+
+    std::lock_guard<std::mutex> lock(mMapMutex);
+    if (table.ready.load(std::memory_order_relaxed)) return table.valid;
+
+    bool valid = false;
+    if (table.file.open(table.path)) {
+        const std::uint8_t * base = reinterpret_cast<const std::uint8_t *>(table.file.getData());
+        std::size_t size = table.file.getSize();
+        const std::uint8_t * magic = table.dtz ? DTZ_MAGIC : WDL_MAGIC;
+        valid = size % 64 == 16 && std::memcmp(base, magic, 4) == 0 && parseTable(table, base, base + size);
+    }
+    if (!valid) {
+        std::cerr << "Invalid tablebase file " << table.path << std::endl;
+        table.file.close();
+    }
+
+    table.valid = valid;
+    table.ready.store(true, std::memory_order_release);
+    return valid;
+}
+
+bool Tablebase::isCovered(const Board & board) const {
+    int pieceCount;
+    boardMaterialKey(board, pieceCount);
+    return pieceCount <= mMaxPieces && board.getCastlingRights() == 0;
+}
+
+/* Finds the index of the position in its table, then decompresses the value. The tables are stored with the first side of their name as White, so positions with the other material are probed with the colors swapped and the board flipped */
+int Tablebase::probeTable(const Board & board, bool dtz, WDLScore wdl, ProbeState & state) const {
+    int pieceCount;
+    std::uint64_t key = boardMaterialKey(board, pieceCount);
+    if (pieceCount == 2) return dtz ? 0 : static_cast<int>(WDLScore::Draw); /* King against King */
+
+    const auto & tables = dtz ? mDTZ : mWDL;
+    auto found = tables.find(key);
+    if (found == tables.end() || !mapTable(*found->second)) {
+        state = ProbeState::Fail;
+        return 0;
+    }
+    TBTable & table = *found->second;
+
+    int turn = board.getTurn() == Color::Black ? 1 : 0;
+
+    /* Symmetric tables only store White to move */
+    bool symmetricBlackToMove = table.key == table.key2 && turn == 1;
+    bool blackStronger = key != table.key;
+    bool flip = symmetricBlackToMove || blackStronger;
+    int flipColor = flip ? 8 : 0;
+    int flipSquares = flip ? 56 : 0;
+    int stm = (flip ? 1 : 0) ^ turn;
+
+    int squares[TB_MAX_PIECES];
+    int pieces[TB_MAX_PIECES];
+    int size = 0;
+    int leadPawnsCount = 0;
+    int tableFile = 0;
+    std::uint64_t leadPawns = 0;
+
+    /* With pawns, the leading pawns come first in the table, and their file picks one of the 4 tables */
+    if (table.hasPawns) {
+        int leadCode = table.get(0, 0)->pieces[0] ^ flipColor;
+        for (int i = 0; i < 64; ++i) {
+            const Piece * piece = board.board[i];
+            if (piece && pieceCode(piece) == leadCode) {
+                squares[size++] = i ^ flipSquares;
+                leadPawns |= std::uint64_t(1) << i;
+            }
+        }
+        leadPawnsCount = size;
+        std::swap(squares[0], *std::max_element(squares, squares + leadPawnsCount, pawnsLess));
+        tableFile = std::min(squareFile(squares[0]), 7 - squareFile(squares[0]));
+    }
+
+    /* DTZ tables only store one side to move */
+    if (dtz) {
+        const PairsData * d = table.get(stm, tableFile);
+        if ((d->flags & TB_STM) != stm && !(table.key == table.key2 && !table.hasPawns)) {
+            state = ProbeState::ChangeSide;
+            return 0;
+        }
+    }
+
+    for (int i = 0; i < 64; ++i) {
+        const Piece * piece = board.board[i];
+        if (!piece || (leadPawns >> i) & 1) continue;
+        squares[size] = i ^ flipSquares;
+        pieces[size++] = pieceCode(piece) ^ flipColor;
+    }
+
+    const PairsData & d = *table.get(stm, tableFile);
+
+    /* Same order as the pieces of the table */
+    for (int i = leadPawnsCount; i < size - 1; ++i) {
+        for (int j = i + 1; j < size; ++j) {
+            if (d.pieces[i] == pieces[j]) {
+                std::swap(pieces[i], pieces[j]);
+                std::swap(squares[i], squares[j]);
+                break;
+            }
+        }
+    }
+
+    /* Mirror so the leading piece is on the files a-d */
+    if (squareFile(squares[0]) > 3) {
+        for (int i = 0; i < size; ++i) squares[i] = flipFile(squares[i]);
+    }
+
+    std::uint64_t index;
+    if (table.hasPawns) {
+        index = leadPawnIndex[leadPawnsCount][squares[0]];
+        std::stable_sort(squares + 1, squares + leadPawnsCount, pawnsLess);
+        for (int i = 1; i < leadPawnsCount; ++i) index += binomial[i][mapPawns[squares[i]]];
+    }
+    else {
+        /* Without pawns, also mirror to the ranks 1-4 and below the a1-h8 diagonal */
+        if (squareRank(squares[0]) > 3) {
+            for (int i = 0; i < size; ++i) squares[i] = flipRank(squares[i]);
+        }
+
+        for (int i = 0; i < d.groupLen[0]; ++i) {
+            if (!offDiagonal(squares[i])) continue;
+            if (offDiagonal(squares[i]) > 0) {
+                for (int j = i; j < size; ++j) squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+            }
+            break;
+        }
+
+        if (table.hasUniquePieces) {
+            /* The three leading pieces together: 31332 placements */
+            int adjust1 = squares[1] > squares[0];
+            int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+
+            if (offDiagonal(squares[0]))
+                index = (std::uint64_t(mapA1D1D4[squares[0]]) * 63 + (squares[1] - adjust1)) * 62 + squares[2] - adjust2;
+            else if (offDiagonal(squares[1]))
+                index = (6 * 63 + std::uint64_t(squareRank(squares[0])) * 28 + mapB1H1H7[squares[1]]) * 62 + squares[2] - adjust2;
+            else if (offDiagonal(squares[2]))
+                index = 6 * 63 * 62 + 4 * 28 * 62 + std::uint64_t(squareRank(squares[0])) * 7 * 28 + (squareRank(squares[1]) - adjust1) * 28 + mapB1H1H7[squares[2]];
+            else
+                index = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + std::uint64_t(squareRank(squares[0])) * 7 * 6 + (squareRank(squares[1]) - adjust1) * 6 + (squareRank(squares[2]) - adjust2);
+        }
+        else {
+            /* Only the two Kings lead: 462 placements */
+            index = mapKK[mapA1D1D4[squares[0]]][squares[1]];
+        }
+    }
+
+    /* The other groups: combinations of the free squares, skipping the ones taken by the previous groups */
+    index *= d.groupIndex[0];
+    int * groupSquares = squares + d.groupLen[0];
+    bool remainingPawns = table.hasPawns && table.pawnCount[1];
+
+    for (int next = 1; d.groupLen[next]; ++next) {
+        std::stable_sort(groupSquares, groupSquares + d.groupLen[next]);
+        std::uint64_t n = 0;
+        for (int i = 0; i < d.groupLen[next]; ++i) {
+            int adjust = static_cast<int>(std::count_if(squares, groupSquares, [&](int square) { return groupSquares[i] > square; }));
+            n += binomial[i + 1][groupSquares[i] - adjust - 8 * remainingPawns];
+        }
+        remainingPawns = false;
+        index += n * d.groupIndex[next];
+        groupSquares += d.groupLen[next];
+    }
+
+    int value = decompressPairs(d, index);
+    if (!dtz) return value - 2;
+
+    /* Map back the DTZ value of the WDL result, and count it in plies */
+    const PairsData & first = *table.get(0, tableFile);
+    static const int wdlMap[] = {1, 3, 0, 2, 0};
+    int w = static_cast<int>(wdl);
+    if (first.flags & TB_MAPPED) {
+        std::uint16_t offset = first.mapIndex[wdlMap[w + 2]];
+        if (first.flags & TB_WIDE) value = readLE16(table.map + 2 * (offset + value));
+        else value = table.map[offset + value];
+    }
+
+    if ((wdl == WDLScore::Win && !(first.flags & TB_WIN_PLIES)) || (wdl == WDLScore::Loss && !(first.flags & TB_LOSS_PLIES)) || wdl == WDLScore::CursedWin || wdl == WDLScore::BlessedLoss)
+        value *= 2;
+
+    return value + 1;
+}
+
+static bool isZeroingMove(const Board & board, const Move & move) {
+    const Piece * piece = board.board[move.from];
+    return board.board[move.to] != nullptr || piece->getType() == PieceType::Pawn;
+}
+
+static bool isCaptureMove(const Board & board, const Move & move) {
+    const Piece * piece = board.board[move.from];
+    return board.board[move.to] != nullptr || (piece->getType() == PieceType::Pawn && move.to == board.getEnPassantIndex());
+}
+
+/* The tables store "don't care" values where the best move is a capture (or a pawn move for DTZ), and nothing for en passant, so the captures are searched and the best of them and the table is the result */
+WDLScore Tablebase::search(const Board & board, bool checkZeroing, ProbeState & state) const {
+    std::vector<Move> moves;
+    board.generateLegalMoves(moves);
+
+    int bestValue = static_cast<int>(WDLScore::Loss);
+    std::size_t moveCount = 0;
+    for (const Move & move : moves) {
+        if (!isCaptureMove(board, move) && (!checkZeroing || board.board[move.from]->getType() != PieceType::Pawn)) continue;
+
+        ++moveCount;
+        Board child(board);
+        child.playMove(move);
+        int value = -static_cast<int>(search(child, false, state));
+        if (state == ProbeState::Fail) return WDLScore::Draw;
+
+        if (value > bestValue) {
+            bestValue = value;
+            if (value >= static_cast<int>(WDLScore::Win)) {
+                state = ProbeState::ZeroingBestMove;
+                return static_cast<WDLScore>(value);
+            }
+        }
+    }
+
+    /* When every move was searched the table is not needed, and may even be wrong */
+    bool noMoreMoves = moveCount && moveCount == moves.size();
+    int value;
+    if (noMoreMoves) value = bestValue;
+    else {
+        value = probeTable(board, false, WDLScore::Draw, state);
+        if (state == ProbeState::Fail) return WDLScore::Draw;
+    }
+
+    if (bestValue >= value) {
+        state = (bestValue > static_cast<int>(WDLScore::Draw) || noMoreMoves) ? ProbeState::ZeroingBestMove : ProbeState::Ok;
+        return static_cast<WDLScore>(bestValue);
+    }
+
+    state = ProbeState::Ok;
+    return static_cast<WDLScore>(value);
+}
+
+WDLScore Tablebase::probeWDL(const Board & board, ProbeState & state) const {
+    state = ProbeState::Ok;
+    return search(board, false, state);
+}
+
+/* DTZ of the move before a zeroing move */
+static int dtzBeforeZeroing(WDLScore wdl) {
+    switch (wdl) {
+        case WDLScore::Win: return 1;
+        case WDLScore::CursedWin: return 101;
+        case WDLScore::BlessedLoss: return -101;
+        case WDLScore::Loss: return -1;
+        default: return 0;
+    }
+}
+
+static bool isCheckmate(const Board & board) {
+    const King * king = board.getKing(board.getTurn());
+    if (!king || !king->isChecked()) return false;
+    std::vector<Move> moves;
+    board.generateLegalMoves(moves);
+    return moves.empty();
+}
+
+static int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+int Tablebase::probeDTZ(const Board & board, ProbeState & state) const {
+    state = ProbeState::Ok;
+    WDLScore wdl = search(board, true, state);
+    if (state == ProbeState::Fail || wdl == WDLScore::Draw) return 0;
+
+    /* The best move zeroes the counter, so the table holds a "don't care" value */
+    if (state == ProbeState::ZeroingBestMove) return dtzBeforeZeroing(wdl);
+
+    int dtz = probeTable(board, true, wdl, state);
+    if (state == ProbeState::Fail) return 0;
+    if (state != ProbeState::ChangeSide)
+        return (dtz + 100 * (wdl == WDLScore::BlessedLoss || wdl == WDLScore::CursedWin)) * sign(static_cast<int>(wdl));
+
+    /* The table is stored for the other side to move: the DTZ is the best one of the moves */
+    std::vector<Move> moves;
+    board.generateLegalMoves(moves);
+    int minDTZ = 0xFFFF;
+    for (const Move & move : moves) {
+        bool zeroing = isZeroingMove(board, move);
+        Board child(board);
+        child.playMove(move);
+
+        dtz = zeroing ? -dtzBeforeZeroing(search(child, false, state)) : -probeDTZ(child, state);
+
+        /* A mate is one ply away */
+        if (dtz == 1 && isCheckmate(child)) minDTZ = 1;
+
+        if (!zeroing) dtz += sign(dtz);
+        if (dtz < minDTZ && sign(dtz) == sign(static_cast<int>(wdl))) minDTZ = dtz;
+        if (state == ProbeState::Fail) return 0;
+    }
+
+    /* No legal moves: mated */
+    return minDTZ == 0xFFFF ? -1 : minDTZ;
+}
+
+bool Tablebase::probeWDL(const Board & board, WDLScore & wdl) const {
+    if (!isCovered(board)) return false;
+    ProbeState state;
+    wdl = probeWDL(board, state);
+    return state != ProbeState::Fail;
+}
+
+bool Tablebase::probeDTZ(const Board & board, int & dtz) const {
+    if (!isCovered(board)) return false;
+    ProbeState state;
+    dtz = probeDTZ(board, state);
+    return state != ProbeState::Fail;
+}
+
+/* Ranks the root moves: every win that is safe from the 50-move rule ranks the same, slower wins rank lower, and losses rank by how long they delay the loss */
+bool Tablebase::rankRootMoves(const Board & board, std::vector<Move> & moves, std::vector<int> & ranks, bool useDTZ) const {
+    int counter = board.getHalfMoveClock();
+    ranks.clear();
+
+    for (const Move & move : moves) {
+        Board child(board);
+        child.playMove(move);
+        ProbeState state;
+        int rank;
+
+        if (useDTZ) {
+            int dtz;
+            if (child.getHalfMoveClock() == 0) dtz = dtzBeforeZeroing(static_cast<WDLScore>(-static_cast<int>(probeWDL(child, state))));
+            else {
+                dtz = -probeDTZ(child, state);
+                dtz = dtz > 0 ? dtz + 1 : dtz < 0 ? dtz - 1 : dtz;
+            }
+
+            /* A mating move has a DTZ of 1 */
+            if (dtz == 2 && isCheckmate(child)) dtz = 1;
+
+            rank = dtz > 0 ? (dtz + counter <= 99 ? MAX_DTZ : MAX_DTZ - (dtz + counter))
+                 : dtz < 0 ? (-dtz * 2 + counter < 100 ? -MAX_DTZ : -MAX_DTZ + (-dtz + counter))
+                 : 0;
+        }
+        else {
+            /* Without DTZ, only the results count, with the 50-move rule ones as draws */
+            static const int wdlRank[] = {-MAX_DTZ, -MAX_DTZ + 101, 0, MAX_DTZ - 101, MAX_DTZ};
+            rank = wdlRank[2 - static_cast<int>(probeWDL(child, state))];
+        }
+
+        if (state == ProbeState::Fail) return false;
+        ranks.push_back(rank);
+    }
+    return true;
+}
+
+bool Tablebase::filterRootMoves(const Board & board, std::vector<Move> & moves, WDLScore & wdl) const {
+    if (moves.empty() || !isCovered(board)) return false;
+
+    ProbeState state;
+    wdl = probeWDL(board, state);
+    if (state == ProbeState::Fail) return false;
+
+    /* DTZ ranks the moves finely, if its tables are missing the WDL ones still find the winning moves */
+    std::vector<int> ranks;
+    if (!rankRootMoves(board, moves, ranks, true) && !rankRootMoves(board, moves, ranks, false)) return false;
+
+    int best = *std::max_element(ranks.begin(), ranks.end());
+    std::vector<Move> kept;
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        if (ranks[i] == best) kept.push_back(moves[i]);
+    }
+    moves.swap(kept);
+    return true;
+}
@@ -0,0 +1,155 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <iostream>
+
+/* Include other defined headers */
+#include "TextureAtlas.hpp"
+
+/* Widest row of sprites, in pixels, and the transparent gap around every sprite so linear filtering does not mix two sprites */
+static const int ATLAS_MAX_WIDTH = 1024;
+static const int ATLAS_PADDING = 2;
+static const int SOLID_SIZE = 4;
+
+/* ##### TextureAtlas ##### */
+TextureAtlas::TextureAtlas() : mTexture(nullptr), mWidth(0), mHeight(0), mSolidSprite(-1) {}
+
+TextureAtlas::~TextureAtlas() {
+    free();
+}
+
+/* Frees the texture. It must be called before the renderer is destroyed */
+void TextureAtlas::free() {
+    if (mTexture != nullptr) {
+        SDL_DestroyTexture(mTexture);
+        mTexture = nullptr;
+    }
+    mWidth = 0;
+    mHeight = 0;
+    mSolidSprite = -1;
+    mSprites.clear();
+}
+
+bool TextureAtlas::load(const std::vector<std::string> & paths, SDL_Renderer * renderer) {
+    std::vector<SDL_Surface *> images;
+    bool success = true;
+    for (const std::string & path : paths) {
+        SDL_Surface * image = IMG_Load(path.c_str());
+        if (image == nullptr) {
+            std::cerr << "Unable to load image " << path << "! SDL_Image Error: " << IMG_GetError() << std::endl;
+            success = false;
+            break;
+        }
+        images.push_back(image);
+    }
+
+    success = success && build(images, renderer);
+    for (SDL_Surface * image : images)
+        SDL_FreeSurface(image);
+    return success;
+}
+
+/* Places the images in rows (shelves) from left to right, then copies them into one surface which becomes the texture */
+bool TextureAtlas::build(const std::vector<SDL_Surface *> & images, SDL_Renderer * renderer) {
+    free();
+
+    int x = ATLAS_PADDING, y = ATLAS_PADDING, shelfHeight = 0, width = 0;
+    auto place = [&](int w, int h) {
+        if (x + w + ATLAS_PADDING > ATLAS_MAX_WIDTH && x > ATLAS_PADDING) {
+            x = ATLAS_PADDING;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        mSprites.push_back({x, y, w, h});
+        x += w + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, h);
+        width = std::max(width, x);
+    };
+
+    for (SDL_Surface * image : images)
+        place(image->w, image->h);
+    place(SOLID_SIZE, SOLID_SIZE);
+    int height = y + shelfHeight + ATLAS_PADDING;
+
+    /* New surfaces are transparent */
+    SDL_Surface * atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (atlas == nullptr) {
+        std::cerr << "Unable to create the texture atlas! SDL Error: " << SDL_GetError() << std::endl;
+        mSprites.clear();
+        return false;
+    }
+
+    /* Copied without blending, so the alpha of the images is kept as it is */
+    for (std::size_t i = 0; i < images.size(); ++i) {
+        SDL_SetSurfaceBlendMode(images[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(images[i], nullptr, atlas, &mSprites[i]);
+    }
+
+    /* The solid sprite is the inside of a white square, away from its filtered edges */
+    mSolidSprite = static_cast<int>(images.size());
+    SDL_Rect & solid = mSprites[mSolidSprite];
+    SDL_FillRect(atlas, &solid, SDL_MapRGBA(atlas->format, 0xFF, 0xFF, 0xFF, 0xFF));
+    solid = {solid.x + 1, solid.y + 1, SOLID_SIZE - 2, SOLID_SIZE - 2};
+
+    mTexture = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (mTexture == nullptr) {
+        std::cerr << "Unable to create the atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+        mSprites.clear();
+        mSolidSprite = -1;
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(mTexture, SDL_ScaleModeLinear);
+    mWidth = width;
+    mHeight = height;
+    return true;
+}
+
+/* ##### SpriteBatch ##### */
+SpriteBatch::SpriteBatch(const TextureAtlas & atlas) : mAtlas(atlas), mDrawCalls(0) {
+    mVertices.reserve(4 * 128);
+    mIndices.reserve(6 * 128);
+}
+
+void SpriteBatch::add(int sprite, const SDL_Rect & dstRect, SDL_Color color) {
+    addF(sprite, SDL_FRect{static_cast<float>(dstRect.x), static_cast<float>(dstRect.y), static_cast<float>(dstRect.w), static_cast<float>(dstRect.h)}, color);
+}
+
+/* Sub-pixel placement, e.g. for the glyphs of scaled text */
+void SpriteBatch::addF(int sprite, const SDL_FRect & dstRect, SDL_Color color) {
+    const SDL_Rect & src = mAtlas.getSprite(sprite);
+    float width = static_cast<float>(mAtlas.getWidth());
+    float height = static_cast<float>(mAtlas.getHeight());
+    addQuad(dstRect, src.x / width, src.y / height, (src.x + src.w) / width, (src.y + src.h) / height, color);
+}
+
+void SpriteBatch::addRect(const SDL_Rect & dstRect, SDL_Color color) {
+    add(mAtlas.getSolidSprite(), dstRect, color);
+}
+
+/* Two triangles, with the texture coordinates of the sprite */
+void SpriteBatch::addQuad(const SDL_FRect & dstRect, float u0, float v0, float u1, float v1, SDL_Color color) {
+    int first = static_cast<int>(mVertices.size());
+    float x0 = dstRect.x, y0 = dstRect.y;
+    float x1 = dstRect.x + dstRect.w, y1 = dstRect.y + dstRect.h;
+
+    mVertices.push_back({{x0, y0}, color, {u0, v0}});
+    mVertices.push_back({{x1, y0}, color, {u1, v0}});
+    mVertices.push_back({{x1, y1}, color, {u1, v1}});
+    mVertices.push_back({{x0, y1}, color, {u0, v1}});
+
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int index : quad)
+        mIndices.push_back(first + index);
+}
+
+bool SpriteBatch::flush(SDL_Renderer * renderer) {
+    if (mIndices.empty()) return true;
+
+    int result = SDL_RenderGeometry(renderer, mAtlas.getTexture(), mVertices.data(), static_cast<int>(mVertices.size()), mIndices.data(), static_cast<int>(mIndices.size()));
+    ++mDrawCalls;
+    mVertices.clear();
+    mIndices.clear();
+    return result == 0;
+}
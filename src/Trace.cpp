@@ -0,0 +1,159 @@
+/* Standard Libraries */
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* Include other defined headers */
+#include "Trace.hpp"
+
+/* Zones are stored in fixed size chunks, so a buffer grows without moving what was already written, while writeTrace reads it */
+static const std::size_t TRACE_CHUNK_EVENTS = 4096;
+
+struct TraceEvent {
+    const char * category;
+    const char * name;
+    std::uint64_t start; /* Nanoseconds since the start of the process */
+    std::uint64_t duration;
+};
+
+struct TraceChunk {
+    std::array<TraceEvent, TRACE_CHUNK_EVENTS> events;
+    std::atomic<TraceChunk *> next{nullptr};
+};
+
+/* Written only by its thread. The count is published after the event (and its chunk), so a reader sees complete events only */
+struct TraceBuffer {
+    int threadId = 0;
+    std::string threadName; /* Guarded by the registry mutex */
+    TraceChunk first;
+    TraceChunk * last = &first;
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> dropped{0};
+
+    ~TraceBuffer() {
+        TraceChunk * chunk = first.next.load();
+        while (chunk != nullptr) {
+            TraceChunk * next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+        }
+    }
+};
+
+/* The buffers outlive their threads, so the zones of finished threads are still written */
+static std::mutex traceMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> traceBuffers;
+static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+static thread_local TraceBuffer * threadBuffer = nullptr;
+
+static TraceBuffer & getThreadBuffer() {
+    if (threadBuffer == nullptr) {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        traceBuffers.push_back(std::make_unique<TraceBuffer>());
+        threadBuffer = traceBuffers.back().get();
+        threadBuffer->threadId = static_cast<int>(traceBuffers.size());
+    }
+    return *threadBuffer;
+}
+
+bool isTraceEnabled() {
+#ifdef CPPCHESS_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void recordTraceZone(const char * category, const char * name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    TraceBuffer & buffer = getThreadBuffer();
+    std::uint64_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= TRACE_MAX_EVENTS) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (index > 0 && index % TRACE_CHUNK_EVENTS == 0) {
+        TraceChunk * chunk = new TraceChunk();
+        buffer.last->next.store(chunk, std::memory_order_release);
+        buffer.last = chunk;
+    }
+
+    TraceEvent & event = buffer.last->events[index % TRACE_CHUNK_EVENTS];
+    event.category = category;
+    event.name = name;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - traceEpoch).count();
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void setTraceThreadName(const std::string & name) {
+    if (!isTraceEnabled()) return; /* No buffer for threads which never record */
+    TraceBuffer & buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(traceMutex);
+    buffer.threadName = name;
+}
+
+/* Escapes the characters JSON does not allow in a string */
+static std::string escapeJSON(const std::string & text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+
+/* Timestamps are in microseconds, with the nanoseconds as decimals */
+static void writeMicroseconds(std::ostream & output, std::uint64_t nanoseconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned long long>(nanoseconds % 1000));
+    output << text;
+}
+
+bool writeTrace(const std::string & path) {
+    if (!isTraceEnabled()) return false;
+
+    std::ofstream output(path);
+    if (!output) return false;
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    output << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"cppchess\"}}";
+
+    for (const std::unique_ptr<TraceBuffer> & buffer : traceBuffers) {
+        if (!buffer->threadName.empty())
+            output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"" << escapeJSON(buffer->threadName) << "\"}}";
+
+        std::uint64_t count = buffer->count.load(std::memory_order_acquire);
+        const TraceChunk * chunk = &buffer->first;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (i > 0 && i % TRACE_CHUNK_EVENTS == 0) chunk = chunk->next.load(std::memory_order_acquire);
+            const TraceEvent & event = chunk->events[i % TRACE_CHUNK_EVENTS];
+            output << ",\n{\"cat\":\"" << event.category << "\",\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(output, event.start);
+            output << ",\"dur\":";
+            writeMicroseconds(output, event.duration);
+            output << '}';
+        }
+    }
+    output << "\n]}\n";
+    return static_cast<bool>(output);
+}
+
+std::uint64_t getTraceEventCount() {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    std::uint64_t total = 0;
+    for (const std::unique_ptr<TraceBuffer> & buffer : traceBuffers) total += buffer->count.load(std::memory_order_acquire);
+    return total;
+}
+
+std::uint64_t getTraceDroppedCount() {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    std::uint64_t total = 0;
+    for (const std::unique_ptr<TraceBuffer> & buffer : traceBuffers) total += buffer->dropped.load(std::memory_order_relaxed);
+    return total;
+}
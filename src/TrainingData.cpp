@@ -0,0 +1,103 @@
+/* Standard Libraries */
+#include <algorithm>
+#include <cstring>
+
+/* Include other defined headers */
+#include "TrainingData.hpp"
+
+static_assert(sizeof(TrainingRecord) == 32, "Unexpected TrainingRecord layout");
+
+/* ##### Packing ##### */
+bool packTrainingRecord(const Board & board, int score, TrainingRecord & record) {
+    std::memset(&record, 0, sizeof(record));
+
+    /* Same piece encoding as Board::pack */
+    PackedBoard packed;
+    if (!board.pack(packed)) return false;
+    record.occupancy = packed.occupancy;
+    std::memcpy(record.pieces, packed.pieces, sizeof(record.pieces));
+
+    record.score = static_cast<std::int16_t>(std::clamp(score, -32767, 32767));
+    record.flags = static_cast<std::uint8_t>((board.getTurn() == Color::Black ? 1 : 0) | (board.getCastlingRights() << 1));
+    record.enPassant = static_cast<std::uint8_t>(board.getEnPassantIndex() + 1);
+    record.halfMoveClock = static_cast<std::uint8_t>(std::min(board.getHalfMoveClock(), 255));
+    record.fullMoveClock = static_cast<std::uint16_t>(std::min(board.getFullMoveClock(), 65535));
+    return true;
+}
+
+std::string trainingRecordToFEN(const TrainingRecord & record) {
+    static const char letters[] = " PNBRQK  pnbrqk ";
+
+    char squares[64] = {};
+    int count = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (!((record.occupancy >> i) & 1)) continue;
+        squares[i] = letters[(record.pieces[count / 2] >> (4 * (count % 2))) & 0xF];
+        ++count;
+    }
+
+    std::string fen;
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+        for (int file = 0; file < 8; ++file) {
+            char square = squares[rank * 8 + file];
+            if (!square) {
+                ++empty;
+                continue;
+            }
+            if (empty) fen += static_cast<char>('0' + empty);
+            empty = 0;
+            fen += square;
+        }
+        if (empty) fen += static_cast<char>('0' + empty);
+        if (rank) fen += '/';
+    }
+
+    fen += (record.flags & 1) ? " b " : " w ";
+    int rights = record.flags >> 1;
+    if (!rights) fen += '-';
+    if (rights & CASTLE_WHITE_KING_SIDE) fen += 'K';
+    if (rights & CASTLE_WHITE_QUEEN_SIDE) fen += 'Q';
+    if (rights & CASTLE_BLACK_KING_SIDE) fen += 'k';
+    if (rights & CASTLE_BLACK_QUEEN_SIDE) fen += 'q';
+
+    fen += ' ';
+    fen += record.enPassant ? Board::indexToAlgebraic(record.enPassant - 1) : "-";
+    fen += " " + std::to_string(record.halfMoveClock) + " " + std::to_string(record.fullMoveClock);
+    return fen;
+}
+
+/* ##### TrainingDataWriter ##### */
+TrainingDataWriter::TrainingDataWriter(std::size_t bufferRecords) : mCount(0) {
+    mBuffer.reserve(std::max<std::size_t>(bufferRecords, 1));
+}
+
+TrainingDataWriter::~TrainingDataWriter() {
+    close();
+}
+
+bool TrainingDataWriter::open(const std::string & path) {
+    close();
+    mFile.open(path, std::ios::binary | std::ios::trunc);
+    mCount = 0;
+    return static_cast<bool>(mFile);
+}
+
+void TrainingDataWriter::write(const TrainingRecord & record) {
+    mBuffer.push_back(record);
+    ++mCount;
+    if (mBuffer.size() == mBuffer.capacity()) flush();
+}
+
+void TrainingDataWriter::flush() {
+    mFile.write(reinterpret_cast<const char *>(mBuffer.data()), mBuffer.size() * sizeof(TrainingRecord));
+    mBuffer.clear();
+}
+
+bool TrainingDataWriter::close() {
+    if (!mFile.is_open()) return true;
+    flush();
+    bool good = static_cast<bool>(mFile);
+    mFile.close();
+    return good;
+}
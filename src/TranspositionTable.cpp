@@ -0,0 +1,66 @@
+/* Standard Libraries */
+#include <algorithm>
+
+/* Include other defined headers */
+#include "TranspositionTable.hpp"
+
+static_assert(sizeof(TTEntry) == 16, "Unexpected TTEntry layout");
+
+std::uint16_t packMove(const Move & move) {
+    if (!Board::isValidIndex(move.from) || !Board::isValidIndex(move.to)) return 0;
+    return static_cast<std::uint16_t>(move.from | (move.to << 6) | (static_cast<int>(move.promotion) << 12));
+}
+
+Move unpackMove(std::uint16_t packed) {
+    if (packed == 0) return {-1, -1, PieceType::Empty};
+    return {packed & 63, (packed >> 6) & 63, static_cast<PieceType>((packed >> 12) & 7)};
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) : mMask(0), mGeneration(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    std::size_t entries = std::max<std::size_t>(megabytes, 1) * 1024 * 1024 / sizeof(TTEntry);
+    std::size_t size = 1;
+    while (size * 2 <= entries) size *= 2;
+
+    mEntries.assign(size, TTEntry());
+    mMask = size - 1;
+    mGeneration = 0;
+}
+
+void TranspositionTable::clear() {
+    std::fill(mEntries.begin(), mEntries.end(), TTEntry());
+    mGeneration = 0;
+}
+
+const TTEntry * TranspositionTable::probe(std::uint64_t key) const {
+    const TTEntry & entry = mEntries[key & mMask];
+    return (entry.bound != Bound::None && entry.key == key) ? &entry : nullptr;
+}
+
+void TranspositionTable::store(std::uint64_t key, const Move & move, int score, int depth, Bound bound) {
+    TTEntry & entry = mEntries[key & mMask];
+    if (entry.bound != Bound::None && entry.generation == mGeneration && entry.key != key && entry.depth > depth) return;
+
+    /* Keep the old move when the new search did not find one for the same position */
+    std::uint16_t packed = packMove(move);
+    if (packed == 0 && entry.key == key) packed = entry.move;
+
+    entry.key = key;
+    entry.move = packed;
+    entry.score = static_cast<std::int16_t>(score);
+    entry.depth = static_cast<std::int8_t>(depth);
+    entry.bound = bound;
+    entry.generation = mGeneration;
+}
+
+int TranspositionTable::getHashFull() const {
+    std::size_t samples = std::min<std::size_t>(1000, mEntries.size());
+    int used = 0;
+    for (std::size_t i = 0; i < samples; ++i) {
+        if (mEntries[i].bound != Bound::None && mEntries[i].generation == mGeneration) ++used;
+    }
+    return samples ? static_cast<int>(used * 1000 / samples) : 0;
+}
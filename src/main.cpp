@@ -2,9 +2,18 @@
 #include "Game.hpp"
 #include "Graphics.hpp"
 #include "ChessGUI.hpp"
+#include "FrameStats.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
 #include "imgui.h"
 #include "imgui_impl_sdl2.h"
 
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
 /* find src include -name "*.cpp" -o -name "*.hpp" | xargs wc -l */
 
 /* Check Version Requirements */
@@ -12,10 +21,24 @@
 #error This backend requires SDL 2.0.17+ because of SDL_RenderGeometry() function
 #endif
 
+/* Frames still rendered after the last event, as the GUI needs a few to reflect it */
+const int IDLE_FRAMES = 3;
+
 /* Main Loop */
 int main(int argc, char * argv[]) {
 
     try {
+        auto startupStart = std::chrono::steady_clock::now();
+        setTraceThreadName("main");
+
+        /* The GUI has no command line options: the engine metrics are exported when CPPCHESS_METRICS names a file (or - for the standard output) */
+        MetricsOptions metricsOptions;
+        if (const char * path = std::getenv("CPPCHESS_METRICS")) metricsOptions.path = path;
+        if (const char * format = std::getenv("CPPCHESS_METRICS_FORMAT")) {
+            if (std::strcmp(format, "json") == 0) metricsOptions.format = MetricsFormat::JSON;
+        }
+        MetricsExporter exporter(metricsOptions);
+
         /* Create a Game */
         ChessGame game;
 
@@ -28,37 +51,84 @@ int main(int argc, char * argv[]) {
         gui.init();
         game.setGUIPointer(&gui);
         game.graphics.setGUIPointer(&gui);
+        std::cout << "[Startup] Ready in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupStart).count() << " ms" << std::endl;
         
         /* Main Game Loop */
         ImGuiIO& io = ImGui::GetIO(); (void)io; /* Get imgui i/o */
         bool quit = false; /* Flag */
+        auto lastFrame = std::chrono::steady_clock::now();
+        int idleFrames = 0; /* Frames rendered since the last event, so the GUI can settle */
         while (!quit) { /* Run loop till the program is terminated by the user*/
-            auto frameStart = std::chrono::high_resolution_clock::now();
 
-            game.graphics.clearWindow(); /* Clear the window */
-            game.handleRender(); /* Render the board */
+            /* When idle, the last frame presented is still right: wait for the next event instead of rendering it again */
+            if (idleFrames >= IDLE_FRAMES && game.isIdle() && !gui.isAnalyzing() && !io.WantTextInput) {
+                if (!SDL_WaitEventTimeout(nullptr, 250)) continue;
+                lastFrame = std::chrono::steady_clock::now();
+            }
+
+            TRACE_ZONE("frame", "frame");
+            auto frameStart = std::chrono::steady_clock::now();
+            float elapsed = std::chrono::duration<float>(frameStart - lastFrame).count();
+            lastFrame = frameStart;
+
+            FrameTiming timing; /* Time of each stage, for the performance overlay */
+            {
+                TRACE_ZONE("frame", "update");
+                ScopedTimer timer(timing.update);
+                game.handleUpdate(elapsed); /* Advance the animations by the real elapsed time */
+            }
+
+            {
+                TRACE_ZONE("frame", "render");
+                ScopedTimer timer(timing.render);
+                game.graphics.clearWindow(); /* Clear the window */
+                game.handleRender(); /* Render the board */
+            }
             
             /* Handle Events */
-            SDL_Event event;
-            while (SDL_PollEvent(&event)) {
-                ImGui_ImplSDL2_ProcessEvent(&event);
-                if (event.type == SDL_QUIT) {
-                    quit = true;
-                    break;
-                }
-                if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window)) {
-                    quit = true;
-                    break;
+            {
+                TRACE_ZONE("frame", "events");
+                ScopedTimer timer(timing.events);
+                SDL_Event event;
+                ++idleFrames;
+                while (SDL_PollEvent(&event)) {
+                    idleFrames = 0;
+                    ImGui_ImplSDL2_ProcessEvent(&event);
+                    if (event.type == SDL_QUIT) {
+                        quit = true;
+                        break;
+                    }
+                    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window)) {
+                        quit = true;
+                        break;
+                    }
+                    if (event.type == SDL_RENDER_TARGETS_RESET) {
+                        game.graphics.invalidateScene(); /* The content of the scene texture was lost */
+                        continue;
+                    }
+                    if (io.WantCaptureKeyboard) continue; /* Ignore events which are directed to the GUI*/
+                    if (io.WantCaptureMouse) continue;
+                    
+                    game.handleEvent(event); /* Handle the events directed to the board */
                 }
-                if (io.WantCaptureKeyboard) continue; /* Ignore events which are directed to the GUI*/
-                if (io.WantCaptureMouse) continue;
-                
-                game.handleEvent(event); /* Handle the events directed to the board */
             }
 
-            game.handleStatesProcessing();
-            gui.render(); /* Render the GUI on top of the Board */
-            SDL_RenderPresent(renderer); /* Update the Window */
+            {
+                TRACE_ZONE("frame", "states");
+                ScopedTimer timer(timing.update);
+                game.handleStatesProcessing();
+            }
+            {
+                TRACE_ZONE("frame", "gui");
+                ScopedTimer timer(timing.gui);
+                gui.render(); /* Render the GUI on top of the Board */
+            }
+            {
+                TRACE_ZONE("frame", "present");
+                ScopedTimer timer(timing.present);
+                SDL_RenderPresent(renderer); /* Update the Window */
+            }
+            gui.recordFrame(timing, elapsed);
 
         }
     }
@@ -0,0 +1,207 @@
+/* Command line converter between PGN files and the compact binary game archive
+
+Usage:
+   cppchess-archive pack <in.pgn> <out.cga>       Converts a PGN file into an archive
+   cppchess-archive unpack <in.cga> <out.pgn>     Converts an archive back into PGN
+   cppchess-archive show <in.cga> <game>          Prints one game of an archive as PGN
+   cppchess-archive bench <in.pgn> <in.cga> [N]   Compares loading and replaying both files, then reads N random games from the archive
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+/* Include other defined headers */
+#include "Board.hpp"
+#include "GameArchive.hpp"
+#include "MappedFile.hpp"
+#include "PGN.hpp"
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::uint64_t rate(double count, double seconds) {
+    return static_cast<std::uint64_t>(count / (seconds > 0.0 ? seconds : 1e-9));
+}
+
+static int pack(const char * input, const char * output) {
+    std::ifstream file(input, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open " << input << std::endl;
+        return 1;
+    }
+
+    GameArchiveWriter writer;
+    if (!writer.open(output)) {
+        std::cerr << "Unable to create " << output << std::endl;
+        return 1;
+    }
+
+    PGNReader reader(file);
+    PGNGame game;
+    std::uint64_t moves = 0;
+    std::uint64_t failed = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (reader.readGame(game)) {
+        if (!writer.addGame(game)) {
+            std::cerr << "Skipping game " << reader.getGamesRead() << ": a move could not be played" << std::endl;
+            ++failed;
+            continue;
+        }
+        moves += game.moves.size();
+    }
+
+    if (!writer.close()) {
+        std::cerr << "Unable to write " << output << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(start);
+
+    MappedFile archive;
+    std::uint64_t archiveSize = archive.open(output) ? archive.getSize() : 0;
+
+    std::cout << "Games:        " << writer.getGameCount() << " (" << failed << " failed)" << std::endl;
+    std::cout << "Moves:        " << moves << std::endl;
+    std::cout << "PGN size:     " << reader.getBytesRead() << " bytes" << std::endl;
+    std::cout << "Archive size: " << archiveSize << " bytes (" << (reader.getBytesRead() ? 100.0 * archiveSize / reader.getBytesRead() : 0.0) << "%)" << std::endl;
+    std::cout << "Time:         " << seconds << " s" << std::endl;
+
+    return failed == 0 ? 0 : 2;
+}
+
+static int unpack(const char * input, const char * output) {
+    GameArchive archive;
+    if (!archive.open(input)) {
+        std::cerr << "Unable to open archive " << input << std::endl;
+        return 1;
+    }
+
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Unable to create " << output << std::endl;
+        return 1;
+    }
+
+    PGNGame game;
+    std::uint64_t failed = 0;
+    for (std::uint64_t i = 0; i < archive.getGameCount(); ++i) {
+        if (!archive.readGame(i, game)) {
+            std::cerr << "Game " << i << " is corrupted" << std::endl;
+            ++failed;
+            continue;
+        }
+        writePGN(file, game);
+    }
+
+    std::cout << "Games: " << archive.getGameCount() << " (" << failed << " failed)" << std::endl;
+    return failed == 0 ? 0 : 2;
+}
+
+static int show(const char * input, const char * gameNumber) {
+    GameArchive archive;
+    if (!archive.open(input)) {
+        std::cerr << "Unable to open archive " << input << std::endl;
+        return 1;
+    }
+
+    PGNGame game;
+    std::uint64_t index = std::strtoull(gameNumber, nullptr, 10);
+    if (!archive.readGame(index, game)) {
+        std::cerr << "Game " << index << " not found (the archive has " << archive.getGameCount() << " games)" << std::endl;
+        return 1;
+    }
+
+    writePGN(std::cout, game);
+    return 0;
+}
+
+static int bench(const char * pgnPath, const char * archivePath, std::uint64_t randomReads) {
+    Board board;
+    std::vector<Move> moves;
+
+    /* PGN: parse the text and replay the SAN of every game */
+    auto start = std::chrono::steady_clock::now();
+    MappedFile pgn;
+    if (!pgn.open(pgnPath, true)) {
+        std::cerr << "Unable to open " << pgnPath << std::endl;
+        return 1;
+    }
+    PGNReader reader(pgn.getData(), pgn.getSize());
+    PGNGame game;
+    std::uint64_t pgnGames = 0, pgnMoves = 0;
+    while (reader.readGame(game)) {
+        if (replayGame(game, board, &moves)) {
+            ++pgnGames;
+            pgnMoves += moves.size();
+        }
+    }
+    double pgnSeconds = secondsSince(start);
+
+    /* Archive: map the file and decode every game */
+    start = std::chrono::steady_clock::now();
+    GameArchive archive;
+    if (!archive.open(archivePath)) {
+        std::cerr << "Unable to open archive " << archivePath << std::endl;
+        return 1;
+    }
+    double openSeconds = secondsSince(start);
+    std::uint64_t archiveGames = 0, archiveMoves = 0;
+    for (std::uint64_t i = 0; i < archive.getGameCount(); ++i) {
+        if (archive.readMoves(i, board, moves)) {
+            ++archiveGames;
+            archiveMoves += moves.size();
+        }
+    }
+    double archiveSeconds = secondsSince(start);
+
+    std::cout << "Format    Games      Moves       Time (s)   Moves/s" << std::endl;
+    std::cout << "PGN       " << pgnGames << "   " << pgnMoves << "   " << pgnSeconds << "   " << rate(pgnMoves, pgnSeconds) << std::endl;
+    std::cout << "Archive   " << archiveGames << "   " << archiveMoves << "   " << archiveSeconds << "   " << rate(archiveMoves, archiveSeconds) << std::endl;
+    std::cout << "Archive open: " << openSeconds * 1e6 << " us" << std::endl;
+
+    /* Random access: any game is found through the index, without reading the ones before it */
+    if (randomReads > 0 && archive.getGameCount() > 0) {
+        std::mt19937_64 random(2024);
+        std::uniform_int_distribution<std::uint64_t> pick(0, archive.getGameCount() - 1);
+
+        start = std::chrono::steady_clock::now();
+        std::uint64_t randomMoves = 0;
+        for (std::uint64_t i = 0; i < randomReads; ++i) {
+            if (archive.readMoves(pick(random), board, moves)) randomMoves += moves.size();
+        }
+        double randomSeconds = secondsSince(start);
+
+        std::cout << "Random reads: " << randomReads << " games in " << randomSeconds << " s (" << randomSeconds * 1e6 / randomReads << " us per game, " << rate(randomMoves, randomSeconds) << " moves/s)" << std::endl;
+    }
+
+    return 0;
+}
+
+static void usage(const char * program) {
+    std::cerr << "Usage: " << program << " pack <in.pgn> <out.cga>" << std::endl;
+    std::cerr << "       " << program << " unpack <in.cga> <out.pgn>" << std::endl;
+    std::cerr << "       " << program << " show <in.cga> <game>" << std::endl;
+    std::cerr << "       " << program << " bench <in.pgn> <in.cga> [random reads]" << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (std::strcmp(argv[1], "pack") == 0) return pack(argv[2], argv[3]);
+    if (std::strcmp(argv[1], "unpack") == 0) return unpack(argv[2], argv[3]);
+    if (std::strcmp(argv[1], "show") == 0) return show(argv[2], argv[3]);
+    if (std::strcmp(argv[1], "bench") == 0) return bench(argv[2], argv[3], argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1000);
+
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,36 @@
+/* Command line asset bundle packer, run by the build to pack the assets of the GUI
+
+Usage:
+   cppchess-pack <out.bin> <assets dir> <asset>...
+
+The assets are given by their path relative to the assets directory, which is also their name in the bundle
+*/
+
+/* Standard Libraries */
+#include <iostream>
+
+/* Include other defined headers */
+#include "AssetBundle.hpp"
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <out.bin> <assets dir> <asset>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names(argv + 3, argv + argc);
+    if (!writeAssetBundle(argv[1], argv[2], names)) {
+        std::cerr << "Unable to pack the assets of " << argv[2] << " into " << argv[1] << std::endl;
+        return 1;
+    }
+
+    /* Read it back, so a broken bundle fails the build instead of the game */
+    AssetBundle bundle;
+    if (!bundle.open(argv[1])) {
+        std::cerr << "Invalid bundle " << argv[1] << std::endl;
+        return 1;
+    }
+    std::cout << "Packed " << bundle.getAssetCount() << " assets in " << argv[1] << " (" << bundle.getSize() << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+/* Command line search benchmark
+
+Usage:
+   cppchess-bench [depth] [--hash MB] [--trace out.json] [--metrics <file|->] [--metrics-format json|prometheus] [--metrics-interval S]
+
+Searches a fixed set of positions (openings, middlegames, endgames and tactical positions) to the same depth, with one thread and a cleared transposition table before each position. The total node count only depends on the search and evaluation code, so it is the same on every run and platform: it works as a signature of the engine, changing only when its behaviour changes. The nodes per second measure the speed of the machine and the build. With --trace, in a build with CPPCHESS_TRACE, the zones of the searches are written as Chrome trace JSON. With --metrics, the engine counters of the run (nodes, TT probes and hits, cutoffs, evaluations) are written at the end
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+/* Include other defined headers */
+#include "Metrics.hpp"
+#include "Search.hpp"
+#include "Trace.hpp"
+
+static const char * BENCH_POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - 0 1",
+    "8/7p/5k2/5p2/p1p2P2/Pr1pPK2/1P1R3P/8 b - - 0 1",
+    "5rk1/1ppb3p/p1pb4/6q1/3P1p1r/2P1R2P/PP1BQ1P1/5RKN w - - 0 1",
+    "r1bq2rk/pp3pbp/2p1p1pQ/7P/3P4/2PB1N2/PP3PPR/2KR4 w - - 0 1",
+    "5k2/6pp/p1qN4/1p1p4/3P4/2PKP2Q/PP3r2/3R4 b - - 0 1",
+    "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2N2N2/PPPP1PPP/R1BQK2R w KQkq - 6 5",
+    "rn1qkbnr/ppp2ppp/3p4/4P3/4P3/5Q2/PPP2PPP/RNB1KB1R b KQkq - 0 5",
+    "rnbqk2r/ppp2ppp/3bpn2/8/3P4/3B4/PPP2PPP/RNBQK1NR b KQkq - 2 5",
+    "rn1qkb1r/ppp2ppp/5n2/4p3/2B1P3/5Q2/PPP2PPP/RNB1K2R w KQkq - 2 7",
+    "rnbq1rk1/p1p2ppp/1p1bpn2/8/3P4/3B1N2/PPP2PPP/RNBQK2R w KQ - 0 7",
+    "rn2kb1r/pp2qppp/2p2n2/4p1B1/2B1P3/1QN5/PPP2PPP/R3K2R b KQkq - 1 9",
+    "r2qkb1r/1pp2ppp/p2p4/4n3/3QP1b1/2N1B3/PPP1BPPP/R3K2R b KQkq - 4 11",
+    "r2q1rk1/pbp2ppp/2p1p3/3p4/2PPn3/3QB3/P1P1PPPP/1K1R1B1R b - - 0 11",
+    "r2q1rk1/ppp2ppp/2bbp3/8/3P4/2P1BN2/P1P2PPP/R2Q1RK1 b - - 2 11",
+    "r2q1rk1/ppp2ppp/3b1n2/3Pp3/3n4/2NBBP2/PPP2P1P/R2Q1RK1 b - - 0 11",
+    "r2q1rk1/ppp2ppp/3bp3/5b2/1n1Pp3/P1Q1B3/1PP1PPPP/1K1RNB1R b - - 0 11",
+    "r4rk1/pppqbppp/3p1n2/3Pp3/4P1b1/2N1BN1P/PPP1QPP1/R4RK1 b - - 0 11",
+    "3rkb1r/p2nqppp/5n2/1B2p1B1/4P3/1Q6/PPP2PPP/2KR3R w k - 3 13",
+    "4kb1r/p2rqppp/5n2/1B2p1B1/4P3/1Q6/PPP2PPP/2KR4 b k - 1 14",
+    "r4rk1/pppbbppp/8/2PPp1q1/8/5N2/P1P2PPP/R2Q1RK1 w - - 0 16",
+    "r3r1k1/ppp2ppp/3b1q2/3Ppb2/4p3/P3Q2P/1PP1PPP1/1K1RNB1R w - - 1 16",
+    "r4rk1/ppp2ppp/1q3n2/2bP4/2Bp4/3Q1P2/PPP1NP1P/R4RK1 w - - 6 16",
+    "3rr1k1/1ppqbpp1/p2p1n1p/3Pp3/4P3/P1N1BQ1P/1PP2PP1/3RR1K1 w - - 0 16",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "3rr1k1/1ppqbpp1/3p1n2/3Pp3/p3P2p/P1N1BQ1P/1PP2PP1/3RR1K1 b - - 9 24",
+    "3r1rk1/ppp2p2/1b4p1/8/4NP2/1B6/PPPp1P1P/1R3RK1 b - - 0 24",
+    "3r3k/p1p2Bpp/2b5/4q3/3p4/1Q5P/P1P2PP1/1K4R1 b - - 0 24",
+    "3rr1k1/1pp2pp1/p2b1qbp/3Pp3/4p3/P3Q2P/1PP1PPP1/1K1RNBR1 b - - 3 24",
+    "5rk1/pp3ppp/2b2b2/8/6Q1/8/P1PrRPPP/1R4K1 b - - 2 24",
+    "2r1r1k1/1ppqbpp1/3p1n2/3Pp3/p3P2p/P1N1BQ1P/1PP2PP1/2RR2K1 w - - 22 31",
+    "3r4/ppp2pk1/6p1/3N4/2P2b2/PB1r3P/1P1p1P2/3R1RK1 w - - 1 31",
+    "1Q1r2k1/1p3ppp/p1b2b2/8/8/8/P1P1rPPP/2R3K1 w - - 8 31",
+    "3rr1k1/1p3pp1/p1p3b1/2bPp1p1/2B1p3/P3P2P/1PP2PP1/1K1RN2R w - - 0 31",
+    "3rr1k1/1p3pp1/p7/2bPp1p1/4p3/P3P2P/1PN2PP1/1K1RR3 b - - 4 39",
+    "8/p1p2p2/4k1p1/8/4Bb2/P6P/1P1p1P2/5RK1 b - - 0 39",
+    "r2r2k1/1ppqbpp1/3p1n2/3Pp3/p1Q1P2p/P1N1B2P/1PP2PP1/R2R2K1 w - - 62 51",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/8/1p1k4/1P6/2K5/8/8/8 w - - 0 1",
+    "8/p7/1p6/2p5/3p4/4p3/5p2/K6k w - - 0 1",
+    "8/5k2/8/8/8/8/1R6/4K3 w - - 0 1",
+    "8/8/8/4k3/8/8/4P3/4K3 w - - 0 1",
+};
+
+int main(int argc, char * argv[]) {
+
+    int depth = 3;
+    std::size_t hash = 16;
+    const char * tracePath = nullptr;
+    MetricsOptions metricsOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        if (parseMetricsArgument(argc, argv, i, metricsOptions)) continue;
+        if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) hash = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (argv[i][0] != '-') depth = std::atoi(argv[i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [depth] [--hash MB] [--trace out.json] [--metrics <file|->] [--metrics-format json|prometheus] [--metrics-interval S]" << std::endl;
+            return 1;
+        }
+    }
+    if (depth < 1 || depth > MAX_SEARCH_DEPTH) {
+        std::cerr << "The depth must be between 1 and " << MAX_SEARCH_DEPTH << std::endl;
+        return 1;
+    }
+
+    /* Fixed depth only: time or node limits would make the count depend on the machine */
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.useBook = false;
+    limits.useTablebase = false;
+
+    MetricsExporter exporter(metricsOptions);
+    Search search(hash);
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+    const std::size_t count = sizeof(BENCH_POSITIONS) / sizeof(BENCH_POSITIONS[0]);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Board board;
+        try {
+            if (!board.loadFromFEN(BENCH_POSITIONS[i])) throw std::runtime_error("invalid FEN");
+        } catch (const std::exception & e) {
+            std::cerr << "Position " << i + 1 << ": " << e.what() << std::endl;
+            return 1;
+        }
+
+        search.clear();
+        auto start = std::chrono::steady_clock::now();
+        search.think(board, limits);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::uint64_t positionNodes = search.getStats().nodes;
+        nodes += positionNodes;
+        std::cout << "Position " << std::setw(2) << i + 1 << "/" << count << "  nodes " << std::setw(9) << positionNodes << "  " << BENCH_POSITIONS[i] << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "Depth:          " << depth << std::endl;
+    std::cout << "Total time:     " << static_cast<std::uint64_t>(seconds * 1000.0) << " ms" << std::endl;
+    std::cout << "Nodes searched: " << nodes << std::endl;
+    std::cout << "Nodes/second:   " << static_cast<std::uint64_t>(seconds > 0.0 ? nodes / seconds : 0.0) << std::endl;
+
+    if (tracePath != nullptr) {
+        if (!writeTrace(tracePath)) {
+            std::cerr << "Unable to write the trace " << tracePath << (isTraceEnabled() ? "" : " (built without CPPCHESS_TRACE)") << std::endl;
+            return 1;
+        }
+        std::cout << "Trace:          " << getTraceEventCount() << " zones (" << getTraceDroppedCount() << " dropped) in " << tracePath << std::endl;
+    }
+    return 0;
+}
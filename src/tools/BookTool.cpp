@@ -0,0 +1,119 @@
+/* Command line Polyglot opening book builder and prober
+
+Usage:
+   cppchess-book build <in.pgn> <out.bin> [--max-ply N] [--min-count N]   Builds a book from the games of a PGN file, weighting each move by how often it was played
+   cppchess-book probe <book.bin> ["<FEN>"]                               Lists the book moves of a position (the initial position by default)
+   cppchess-book verify-keys                                              Checks the Zobrist keys against the positions published with the Polyglot format
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+/* Include other defined headers */
+#include "Notation.hpp"
+#include "PGN.hpp"
+#include "PolyglotBook.hpp"
+#include "Zobrist.hpp"
+
+static int build(const char * pgnPath, const char * bookPath, int maxPly, std::uint32_t minCount) {
+    std::ifstream file(pgnPath, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open " << pgnPath << std::endl;
+        return 1;
+    }
+
+    PolyglotBookBuilder builder(maxPly, minCount);
+    PGNReader reader(file);
+    PGNGame game;
+    std::uint64_t failed = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (reader.readGame(game)) {
+        if (!builder.addGame(game)) ++failed;
+    }
+
+    if (!builder.write(bookPath)) {
+        std::cerr << "Unable to write " << bookPath << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Games:   " << reader.getGamesRead() << " (" << failed << " with unplayable moves)" << std::endl;
+    std::cout << "Entries: " << builder.getPositionMoveCount() << " position/move pairs before --min-count" << std::endl;
+    std::cout << "Time:    " << seconds << " s" << std::endl;
+    return 0;
+}
+
+static int probe(const char * bookPath, const std::string & fen) {
+    PolyglotBook book;
+    if (!book.open(bookPath)) {
+        std::cerr << "Unable to open book " << bookPath << std::endl;
+        return 1;
+    }
+
+    Board board;
+    try {
+        if (!board.loadFromFEN(fen)) throw std::invalid_argument("Invalid FEN");
+    } catch (const std::exception &) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return 1;
+    }
+
+    std::vector<BookMove> moves;
+    auto start = std::chrono::steady_clock::now();
+    book.findMoves(board, moves);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::uint64_t total = 0;
+    for (const BookMove & move : moves) total += move.weight;
+
+    for (const BookMove & move : moves) {
+        char san[SAN_BUFFER_SIZE];
+        writeSAN(board, move.move, san, sizeof(san));
+        std::cout << san << "\t" << move.weight << "\t" << (total ? 100.0 * move.weight / total : 0.0) << "%" << std::endl;
+    }
+
+    std::cout << moves.size() << " book moves (" << book.getEntryCount() << " entries) in " << seconds * 1e6 << " us" << std::endl;
+    return 0;
+}
+
+static void usage(const char * program) {
+    std::cerr << "Usage: " << program << " build <in.pgn> <out.bin> [--max-ply N] [--min-count N]" << std::endl;
+    std::cerr << "       " << program << " probe <book.bin> [\"<FEN>\"]" << std::endl;
+    std::cerr << "       " << program << " verify-keys" << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc == 2 && std::strcmp(argv[1], "verify-keys") == 0) {
+        if (!verifyPolyglotKeys()) return 1;
+        std::cout << "The keys match Polyglot" << std::endl;
+        return 0;
+    }
+
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (std::strcmp(argv[1], "build") == 0 && argc >= 4) {
+        int maxPly = 30;
+        std::uint32_t minCount = 1;
+        for (int i = 4; i + 1 < argc; ++i) {
+            if (std::strcmp(argv[i], "--max-ply") == 0) maxPly = std::atoi(argv[++i]);
+            else if (std::strcmp(argv[i], "--min-count") == 0) minCount = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        }
+        return build(argv[2], argv[3], maxPly, minCount);
+    }
+
+    if (std::strcmp(argv[1], "probe") == 0)
+        return probe(argv[2], argc > 3 ? argv[3] : "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,213 @@
+/* Command line training data generator
+
+Usage:
+   cppchess-datagen generate <out prefix> [options]   Plays self-play games and writes their quiet positions, one shard per thread (<prefix>.<thread>.bin)
+   cppchess-datagen dump <shard.bin> [--limit N]      Prints the records of a shard: FEN, score and result
+
+Options of generate:
+   --threads N        Games played at the same time, 0 uses every core (default 0)
+   --depth N          Search depth of every move (default 4)
+   --nodes N          Search nodes of every move, instead of the depth
+   --positions N      Stops after writing about N positions (default 100000)
+   --random-plies N   Random moves played before the engine takes over, so the games differ (default 8)
+   --seed S           Seed of the random moves (default 1)
+   --hash MB          Transposition table of each thread (default 16)
+   --tb <dirs>        Syzygy tablebases, to adjudicate the games with --tb-adjudicate
+   --tb-adjudicate    Adjudicates the positions the tablebases cover. Off by default, until the prober passes cppchess-tb --verify on real tables
+   --metrics <file|-> Writes the engine counters while generating, and at the end
+   --metrics-format F json or prometheus (default prometheus)
+   --metrics-interval S  Seconds between two writes (default 10)
+
+A position is quiet, and kept, if the side to move is not in check, the best move is not a capture or promotion, and the score is not a mate
+*/
+
+/* Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+/* Include other defined headers */
+#include "Metrics.hpp"
+#include "SelfPlay.hpp"
+#include "TrainingData.hpp"
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool isQuiet(const Board & board, const SearchResult & result) {
+    const King * king = board.getKing(board.getTurn());
+    if (king && king->isChecked()) return false;
+    if (std::abs(result.score) > TB_WIN_BOUND) return false;
+
+    const Move & move = result.bestMove;
+    const Piece * piece = board.board[move.from];
+    bool capture = board.board[move.to] != nullptr || (piece->getType() == PieceType::Pawn && move.to == board.getEnPassantIndex());
+    bool promotion = piece->getType() == PieceType::Pawn && (move.to < 8 || move.to >= 56);
+    return !capture && !promotion;
+}
+
+static int generate(const std::string & prefix, unsigned threads, const SearchLimits & limits, std::uint64_t target, int randomPlies, std::uint64_t seed, std::size_t hash, const std::string & tablebasePaths) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    /* Only set with --tb-adjudicate */
+    Tablebase tablebase;
+    if (!tablebasePaths.empty()) tablebase.init(tablebasePaths);
+
+    std::vector<TrainingDataWriter> writers(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        std::string path = prefix + "." + std::to_string(i) + ".bin";
+        if (!writers[i].open(path)) {
+            std::cerr << "Unable to create " << path << std::endl;
+            return 1;
+        }
+    }
+
+    /* Only counters are shared: every thread has its own engine, random generator and writer */
+    std::atomic<std::uint64_t> positions(0), searched(0), games(0);
+    std::atomic<bool> done(false);
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&](unsigned id) {
+        Search search(hash);
+        std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ULL + id);
+        SelfPlayOptions options;
+        options.limits[0] = limits;
+        options.limits[1] = limits;
+        options.tablebase = tablebase.getMaxPieces() > 0 ? &tablebase : nullptr;
+
+        PGNGame record;
+        Opening opening;
+        std::vector<TrainingRecord> gameRecords;
+        TrainingDataWriter & writer = writers[id];
+
+        while (positions.load(std::memory_order_relaxed) < target) {
+            if (!randomOpening(randomPlies, random, opening)) continue;
+
+            gameRecords.clear();
+            GameEnd end = playGame(opening, search, search, options, record, [&](const Board & board, const SearchResult & result) {
+                searched.fetch_add(1, std::memory_order_relaxed);
+                TrainingRecord packed;
+                if (isQuiet(board, result) && packTrainingRecord(board, result.score, packed)) gameRecords.push_back(packed);
+            });
+            if (end == GameEnd::None) continue;
+
+            /* The result is only known at the end of the game */
+            int whiteResult = record.result == "1-0" ? 1 : record.result == "0-1" ? -1 : 0;
+            for (TrainingRecord & packed : gameRecords) {
+                packed.result = static_cast<std::int8_t>((packed.flags & 1) ? -whiteResult : whiteResult);
+                writer.write(packed);
+            }
+            positions.fetch_add(gameRecords.size(), std::memory_order_relaxed);
+            games.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) pool.emplace_back(worker, i);
+
+    /* Progress every few seconds while the workers run */
+    std::thread progress([&] {
+        auto last = std::chrono::steady_clock::now();
+        while (!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            if (secondsSince(last) < 5.0) continue;
+            last = std::chrono::steady_clock::now();
+            double seconds = secondsSince(start);
+            std::cout << positions.load() << " positions, " << games.load() << " games, " << positions.load() / seconds << " positions/s" << std::endl;
+        }
+    });
+
+    for (std::thread & thread : pool) thread.join();
+    done = true;
+    progress.join();
+
+    bool good = true;
+    for (TrainingDataWriter & writer : writers) good = writer.close() && good;
+    double seconds = secondsSince(start);
+
+    std::cout << "Games:      " << games.load() << std::endl;
+    std::cout << "Positions:  " << positions.load() << " written of " << searched.load() << " searched, in " << threads << " shards of " << sizeof(TrainingRecord) << " byte records" << std::endl;
+    std::cout << "Time:       " << seconds << " s" << std::endl;
+    std::cout << "Throughput: " << positions.load() / seconds << " positions/s (" << searched.load() / seconds << " searches/s)" << std::endl;
+    return good ? 0 : 1;
+}
+
+static int dump(const char * path, std::uint64_t limit) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return 1;
+    }
+
+    TrainingRecord record;
+    std::uint64_t count = 0;
+    while (count < limit && file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        std::cout << trainingRecordToFEN(record) << " | " << record.score << " | " << static_cast<int>(record.result) << std::endl;
+        ++count;
+    }
+    return 0;
+}
+
+static void usage(const char * program) {
+    std::cerr << "Usage: " << program << " generate <out prefix> [--threads N] [--depth N | --nodes N] [--positions N] [--random-plies N] [--seed S] [--hash MB] [--tb dirs --tb-adjudicate] [--metrics <file|->] [--metrics-format json|prometheus] [--metrics-interval S]" << std::endl;
+    std::cerr << "       " << program << " dump <shard.bin> [--limit N]" << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    unsigned threads = 0;
+    SearchLimits limits;
+    limits.depth = 4;
+    limits.useBook = false;
+    std::uint64_t target = 100000, limit = 20, seed = 1;
+    int randomPlies = 8;
+    std::size_t hash = 16;
+    std::string tablebasePaths;
+    bool tablebaseAdjudication = false;
+    MetricsOptions metricsOptions;
+
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tb-adjudicate") == 0) {
+            tablebaseAdjudication = true;
+            continue;
+        }
+        if (i + 1 == argc) break;
+        if (parseMetricsArgument(argc, argv, i, metricsOptions)) continue;
+        if (std::strcmp(argv[i], "--threads") == 0) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--depth") == 0) limits.depth = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--nodes") == 0) {
+            limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+            limits.depth = MAX_SEARCH_DEPTH;
+        }
+        else if (std::strcmp(argv[i], "--positions") == 0) target = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--random-plies") == 0) randomPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--hash") == 0) hash = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--tb") == 0) tablebasePaths = argv[++i];
+        else if (std::strcmp(argv[i], "--limit") == 0) limit = std::strtoull(argv[++i], nullptr, 10);
+    }
+
+    if (!tablebasePaths.empty() && !tablebaseAdjudication) {
+        std::cerr << "The tablebases are not used without --tb-adjudicate" << std::endl;
+        tablebasePaths.clear();
+    }
+
+    MetricsExporter exporter(metricsOptions);
+    if (std::strcmp(argv[1], "generate") == 0) return generate(argv[2], threads, limits, target, randomPlies, seed, hash, tablebasePaths);
+    if (std::strcmp(argv[1], "dump") == 0) return dump(argv[2], limit);
+
+    usage(argv[0]);
+    return 1;
+}
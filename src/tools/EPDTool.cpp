@@ -0,0 +1,242 @@
+/* Command line EPD test suite runner
+
+Usage:
+   cppchess-epd <suite.epd> [--nodes N] [--time S] [--depth N] [--threads N] [--hash MB] [--csv out.csv]
+
+Each position is searched under the budget (1 second by default) and is solved if the engine plays one of its best moves (bm) and none of its avoid moves (am). The time to solution is the end of the first completed iteration after which the best move stayed right until the end of the search. More information: https://www.chessprogramming.org/Extended_Position_Description
+*/
+
+/* Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+/* Include other defined headers */
+#include "Notation.hpp"
+#include "Search.hpp"
+
+struct EPDPosition {
+    std::string fen;
+    std::string id;
+    std::vector<std::string> bestMoves;  /* bm */
+    std::vector<std::string> avoidMoves; /* am */
+};
+
+struct EPDResult {
+    bool valid = false;
+    bool solved = false;
+    std::string move;
+    int score = 0;
+    int depth = 0;
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+    double solvedSeconds = -1.0; /* Time to solution, -1 if not solved */
+};
+
+/* Splits the operations after the four FEN fields: opcodes followed by operands, ended by semicolons. Quoted operands may contain spaces and semicolons */
+static bool parseEPD(const std::string & line, EPDPosition & position) {
+    std::istringstream input(line);
+    std::string placement, turn, castling, enPassant;
+    if (!(input >> placement >> turn >> castling >> enPassant)) return false;
+    position.fen = placement + " " + turn + " " + castling + " " + enPassant + " 0 1";
+
+    std::string rest;
+    std::getline(input, rest);
+
+    std::vector<std::string> tokens;
+    std::string token;
+    bool quoted = false;
+    auto endToken = [&] {
+        if (!token.empty()) tokens.push_back(token);
+        token.clear();
+    };
+    auto endOperation = [&] {
+        endToken();
+        if (tokens.empty()) return;
+        std::vector<std::string> operands(tokens.begin() + 1, tokens.end());
+        if (tokens[0] == "bm") position.bestMoves = operands;
+        else if (tokens[0] == "am") position.avoidMoves = operands;
+        else if (tokens[0] == "id" && !operands.empty()) position.id = operands[0];
+        tokens.clear();
+    };
+
+    for (char c : rest) {
+        if (c == '"') quoted = !quoted;
+        else if (quoted) token += c;
+        else if (c == ';') endOperation();
+        else if (std::isspace(static_cast<unsigned char>(c))) endToken();
+        else token += c;
+    }
+    endOperation();
+    return true;
+}
+
+static bool containsMove(const Board & board, const std::vector<std::string> & sans, const Move & move) {
+    for (const std::string & san : sans) {
+        Move parsed;
+        if (parseSAN(board, san, parsed) && parsed == move) return true;
+    }
+    return false;
+}
+
+static bool isRight(const Board & board, const EPDPosition & position, const Move & move) {
+    if (!position.bestMoves.empty() && !containsMove(board, position.bestMoves, move)) return false;
+    return !containsMove(board, position.avoidMoves, move);
+}
+
+static void solve(const EPDPosition & position, const SearchLimits & limits, Search & search, EPDResult & result) {
+    Board board;
+    try {
+        if (!board.loadFromFEN(position.fen)) return;
+    } catch (const std::exception &) {
+        return;
+    }
+
+    /* The solution time is reset whenever an iteration changes to a wrong move */
+    search.clear();
+    search.setInfoCallback([&](const SearchResult & iteration, const SearchStats & stats) {
+        if (!isRight(board, position, iteration.bestMove)) result.solvedSeconds = -1.0;
+        else if (result.solvedSeconds < 0.0) result.solvedSeconds = stats.seconds;
+    });
+
+    SearchResult searched = search.think(board, limits);
+    const SearchStats & stats = search.getStats();
+
+    result.valid = searched.bestMove.from >= 0;
+    if (!result.valid) return;
+
+    char san[SAN_BUFFER_SIZE];
+    writeSAN(board, searched.bestMove, san, sizeof(san));
+    result.move = san;
+    result.score = searched.score;
+    result.depth = searched.depth;
+    result.nodes = stats.nodes;
+    result.seconds = stats.seconds;
+    result.solved = isRight(board, position, searched.bestMove);
+    if (!result.solved) result.solvedSeconds = -1.0;
+    else if (result.solvedSeconds < 0.0) result.solvedSeconds = stats.seconds;
+}
+
+static std::string join(const std::vector<std::string> & items) {
+    std::string text;
+    for (const std::string & item : items) text += (text.empty() ? "" : " ") + item;
+    return text;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <suite.epd> [--nodes N] [--time S] [--depth N] [--threads N] [--hash MB] [--csv out.csv]" << std::endl;
+        return 1;
+    }
+
+    SearchLimits limits;
+    limits.useBook = false;
+    unsigned threads = 0;
+    std::size_t hash = 16;
+    std::string csvPath;
+    bool budget = false;
+
+    for (int i = 2; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--nodes") == 0) { limits.nodes = std::strtoull(argv[++i], nullptr, 10); budget = true; }
+        else if (std::strcmp(argv[i], "--time") == 0) { limits.seconds = std::atof(argv[++i]); budget = true; }
+        else if (std::strcmp(argv[i], "--depth") == 0) { limits.depth = std::atoi(argv[++i]); budget = true; }
+        else if (std::strcmp(argv[i], "--threads") == 0) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--hash") == 0) hash = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--csv") == 0) csvPath = argv[++i];
+    }
+    if (!budget) limits.seconds = 1.0;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::ifstream file(argv[1]);
+    if (!file) {
+        std::cerr << "Unable to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<EPDPosition> positions;
+    std::string line;
+    while (std::getline(file, line)) {
+        EPDPosition position;
+        if (parseEPD(line, position)) {
+            if (position.id.empty()) position.id = std::to_string(positions.size() + 1);
+            positions.push_back(std::move(position));
+        }
+    }
+
+    /* Every thread solves the next position left, with its own engine */
+    std::vector<EPDResult> results(positions.size());
+    std::atomic<std::size_t> next(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) {
+        pool.emplace_back([&] {
+            Search search(hash);
+            for (std::size_t index = next++; index < positions.size(); index = next++)
+                solve(positions[index], limits, search, results[index]);
+        });
+    }
+    for (std::thread & thread : pool) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t solved = 0, invalid = 0;
+    std::uint64_t nodes = 0;
+    double solvedTime = 0.0, searchTime = 0.0;
+
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const EPDPosition & position = positions[i];
+        const EPDResult & result = results[i];
+        if (!result.valid) {
+            ++invalid;
+            std::cout << std::setw(20) << std::left << position.id << " invalid position" << std::endl;
+            continue;
+        }
+
+        nodes += result.nodes;
+        searchTime += result.seconds;
+        if (result.solved) {
+            ++solved;
+            solvedTime += result.solvedSeconds;
+        }
+
+        std::cout << std::setw(20) << std::left << position.id << std::right << (result.solved ? " ok   " : " FAIL ")
+                  << std::setw(8) << result.move << "  expected " << std::setw(12) << std::left << (position.bestMoves.empty() ? "not " + join(position.avoidMoves) : join(position.bestMoves)) << std::right
+                  << " nodes " << std::setw(9) << result.nodes << "  depth " << std::setw(2) << result.depth << "  time " << std::fixed << std::setprecision(3) << result.seconds;
+        if (result.solved) std::cout << "  solved at " << result.solvedSeconds;
+        std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    std::size_t searched = positions.size() - invalid;
+    std::cout << std::endl;
+    std::cout << "Solved:   " << solved << " / " << searched << std::endl;
+    std::cout << "Mean time to solution: " << (solved ? solvedTime / solved : 0.0) << " s" << std::endl;
+    std::cout << "Nodes:    " << nodes << " (" << (searchTime > 0.0 ? nodes / searchTime : 0.0) << " nps per thread)" << std::endl;
+    std::cout << "Time:     " << seconds << " s on " << threads << " threads" << std::endl;
+
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath, std::ios::trunc);
+        csv << "id,solved,move,expected,avoid,score,depth,nodes,seconds,solved_seconds\n";
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            const EPDResult & result = results[i];
+            if (!result.valid) continue;
+            csv << '"' << positions[i].id << "\"," << result.solved << ',' << result.move << ",\"" << join(positions[i].bestMoves) << "\",\"" << join(positions[i].avoidMoves) << "\","
+                << result.score << ',' << result.depth << ',' << result.nodes << ',' << result.seconds << ',' << result.solvedSeconds << '\n';
+        }
+        if (!csv) {
+            std::cerr << "Unable to write " << csvPath << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/* Command line position search over a game archive
+
+Usage:
+   cppchess-index build <in.cga> <out.idx> [--run-entries N]   Indexes every position of the games of an archive
+   cppchess-index query <in.idx> "<FEN>" [--archive in.cga] [--limit N]   Finds the games that reached a position
+   cppchess-index query <in.idx> --material KRPkr [--archive in.cga] [--limit N]   Finds the games that reached a material, White in uppercase and Black in lowercase
+
+The archive is created from a PGN file with cppchess-archive pack. With --archive, the players of the matching games are printed too
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/* Include other defined headers */
+#include "GameArchive.hpp"
+#include "PositionIndex.hpp"
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double percent(std::uint64_t count, std::uint64_t total) {
+    return total ? 100.0 * count / total : 0.0;
+}
+
+static int build(const char * archivePath, const char * indexPath, std::size_t runEntries) {
+    GameArchive archive;
+    if (!archive.open(archivePath)) {
+        std::cerr << "Unable to open archive " << archivePath << std::endl;
+        return 1;
+    }
+
+    PositionIndexBuilder builder(runEntries);
+    if (!builder.open(indexPath)) {
+        std::cerr << "Unable to create " << indexPath << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t failed = 0;
+    for (std::uint64_t i = 0; i < archive.getGameCount(); ++i) {
+        if (!builder.addGame(archive, i)) {
+            std::cerr << "Skipping game " << i << ": it could not be decoded" << std::endl;
+            ++failed;
+        }
+    }
+    double replaySeconds = secondsSince(start);
+    std::size_t runs = builder.getRunCount();
+
+    if (!builder.close()) {
+        std::cerr << "Unable to write " << indexPath << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(start);
+
+    std::cout << "Games:     " << archive.getGameCount() << " (" << failed << " failed)" << std::endl;
+    std::cout << "Positions: " << builder.getEntryCount() << " (" << builder.getMaterialEntryCount() << " materials)" << std::endl;
+    std::cout << "Runs:      " << (runs ? runs + 1 : 0) << std::endl;
+    std::cout << "Time:      " << seconds << " s (" << replaySeconds << " s replaying)" << std::endl;
+
+    return failed == 0 ? 0 : 2;
+}
+
+/* With material, the argument is a material signature instead of a FEN */
+static int query(const char * indexPath, const char * fen, bool material, const char * archivePath, std::size_t limit) {
+    PositionIndex index;
+    if (!index.open(indexPath)) {
+        std::cerr << "Unable to open index " << indexPath << std::endl;
+        return 1;
+    }
+
+    GameArchive archive;
+    if (archivePath && !archive.open(archivePath)) {
+        std::cerr << "Unable to open archive " << archivePath << std::endl;
+        return 1;
+    }
+
+    std::vector<PositionEntry> matches;
+    PositionStats stats;
+    auto start = std::chrono::steady_clock::now();
+    if (material ? !index.queryMaterial(fen, matches, stats, limit) : !index.query(fen, matches, stats, limit)) {
+        std::cerr << (material ? "Invalid material: " : "Invalid FEN: ") << fen << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(start);
+
+    std::cout << "Games:  " << stats.games << " (" << stats.occurrences << " occurrences)" << std::endl;
+    std::cout << "White:  " << stats.whiteWins << " (" << percent(stats.whiteWins, stats.games) << "%)" << std::endl;
+    std::cout << "Draw:   " << stats.draws << " (" << percent(stats.draws, stats.games) << "%)" << std::endl;
+    std::cout << "Black:  " << stats.blackWins << " (" << percent(stats.blackWins, stats.games) << "%)" << std::endl;
+    if (stats.unknown) std::cout << "Other:  " << stats.unknown << std::endl;
+    std::cout << "Time:   " << seconds * 1000.0 << " ms" << std::endl;
+
+    for (const PositionEntry & match : matches) {
+        std::cout << "Game " << match.game << ", ply " << match.ply;
+
+        PGNGame game;
+        if (archive.getGameCount() > match.game && archive.readGame(match.game, game)) {
+            const std::string * white = game.findTag("White");
+            const std::string * black = game.findTag("Black");
+            std::cout << ": " << (white ? *white : "?") << " - " << (black ? *black : "?") << " " << game.result;
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
+
+static void usage(const char * program) {
+    std::cerr << "Usage: " << program << " build <in.cga> <out.idx> [--run-entries N]" << std::endl;
+    std::cerr << "       " << program << " query <in.idx> \"<FEN>\" [--archive in.cga] [--limit N]" << std::endl;
+    std::cerr << "       " << program << " query <in.idx> --material KRPkr [--archive in.cga] [--limit N]" << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /* query --material takes one more argument */
+    bool material = std::strcmp(argv[3], "--material") == 0;
+    if (material && argc < 5) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char * target = material ? argv[4] : argv[3];
+
+    std::size_t runEntries = 1 << 24;
+    std::size_t limit = 20;
+    const char * archivePath = nullptr;
+    for (int i = material ? 5 : 4; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--run-entries") == 0) runEntries = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--limit") == 0) limit = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--archive") == 0) archivePath = argv[++i];
+    }
+
+    if (std::strcmp(argv[1], "build") == 0) return build(argv[2], argv[3], runEntries);
+    if (std::strcmp(argv[1], "query") == 0) return query(argv[2], target, material, archivePath, limit);
+
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,391 @@
+/* Command line load generator of cppchess-server (Linux)
+
+Usage:
+   cppchess-loadgen [options]
+
+Options:
+   --host <address>       Address of the server (default 127.0.0.1)
+   --port N               TCP port of the server (default 7878)
+   --games N              Games played at the same time (default 1000)
+   --connections N        Connections the games are spread over (default 100)
+   --seconds S            Duration of the test (default 10)
+   --engine P             Percent of the games played against the engine of the server (default 0)
+   --max-plies N          Longer games are resigned (default 200)
+   --think MS             Mean time a player takes before each move (default 0: the next move is sent as soon as the previous one is answered)
+   --seed S               Seed of the random moves (default 1)
+
+Every game plays random legal moves. In a game between two players, White and Black are on two different connections, so each move goes through the server to the opponent. A finished game is replaced by a new one, keeping the number of games. Without think time every game always has a move in flight, which measures the most the server can play; the latency then mostly shows the queue of N games. With it, the games send about N / think moves per second, like players would, and the latency shows how the server copes with that rate. The moves are checked on a local HeadlessGame, which also tells when the game ends.
+
+The move latency is the time from sending a move to its answer (ok). Against the engine, the engine latency is the time from sending a move to the reply of the engine (moved), which includes its search
+*/
+
+/* Standard Libraries */
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* Include other defined headers */
+#include "HeadlessGame.hpp"
+#include "LineSocket.hpp"
+#include "Notation.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    int port = 7878;
+    std::size_t games = 1000;
+    std::size_t connections = 100;
+    double seconds = 10.0;
+    int enginePercent = 0;
+    int maxPlies = 200;
+    double think = 0.0; /* Milliseconds */
+    std::uint64_t seed = 1;
+};
+
+/* One of the concurrent games, replaced by a new one when it ends */
+struct Slot {
+    std::uint64_t id = 0; /* Server id, 0 while it is created */
+    HeadlessGame game;
+    std::size_t players[2] = {0, 0}; /* Connections of White and Black */
+    bool engine = false;
+    Clock::time_point sent; /* Of the last move */
+};
+
+struct Client {
+    LineSocket socket;
+    std::deque<std::size_t> creating; /* Slots waiting for their created answer, which come in order */
+    bool dirty = false;
+    bool writing = false;
+};
+
+/* Latencies in microseconds */
+static double percentile(std::vector<float> & values, double fraction) {
+    if (values.empty()) return 0.0;
+    std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static void printLatency(const char * label, std::vector<float> & values) {
+    std::cout << label << std::fixed << std::setprecision(2) << "p50 " << percentile(values, 0.50) / 1000.0 << " ms, p90 " << percentile(values, 0.90) / 1000.0 << " ms, p99 " << percentile(values, 0.99) / 1000.0
+              << " ms, max " << (values.empty() ? 0.0 : *std::max_element(values.begin(), values.end()) / 1000.0) << " ms (" << values.size() << " moves)" << std::endl;
+}
+
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const LoadOptions & options) : mOptions(options), mRandom(options.seed), mEpollFd(-1), mStopping(false), mMoves(0), mEngineMoves(0), mFinished(0), mErrors(0) {}
+
+    ~LoadGenerator() {
+        for (Client & client : mClients) if (client.socket.getFd() >= 0) ::close(client.socket.getFd());
+        if (mEpollFd >= 0) ::close(mEpollFd);
+    }
+
+    bool connect();
+    void run();
+    void report(double seconds);
+
+private:
+    void startGame(std::size_t slot);
+    void sendMove(std::size_t slot);
+    void playMove(std::size_t slot);
+    void sendDueMoves();
+    void send(std::size_t client, const std::string & text);
+    void handleLine(std::size_t client, std::string_view line);
+    void flush();
+    std::size_t findSlot(std::string_view id) const;
+
+    LoadOptions mOptions;
+    std::mt19937_64 mRandom;
+    int mEpollFd;
+    bool mStopping;
+    std::vector<Client> mClients;
+    std::vector<Slot> mSlots;
+    std::unordered_map<std::uint64_t, std::size_t> mIds; /* Server id to slot */
+    std::vector<std::size_t> mDirty;
+    std::vector<Move> mLegalMoves;
+
+    /* Moves waiting for the think time of their player, the earliest first */
+    using Thought = std::pair<Clock::time_point, std::size_t>;
+    std::priority_queue<Thought, std::vector<Thought>, std::greater<Thought>> mThinking;
+
+    std::uint64_t mMoves;
+    std::uint64_t mEngineMoves;
+    std::uint64_t mFinished;
+    std::uint64_t mErrors;
+    std::vector<float> mMoveLatencies;
+    std::vector<float> mEngineLatencies;
+};
+
+bool LoadGenerator::connect() {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(mOptions.port));
+    if (::inet_pton(AF_INET, mOptions.host.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "Invalid address " << mOptions.host << std::endl;
+        return false;
+    }
+
+    mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (mEpollFd < 0) return false;
+
+    mClients.resize(mOptions.connections);
+    for (std::size_t i = 0; i < mClients.size(); ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+            std::cerr << "Unable to connect to " << mOptions.host << ":" << mOptions.port << ": " << std::strerror(errno) << std::endl;
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        setNonBlocking(fd);
+        mClients[i].socket = LineSocket(fd);
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = i;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+    return true;
+}
+
+void LoadGenerator::run() {
+    /* The engine games are spread evenly over the slots */
+    mSlots.resize(mOptions.games);
+    for (std::size_t i = 0; i < mSlots.size(); ++i) {
+        Slot & slot = mSlots[i];
+        slot.players[0] = i % mClients.size();
+        slot.players[1] = (i + 1) % mClients.size();
+        slot.engine = (i * mOptions.enginePercent) / 100 != ((i + 1) * mOptions.enginePercent) / 100;
+        startGame(i);
+    }
+    flush();
+
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(mOptions.seconds));
+    epoll_event events[256];
+    while (Clock::now() < deadline) {
+        int timeout = 100;
+        if (!mThinking.empty())
+            timeout = static_cast<int>(std::clamp<Clock::rep>(std::chrono::duration_cast<std::chrono::milliseconds>(mThinking.top().first - Clock::now()).count(), 0, timeout));
+
+        int count = ::epoll_wait(mEpollFd, events, 256, timeout);
+        for (int i = 0; i < count; ++i) {
+            std::size_t client = events[i].data.u64;
+            if (events[i].events & EPOLLOUT) {
+                if (!mClients[client].dirty) mDirty.push_back(client);
+                mClients[client].dirty = true;
+            }
+            if (!(events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) continue;
+
+            LineSocket & socket = mClients[client].socket;
+            bool open = socket.receive();
+            std::string_view line;
+            while (socket.nextLine(line)) handleLine(client, line);
+            if (!open) {
+                std::cerr << "The server closed the connection" << std::endl;
+                return;
+            }
+        }
+        sendDueMoves();
+        flush();
+    }
+    mStopping = true;
+}
+
+void LoadGenerator::startGame(std::size_t index) {
+    Slot & slot = mSlots[index];
+    slot.id = 0;
+    slot.game.start();
+    send(slot.players[0], slot.engine ? "create white engine\n" : "create white\n");
+    mClients[slot.players[0]].creating.push_back(index);
+}
+
+/* The player thinks first, if there is a think time. It varies around its mean, so the games do not all move at once */
+void LoadGenerator::sendMove(std::size_t index) {
+    if (mOptions.think <= 0.0) {
+        playMove(index);
+        return;
+    }
+    double think = std::uniform_real_distribution<double>(0.0, 2.0 * mOptions.think)(mRandom);
+    mThinking.push({Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(think)), index});
+}
+
+void LoadGenerator::sendDueMoves() {
+    Clock::time_point now = Clock::now();
+    while (!mThinking.empty() && mThinking.top().first <= now) {
+        std::size_t index = mThinking.top().second;
+        mThinking.pop();
+        playMove(index);
+    }
+}
+
+/* Plays a random legal move for the side to move, or resigns a game which is too long */
+void LoadGenerator::playMove(std::size_t index) {
+    Slot & slot = mSlots[index];
+    std::size_t client = slot.players[slot.game.getTurn() == Color::White ? 0 : 1];
+    std::string id = std::to_string(slot.id);
+    if (slot.game.getPlies() >= mOptions.maxPlies) {
+        send(client, "resign " + id + "\n");
+        return;
+    }
+
+    slot.game.getBoard().generateLegalMoves(mLegalMoves);
+    const Move & move = mLegalMoves[std::uniform_int_distribution<std::size_t>(0, mLegalMoves.size() - 1)(mRandom)];
+    char uci[UCI_BUFFER_SIZE];
+    writeUCI(move, uci, sizeof(uci));
+    slot.sent = Clock::now();
+    send(client, "move " + id + " " + uci + "\n");
+}
+
+void LoadGenerator::send(std::size_t client, const std::string & text) {
+    mClients[client].socket.send(text);
+    if (!mClients[client].dirty) {
+        mClients[client].dirty = true;
+        mDirty.push_back(client);
+    }
+}
+
+void LoadGenerator::flush() {
+    for (std::size_t index : mDirty) {
+        Client & client = mClients[index];
+        client.dirty = false;
+        if (!client.socket.flush()) continue;
+
+        bool writing = client.socket.hasOutput();
+        if (writing != client.writing) {
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | (writing ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+            event.data.u64 = index;
+            ::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, client.socket.getFd(), &event);
+            client.writing = writing;
+        }
+    }
+    mDirty.clear();
+}
+
+std::size_t LoadGenerator::findSlot(std::string_view id) const {
+    auto found = mIds.find(std::strtoull(std::string(id).c_str(), nullptr, 10));
+    return found == mIds.end() ? mSlots.size() : found->second;
+}
+
+void LoadGenerator::handleLine(std::size_t client, std::string_view line) {
+    std::size_t space = line.find(' ');
+    std::string_view command = line.substr(0, space);
+    std::string_view rest = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+    std::string_view id = rest.substr(0, rest.find(' '));
+    std::string_view argument = rest.find(' ') == std::string_view::npos ? std::string_view() : rest.substr(rest.find(' ') + 1);
+
+    if (command == "created") {
+        if (mClients[client].creating.empty()) return;
+        std::size_t index = mClients[client].creating.front();
+        mClients[client].creating.pop_front();
+
+        Slot & slot = mSlots[index];
+        slot.id = std::strtoull(std::string(id).c_str(), nullptr, 10);
+        mIds[slot.id] = index;
+        if (slot.engine) sendMove(index);
+        else send(slot.players[1], "join " + std::string(id) + "\n");
+        return;
+    }
+
+    if (command == "error") {
+        if (++mErrors <= 5) std::cerr << "Server error: " << line << std::endl;
+        return;
+    }
+
+    std::size_t index = findSlot(id);
+    if (index == mSlots.size()) return; /* Already ended, e.g. the second end of a game */
+    Slot & slot = mSlots[index];
+    float latency = std::chrono::duration<float, std::micro>(Clock::now() - slot.sent).count();
+
+    if (command == "joined") {
+        sendMove(index);
+
+    } else if (command == "ok" || (command == "moved" && slot.engine)) {
+        if (command == "ok") mMoveLatencies.push_back(latency);
+        else {
+            mEngineLatencies.push_back(latency);
+            ++mEngineMoves;
+        }
+        ++mMoves;
+
+        Move move;
+        if (!slot.game.playMove(argument, move)) {
+            if (++mErrors <= 5) std::cerr << "Move " << argument << " of game " << id << " does not match the local game" << std::endl;
+            return;
+        }
+
+        /* The end comes from the server, after the move. Against the engine, the next move is its reply */
+        if (slot.game.isOver() || (slot.engine && command == "ok")) return;
+        sendMove(index);
+
+    } else if (command == "end") {
+        mIds.erase(slot.id);
+        ++mFinished;
+        if (!mStopping) startGame(index);
+    }
+}
+
+void LoadGenerator::report(double seconds) {
+    std::size_t engineGames = std::count_if(mSlots.begin(), mSlots.end(), [](const Slot & slot) { return slot.engine; });
+    std::cout << "Games:          " << mSlots.size() << " at the same time over " << mClients.size() << " connections (" << engineGames << " against the engine)" << std::endl;
+    std::cout << "Duration:       " << std::fixed << std::setprecision(1) << seconds << " s" << std::endl;
+    std::cout << "Games finished: " << mFinished << std::endl;
+    std::cout << "Moves:          " << mMoves << " (" << mEngineMoves << " by the engine)" << std::endl;
+    std::cout << "Moves/second:   " << static_cast<std::uint64_t>(seconds > 0.0 ? mMoves / seconds : 0.0) << std::endl;
+    printLatency("Move latency:   ", mMoveLatencies);
+    if (!mEngineLatencies.empty()) printLatency("Engine latency: ", mEngineLatencies);
+    std::cout << "Errors:         " << mErrors << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--host") == 0 && hasValue) options.host = argv[++i];
+        else if (std::strcmp(argv[i], "--port") == 0 && hasValue) options.port = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--games") == 0 && hasValue) options.games = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--connections") == 0 && hasValue) options.connections = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) options.seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--engine") == 0 && hasValue) options.enginePercent = std::clamp(std::atoi(argv[++i]), 0, 100);
+        else if (std::strcmp(argv[i], "--max-plies") == 0 && hasValue) options.maxPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--think") == 0 && hasValue) options.think = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) options.seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Unknown option " << argv[i] << ", see the comment at the top of LoadGenTool.cpp" << std::endl;
+            return 1;
+        }
+    }
+    if (options.games == 0 || options.connections == 0) {
+        std::cerr << "There must be at least one game and one connection" << std::endl;
+        return 1;
+    }
+
+    LoadGenerator generator(options);
+    if (!generator.connect()) return 1;
+
+    auto start = Clock::now();
+    generator.run();
+    generator.report(std::chrono::duration<double>(Clock::now() - start).count());
+    return 0;
+}
@@ -0,0 +1,271 @@
+/* Command line self-play match between two engine configurations
+
+Usage:
+   cppchess-match [options]
+
+Options:
+   --games N              Games to play, in pairs with the colors swapped on the same opening (default 100)
+   --threads N            Games played at the same time, 0 uses every core (default 0)
+   --openings <file>      EPD or PGN openings, used in order (default: random openings, see --random-plies)
+   --opening-plies N      Plies of each PGN game used as opening (default 8)
+   --random-plies N       Without --openings, each pair of games starts with N random moves from the initial position (default 8)
+   --seed S               Seed of the random openings, the same seed replays the same openings (default 1)
+   --a <config>           First engine, e.g. depth=5,hash=16 (keys: depth, nodes, time, hash, tb)
+   --b <config>           Second engine
+   --tb <directories>     Syzygy tablebases, only used by the engines configured with tb=1 (the search integration is opt-in)
+   --tb-adjudicate        Also adjudicates the positions the tablebases cover. Off by default, until the prober passes cppchess-tb --verify on real tables
+   --max-plies N          Longer games are drawn (default 600)
+   --pgn <file>           Writes the games
+   --sprt <elo0> <elo1>   Stops when the test accepts one of the hypotheses
+   --alpha A --beta B     SPRT error rates (default 0.05)
+   --metrics <file|->     Writes the engine counters and move latencies while the match runs, and at the end
+   --metrics-format F     json or prometheus (default prometheus)
+   --metrics-interval S   Seconds between two writes (default 10)
+
+Each thread has its own Board and Search objects for both engines. The PGN text of the games is buffered and written in bulk
+*/
+
+/* Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+/* Include other defined headers */
+#include "Metrics.hpp"
+#include "SelfPlay.hpp"
+
+struct EngineConfig {
+    SearchLimits limits;
+    std::size_t hashMegabytes = 16;
+    bool useTablebase = false;
+};
+
+/* Parses a comma separated list of key=value settings */
+static bool parseConfig(const std::string & text, EngineConfig & config) {
+    config.limits.depth = 4;
+    config.limits.useBook = false;
+
+    std::istringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (item.empty()) continue;
+        std::size_t equals = item.find('=');
+        if (equals == std::string::npos) return false;
+        std::string key = item.substr(0, equals);
+        const char * value = item.c_str() + equals + 1;
+
+        if (key == "depth") config.limits.depth = std::atoi(value);
+        else if (key == "nodes") config.limits.nodes = std::strtoull(value, nullptr, 10);
+        else if (key == "time") config.limits.seconds = std::atof(value);
+        else if (key == "hash") config.hashMegabytes = std::strtoull(value, nullptr, 10);
+        else if (key == "tb") config.useTablebase = config.limits.useTablebase = std::atoi(value) != 0;
+        else return false;
+    }
+    return true;
+}
+
+static void printScore(const MatchScore & score, bool sprt, double elo0, double elo1, double lower, double upper) {
+    std::cout << "Games " << std::setw(6) << score.getGames() << "  +" << score.wins << " =" << score.draws << " -" << score.losses
+              << "  Elo " << std::fixed << std::setprecision(1) << score.getElo() << " +/- " << score.getEloMargin();
+    if (sprt) std::cout << "  LLR " << std::setprecision(2) << score.getLLR(elo0, elo1) << " [" << lower << ", " << upper << "]";
+    std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+
+    std::uint64_t games = 100;
+    unsigned threads = 0;
+    int openingPlies = 8;
+    int randomPlies = 8;
+    std::uint64_t seed = 1;
+    int maxPlies = 600;
+    std::string openingsPath, pgnPath, tablebasePaths;
+    std::string configs[2] = {"", ""};
+    bool sprt = false, tablebaseAdjudication = false;
+    double elo0 = 0.0, elo1 = 5.0, alpha = 0.05, beta = 0.05;
+    MetricsOptions metricsOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (parseMetricsArgument(argc, argv, i, metricsOptions)) continue;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--openings") == 0 && hasValue) openingsPath = argv[++i];
+        else if (std::strcmp(argv[i], "--opening-plies") == 0 && hasValue) openingPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--random-plies") == 0 && hasValue) randomPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--a") == 0 && hasValue) configs[0] = argv[++i];
+        else if (std::strcmp(argv[i], "--b") == 0 && hasValue) configs[1] = argv[++i];
+        else if (std::strcmp(argv[i], "--tb") == 0 && hasValue) tablebasePaths = argv[++i];
+        else if (std::strcmp(argv[i], "--tb-adjudicate") == 0) tablebaseAdjudication = true;
+        else if (std::strcmp(argv[i], "--max-plies") == 0 && hasValue) maxPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--pgn") == 0 && hasValue) pgnPath = argv[++i];
+        else if (std::strcmp(argv[i], "--alpha") == 0 && hasValue) alpha = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--beta") == 0 && hasValue) beta = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--sprt") == 0 && i + 2 < argc) {
+            sprt = true;
+            elo0 = std::atof(argv[++i]);
+            elo1 = std::atof(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown option " << argv[i] << ", see the comment at the top of MatchTool.cpp" << std::endl;
+            return 1;
+        }
+    }
+
+    MetricsExporter exporter(metricsOptions);
+    EngineConfig engines[2];
+    for (int i = 0; i < 2; ++i) {
+        if (!parseConfig(configs[i], engines[i])) {
+            std::cerr << "Invalid engine configuration: " << configs[i] << std::endl;
+            return 1;
+        }
+    }
+
+    /* Without openings, the engines are deterministic and would play the same game again and again */
+    std::vector<Opening> openings;
+    if (openingsPath.empty()) {
+        std::cerr << "No --openings: every pair of games starts with " << randomPlies << " random plies (seed " << seed << ")" << std::endl;
+    } else if (!loadOpenings(openingsPath, openingPlies, openings)) {
+        std::cerr << "Unable to read openings from " << openingsPath << std::endl;
+        return 1;
+    }
+
+    Tablebase tablebase;
+    if (!tablebasePaths.empty()) tablebase.init(tablebasePaths);
+    const Tablebase * tables = tablebase.getMaxPieces() > 0 ? &tablebase : nullptr;
+    const Tablebase * adjudicator = tablebaseAdjudication ? tables : nullptr;
+
+    std::ofstream pgn;
+    if (!pgnPath.empty()) {
+        pgn.open(pgnPath, std::ios::binary | std::ios::trunc);
+        if (!pgn) {
+            std::cerr << "Unable to create " << pgnPath << std::endl;
+            return 1;
+        }
+    }
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    double lower = sprtLowerBound(alpha, beta);
+    double upper = sprtUpperBound(alpha, beta);
+
+    std::cout << "Playing " << games << " games on " << threads << " threads, " << (openings.empty() ? (games + 1) / 2 : openings.size()) << " openings" << std::endl;
+
+    /* Shared state: the next game to start, and the score and PGN buffer behind a mutex */
+    std::atomic<std::uint64_t> nextGame(0);
+    std::atomic<bool> stop(false);
+    std::mutex resultMutex;
+    MatchScore score;
+    std::uint64_t ends[GAME_END_COUNT] = {};
+    std::uint64_t failed = 0;
+    std::string pgnBuffer;
+    const std::size_t flushSize = 1 << 20;
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&] {
+        Search searches[2] = {Search(engines[0].hashMegabytes), Search(engines[1].hashMegabytes)};
+        for (int i = 0; i < 2; ++i) {
+            if (engines[i].useTablebase && tables) searches[i].setTablebase(tables);
+        }
+
+        PGNGame record;
+        std::ostringstream text;
+        Opening randomStart;
+
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::uint64_t index = nextGame.fetch_add(1);
+            if (index >= games) break;
+
+            /* Each opening is played twice, engine A is White in the even games. A random opening only depends on the seed and the pair, not on the thread playing it */
+            if (openings.empty()) {
+                std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ULL + index / 2);
+                while (!randomOpening(randomPlies, random, randomStart)) {}
+            }
+            const Opening & opening = openings.empty() ? randomStart : openings[(index / 2) % openings.size()];
+            int whiteEngine = static_cast<int>(index % 2);
+            SelfPlayOptions options;
+            options.limits[0] = engines[whiteEngine].limits;
+            options.limits[1] = engines[1 - whiteEngine].limits;
+            options.maxPlies = maxPlies;
+            options.tablebase = adjudicator;
+
+            GameEnd end = playGame(opening, searches[whiteEngine], searches[1 - whiteEngine], options, record);
+
+            std::vector<PGNTag> tags = {
+                {"Event", "cppchess-match"},
+                {"Site", "?"},
+                {"Date", "????.??.??"},
+                {"Round", std::to_string(index + 1)},
+                {"White", whiteEngine == 0 ? "A" : "B"},
+                {"Black", whiteEngine == 0 ? "B" : "A"},
+                {"Result", end == GameEnd::None ? "*" : record.result},
+                {"Termination", gameEndName(end)},
+            };
+            tags.insert(tags.end(), record.tags.begin(), record.tags.end());
+            record.tags.swap(tags);
+            if (end == GameEnd::None) record.result = "*";
+
+            text.str("");
+            if (pgn.is_open()) writePGN(text, record);
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (end == GameEnd::None) ++failed;
+            else {
+                ++ends[static_cast<int>(end)];
+                bool whiteWon = record.result == "1-0", blackWon = record.result == "0-1";
+                bool aWon = whiteEngine == 0 ? whiteWon : blackWon;
+                bool bWon = whiteEngine == 0 ? blackWon : whiteWon;
+                if (aWon) ++score.wins;
+                else if (bWon) ++score.losses;
+                else ++score.draws;
+            }
+
+            if (pgn.is_open()) {
+                pgnBuffer += text.str();
+                if (pgnBuffer.size() >= flushSize) {
+                    pgn.write(pgnBuffer.data(), pgnBuffer.size());
+                    pgnBuffer.clear();
+                }
+            }
+
+            std::uint64_t played = score.getGames();
+            if (played % 10 == 0) printScore(score, sprt, elo0, elo1, lower, upper);
+
+            if (sprt && played >= 2) {
+                double llr = score.getLLR(elo0, elo1);
+                if (llr >= upper || llr <= lower) stop = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) pool.emplace_back(worker);
+    for (std::thread & thread : pool) thread.join();
+
+    if (pgn.is_open()) pgn.write(pgnBuffer.data(), pgnBuffer.size());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::endl;
+    printScore(score, sprt, elo0, elo1, lower, upper);
+    for (int i = 1; i < GAME_END_COUNT; ++i) {
+        if (ends[i]) std::cout << "  " << gameEndName(static_cast<GameEnd>(i)) << ": " << ends[i] << std::endl;
+    }
+    if (failed) std::cout << "  unplayable openings: " << failed << std::endl;
+
+    if (sprt) {
+        double llr = score.getLLR(elo0, elo1);
+        std::cout << "SPRT:  " << (llr >= upper ? "H1 accepted" : llr <= lower ? "H0 accepted" : "inconclusive") << " (elo0 " << elo0 << ", elo1 " << elo1 << ", alpha " << alpha << ", beta " << beta << ")" << std::endl;
+    }
+    std::cout << "Time:  " << seconds << " s (" << score.getGames() / std::max(seconds, 1e-9) << " games/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,371 @@
+/* Command line microbenchmarks of the Board primitives
+
+Usage:
+   cppchess-microbench [--positions file] [--warmup N] [--repetitions N] [--sample-ms MS] [--filter text] [--json out.json]
+
+Every benchmark repeats one primitive over all the positions of the corpus (a built-in set, or one FEN per line of a file). A sample runs enough passes over the corpus to last at least --sample-ms (2 ms by default, calibrated during the warmup) and gives the mean time of one call. The warmup samples are discarded, and the median and percentiles of the others are reported, so each primitive can be followed across commits. Work that a primitive needs but should not be timed, such as copying the boards that movePiece changes, is done between the timed parts of a pass. The global allocations (operator new, replaced in AllocationCounter.cpp) and the pieces created in the timed parts are also counted per call
+*/
+
+/* Standard Libraries */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+/* Include other defined headers */
+#include "AllocationCounter.hpp"
+#include "Board.hpp"
+#include "PieceArena.hpp"
+
+static const char * CORPUS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r2q1rk1/ppp2ppp/3b1n2/3Pp3/3n4/2NBBP2/PPP2P1P/R2Q1RK1 b - - 0 11",
+    "3rr1k1/1pp2pp1/p2b1qbp/3Pp3/4p3/P3Q2P/1PP1PPP1/1K1RNBR1 b - - 3 24",
+    "1Q1r2k1/1p3ppp/p1b2b2/8/8/8/P1P1rPPP/2R3K1 w - - 8 31",
+    "8/p1p2p2/4k1p1/8/4Bb2/P6P/1P1p1P2/5RK1 b - - 0 39",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/1p1k4/1P6/2K5/8/8/8 w - - 0 1",
+};
+
+/* Keeps the results of the timed code alive, so that the compiler cannot remove it */
+static volatile std::uint64_t gSink = 0;
+
+/* Allocations and pieces created inside the timed parts only */
+static std::uint64_t gTimedAllocations = 0;
+static std::uint64_t gTimedPieces = 0;
+
+/* A primitive to measure. run does one pass over the corpus and returns the number of calls it timed, adding only their time to the given duration */
+struct Microbenchmark {
+    std::string name;
+    std::function<std::size_t(std::chrono::nanoseconds &)> run;
+};
+
+struct MicrobenchmarkResult {
+    std::string name;
+    std::size_t passes = 0;       /* Per sample */
+    std::size_t calls = 0;        /* Per sample */
+    std::vector<double> samples;  /* Nanoseconds per call, sorted */
+    double allocations = 0.0;     /* Global allocations per call */
+    double pieces = 0.0;          /* Pieces created per call, see PieceArena */
+
+    double percentile(double p) const {
+        if (samples.empty()) return 0.0;
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * samples.size()));
+        return samples[std::min(samples.size() - 1, rank ? rank - 1 : 0)];
+    }
+    double mean() const {
+        double total = 0.0;
+        for (double sample : samples) total += sample;
+        return samples.empty() ? 0.0 : total / samples.size();
+    }
+};
+
+/* Times a callable over a range, e.g. every board of the corpus */
+template <typename Function>
+static std::chrono::nanoseconds timed(Function && function) {
+    const PieceAllocationCounters & counters = getPieceAllocationCounters();
+    std::uint64_t allocations = getAllocationCount();
+    std::uint64_t pieces = counters.arenaAllocations + counters.heapAllocations;
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    gTimedAllocations += getAllocationCount() - allocations;
+    gTimedPieces += counters.arenaAllocations + counters.heapAllocations - pieces;
+    return time;
+}
+
+/* Boards of the corpus, loaded again for every benchmark, as some primitives change the moves of the pieces */
+static std::vector<std::unique_ptr<Board>> loadCorpus(const std::vector<std::string> & fens) {
+    std::vector<std::unique_ptr<Board>> boards;
+    for (const std::string & fen : fens) {
+        boards.push_back(std::make_unique<Board>());
+        boards.back()->loadFromFEN(fen);
+    }
+    return boards;
+}
+
+static std::vector<Microbenchmark> createBenchmarks(const std::vector<std::string> & fens) {
+    std::vector<Microbenchmark> benchmarks;
+
+    benchmarks.push_back({"Board::loadFromFEN", [fens](std::chrono::nanoseconds & time) {
+        Board board;
+        time += timed([&] {
+            for (const std::string & fen : fens) {
+                board.loadFromFEN(fen);
+                gSink = gSink + board.moveCount;
+            }
+        });
+        return fens.size();
+    }});
+
+    auto boards = std::make_shared<std::vector<std::unique_ptr<Board>>>();
+
+    benchmarks.push_back({"Board::Board(const Board &)", [fens, boards](std::chrono::nanoseconds & time) {
+        if (boards->empty()) *boards = loadCorpus(fens);
+        time += timed([&] {
+            for (const auto & board : *boards) {
+                Board copy(*board);
+                gSink = gSink + copy.moveCount;
+            }
+        });
+        return boards->size();
+    }});
+
+    /* The pseudo-legal moves and attack boards are recomputed on the same boards, so every pass does the same work */
+    auto pseudoLegal = std::make_shared<std::vector<std::unique_ptr<Board>>>();
+
+    benchmarks.push_back({"Board::computeAllMoves", [fens, pseudoLegal](std::chrono::nanoseconds & time) {
+        if (pseudoLegal->empty()) *pseudoLegal = loadCorpus(fens);
+        time += timed([&] {
+            for (const auto & board : *pseudoLegal) {
+                board->computeAllMoves();
+            }
+        });
+        return pseudoLegal->size();
+    }});
+
+    benchmarks.push_back({"Board::computeAttackBoards", [fens, pseudoLegal](std::chrono::nanoseconds & time) {
+        if (pseudoLegal->empty()) *pseudoLegal = loadCorpus(fens);
+        time += timed([&] {
+            for (const auto & board : *pseudoLegal) {
+                board->computeAttackBoards();
+                gSink = gSink + board->whiteAttackBoard[27] + board->blackAttackBoard[36];
+            }
+        });
+        return pseudoLegal->size();
+    }});
+
+    /* Every pseudo-legal move of the side to move, legal or not */
+    auto candidates = std::make_shared<std::vector<std::pair<Board *, Move>>>();
+    auto fillCandidates = [fens, boards, candidates] {
+        if (!candidates->empty()) return;
+        if (boards->empty()) *boards = loadCorpus(fens);
+        for (const auto & board : *boards) {
+            Board pseudo(*board);
+            pseudo.computeAllMoves();
+            for (const Piece * piece : pseudo.board) {
+                if (!piece || piece->getColor() != board->getTurn()) continue;
+                for (int to : piece->validMoves) candidates->push_back({board.get(), {piece->getPosition(), to, PieceType::Queen}});
+            }
+        }
+    };
+
+    benchmarks.push_back({"Board::validateMove", [fillCandidates, candidates](std::chrono::nanoseconds & time) {
+        fillCandidates();
+        time += timed([&] {
+            for (const auto & candidate : *candidates)
+                gSink = gSink + candidate.first->validateMove(candidate.second.from, candidate.second.to);
+        });
+        return candidates->size();
+    }});
+
+    /* movePiece changes the board, so each legal move is played on a copy made before the timed part */
+    auto legal = std::make_shared<std::vector<std::pair<const Board *, Move>>>();
+    benchmarks.push_back({"Board::movePiece", [fens, boards, legal](std::chrono::nanoseconds & time) {
+        if (boards->empty()) *boards = loadCorpus(fens);
+        if (legal->empty()) {
+            std::vector<Move> moves;
+            for (const auto & board : *boards) {
+                board->generateLegalMoves(moves);
+                for (const Move & move : moves) legal->push_back({board.get(), move});
+            }
+        }
+
+        const std::size_t batch = 64;
+        std::vector<std::unique_ptr<Board>> copies;
+        for (std::size_t first = 0; first < legal->size(); first += batch) {
+            std::size_t last = std::min(legal->size(), first + batch);
+            copies.clear();
+            for (std::size_t i = first; i < last; ++i) copies.push_back(std::make_unique<Board>(*(*legal)[i].first));
+            time += timed([&] {
+                for (std::size_t i = first; i < last; ++i) {
+                    const Move & move = (*legal)[i].second;
+                    gSink = gSink + copies[i - first]->movePiece(move.from, move.to, move.promotion);
+                }
+            });
+        }
+        return legal->size();
+    }});
+
+    benchmarks.push_back({"Board::existLegalMoves", [fens, boards](std::chrono::nanoseconds & time) {
+        if (boards->empty()) *boards = loadCorpus(fens);
+        time += timed([&] {
+            for (const auto & board : *boards) gSink = gSink + board->existLegalMoves(board->getTurn());
+        });
+        return boards->size();
+    }});
+
+    /* computeMoves of every piece of one type in the corpus */
+    static const std::pair<PieceType, const char *> pieces[] = {
+        {PieceType::Pawn, "Pawn::computeMoves"}, {PieceType::Knight, "Knight::computeMoves"}, {PieceType::Bishop, "Bishop::computeMoves"},
+        {PieceType::Rook, "Rook::computeMoves"}, {PieceType::Queen, "Queen::computeMoves"}, {PieceType::King, "King::computeMoves"},
+    };
+    for (const auto & piece : pieces) {
+        PieceType type = piece.first;
+        auto owned = std::make_shared<std::vector<std::unique_ptr<Board>>>();
+        auto selected = std::make_shared<std::vector<Piece *>>();
+        benchmarks.push_back({piece.second, [fens, type, owned, selected](std::chrono::nanoseconds & time) {
+            if (owned->empty()) {
+                *owned = loadCorpus(fens);
+                for (const auto & board : *owned)
+                    for (Piece * p : board->board)
+                        if (p && p->getType() == type) selected->push_back(p);
+            }
+            time += timed([&] {
+                for (Piece * p : *selected) {
+                    p->computeMoves();
+                    gSink = gSink + p->validMoves.size();
+                }
+            });
+            return selected->size();
+        }});
+    }
+
+    return benchmarks;
+}
+
+static void measure(const Microbenchmark & benchmark, int warmup, int repetitions, double sampleMilliseconds, MicrobenchmarkResult & result) {
+    using namespace std::chrono;
+    result.name = benchmark.name;
+    result.samples.clear();
+
+    auto sample = [&](std::size_t passes) {
+        nanoseconds time(0);
+        std::size_t calls = 0;
+        for (std::size_t i = 0; i < passes; ++i) calls += benchmark.run(time);
+        result.calls = calls;
+        return calls ? static_cast<double>(time.count()) / calls : 0.0;
+    };
+
+    /* Calibration: the number of passes that lasts the sample time, from the warmup */
+    nanoseconds pass(0);
+    benchmark.run(pass);
+    double passMilliseconds = std::max(pass.count() / 1e6, 1e-6);
+    result.passes = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(sampleMilliseconds / passMilliseconds)));
+
+    for (int i = 0; i < warmup; ++i) sample(result.passes);
+
+    gTimedAllocations = 0;
+    gTimedPieces = 0;
+    for (int i = 0; i < repetitions; ++i) result.samples.push_back(sample(result.passes));
+    std::sort(result.samples.begin(), result.samples.end());
+
+    double calls = static_cast<double>(result.calls) * repetitions;
+    result.allocations = calls > 0.0 ? gTimedAllocations / calls : 0.0;
+    result.pieces = calls > 0.0 ? gTimedPieces / calls : 0.0;
+}
+
+static std::string escapeJSON(const std::string & text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+static bool writeJSON(const std::string & path, const std::vector<MicrobenchmarkResult> & results, std::size_t positions, int warmup, int repetitions, double sampleMilliseconds) {
+    std::ofstream file(path, std::ios::trunc);
+    file << std::fixed << std::setprecision(1);
+    file << "{\n";
+    file << "  \"positions\": " << positions << ",\n";
+    file << "  \"warmup\": " << warmup << ",\n";
+    file << "  \"repetitions\": " << repetitions << ",\n";
+    file << "  \"sample_ms\": " << sampleMilliseconds << ",\n";
+    file << "  \"unit\": \"ns/call\",\n";
+    file << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const MicrobenchmarkResult & result = results[i];
+        file << "    {\"name\": \"" << escapeJSON(result.name) << "\", \"calls_per_sample\": " << result.calls << ", \"passes_per_sample\": " << result.passes
+             << ", \"min\": " << result.percentile(0.0) << ", \"p10\": " << result.percentile(10.0) << ", \"median\": " << result.percentile(50.0)
+             << ", \"p90\": " << result.percentile(90.0) << ", \"p99\": " << result.percentile(99.0) << ", \"max\": " << result.percentile(100.0)
+             << ", \"mean\": " << result.mean() << ", \"allocations_per_call\": " << result.allocations << ", \"pieces_per_call\": " << result.pieces << ", \"samples\": [";
+        for (std::size_t j = 0; j < result.samples.size(); ++j) file << (j ? ", " : "") << result.samples[j];
+        file << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char * argv[]) {
+
+    std::string positionsPath, filter, jsonPath;
+    int warmup = 3, repetitions = 25;
+    double sampleMilliseconds = 2.0;
+
+    for (int i = 1; i < argc; ++i) {
+        bool value = i + 1 < argc;
+        if (value && std::strcmp(argv[i], "--positions") == 0) positionsPath = argv[++i];
+        else if (value && std::strcmp(argv[i], "--warmup") == 0) warmup = std::max(0, std::atoi(argv[++i]));
+        else if (value && std::strcmp(argv[i], "--repetitions") == 0) repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (value && std::strcmp(argv[i], "--sample-ms") == 0) sampleMilliseconds = std::max(0.0, std::atof(argv[++i]));
+        else if (value && std::strcmp(argv[i], "--filter") == 0) filter = argv[++i];
+        else if (value && std::strcmp(argv[i], "--json") == 0) jsonPath = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--positions file] [--warmup N] [--repetitions N] [--sample-ms MS] [--filter text] [--json out.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    /* Corpus: only the positions that load, as the primitives expect a valid board */
+    std::vector<std::string> candidates;
+    if (positionsPath.empty()) candidates.assign(std::begin(CORPUS), std::end(CORPUS));
+    else {
+        std::ifstream file(positionsPath);
+        if (!file) {
+            std::cerr << "Unable to open " << positionsPath << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(file, line))
+            if (!line.empty() && line[0] != '#') candidates.push_back(line);
+    }
+
+    std::vector<std::string> fens;
+    for (const std::string & fen : candidates) {
+        try {
+            Board board;
+            if (board.loadFromFEN(fen)) fens.push_back(fen);
+        } catch (const std::exception & e) {
+            std::cerr << "Skipping \"" << fen << "\": " << e.what() << std::endl;
+        }
+    }
+    if (fens.empty()) {
+        std::cerr << "No valid positions" << std::endl;
+        return 1;
+    }
+
+    std::vector<MicrobenchmarkResult> results;
+    std::cout << std::left << std::setw(30) << "Benchmark" << std::right << std::setw(10) << "calls" << std::setw(12) << "median" << std::setw(12) << "p10"
+              << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(10) << "allocs" << std::setw(10) << "pieces" << "  (per call, " << fens.size() << " positions)" << std::endl;
+
+    for (const Microbenchmark & benchmark : createBenchmarks(fens)) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+        results.emplace_back();
+        MicrobenchmarkResult & result = results.back();
+        measure(benchmark, warmup, repetitions, sampleMilliseconds, result);
+
+        std::cout << std::left << std::setw(30) << result.name << std::right << std::setw(10) << result.calls << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.percentile(50.0) << std::setw(12) << result.percentile(10.0) << std::setw(12) << result.percentile(90.0)
+                  << std::setw(12) << result.percentile(99.0) << std::setw(10) << result.allocations << std::setw(10) << result.pieces << std::defaultfloat << std::endl;
+    }
+
+    if (!jsonPath.empty() && !writeJSON(jsonPath, results, fens.size(), warmup, repetitions, sampleMilliseconds)) {
+        std::cerr << "Unable to write " << jsonPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/* Command line PGN importer. Reads every game of a PGN file, replays it on a Board and reports the throughput
+
+Usage: cppchess-pgn <file.pgn> [--no-replay] [--threads N] [--unique] [--trace out.json]
+                    [--metrics <file|->] [--metrics-format json|prometheus] [--metrics-interval S]
+
+Without --threads the file is streamed by a single thread. With it, the file is memory mapped and imported by the multi-threaded pipeline (N = 0 uses every core). With --unique, every position of the games is packed and de-duplicated in a PositionSet, reporting the unique positions and the memory they take. With --metrics, the engine counters (bytes parsed, games replayed, positions generated...) are written every S seconds (default 10) and at the end, in the Prometheus text format or as JSON
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+
+/* Include other defined headers */
+#include "Board.hpp"
+#include "PGN.hpp"
+#include "PGNPipeline.hpp"
+#include "Metrics.hpp"
+#include "PositionSet.hpp"
+#include "Trace.hpp"
+
+/* Prints a throughput, avoiding divisions by zero on tiny files */
+static void printRate(const char * label, double count, double seconds) {
+    std::cout << label << static_cast<std::uint64_t>(count / (seconds > 0.0 ? seconds : 1e-9)) << std::endl;
+}
+
+/* Positions of the games, de-duplicated when --unique is given */
+struct UniquePositions {
+    PositionSet set;
+    std::uint64_t positions = 0;
+    std::uint64_t fenBytes = 0; /* Of the unique positions, with their null terminators */
+    double seconds = 0.0;
+
+    /* Replays the moves of a game again, packing the position before each move and the last one */
+    void add(const PGNGame & game, const std::vector<Move> & moves) {
+        auto start = std::chrono::steady_clock::now();
+        std::optional<Board> boards[2];
+        boards[0].emplace();
+        const std::string * fen = game.findTag("FEN");
+        if ((fen ? boards[0]->parseFEN(*fen) : boards[0]->parseFEN()) != FENError::None) return;
+
+        int current = 0;
+        for (std::size_t ply = 0;; ++ply) {
+            PackedBoard packed;
+            if (boards[current]->pack(packed)) {
+                ++positions;
+                if (set.insert(packed)) {
+                    char text[FEN_BUFFER_SIZE];
+                    fenBytes += boards[current]->toFEN(text, sizeof(text)) + 1;
+                }
+            }
+            if (ply == moves.size()) break;
+
+            boards[1 - current].emplace(*boards[current]);
+            if (!boards[1 - current]->playMove(moves[ply])) break;
+            current = 1 - current;
+        }
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void print() const {
+        std::size_t unique = set.getSize();
+        std::cout << std::endl;
+        std::cout << "Positions: " << positions << " (" << unique << " unique)" << std::endl;
+        std::cout << "Set:       " << set.getMemoryUsage() / 1024 << " KB, " << static_cast<double>(set.getMemoryUsage()) / (unique ? unique : 1) << " bytes per position ("
+                  << sizeof(PackedBoard) << " packed, at " << 100 * unique / set.getCapacity() << "% load)" << std::endl;
+        std::cout << "As FEN:    " << (fenBytes + unique * sizeof(std::string)) / 1024 << " KB, " << static_cast<double>(fenBytes) / (unique ? unique : 1) << " characters per position plus a "
+                  << sizeof(std::string) << " byte std::string" << std::endl;
+        printRate("Dedup/s:   ", positions, seconds);
+    }
+};
+
+/* Single thread import, streaming the file through PGNReader */
+static int importStreaming(const char * path, bool replay, UniquePositions * unique) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return 1;
+    }
+
+    PGNReader reader(file);
+    PGNGame game;
+    Board board;
+    std::vector<Move> played;
+
+    std::uint64_t moves = 0;
+    std::uint64_t errors = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (reader.readGame(game)) {
+        if (replay && !replayGame(game, board, unique ? &played : nullptr)) {
+            ++errors;
+            continue;
+        }
+        if (unique) unique->add(game, played);
+        moves += game.moves.size();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::uint64_t games = reader.getGamesRead();
+
+    std::cout << "Games:   " << games << " (" << errors << " failed)" << std::endl;
+    std::cout << "Moves:   " << moves << std::endl;
+    std::cout << "Bytes:   " << reader.getBytesRead() << std::endl;
+    std::cout << "Time:    " << seconds << " s" << std::endl;
+    printRate("Games/s: ", games, seconds);
+    printRate("Moves/s: ", moves, seconds);
+    printRate("KB/s:    ", reader.getBytesRead() / 1024.0, seconds);
+    if (unique) unique->print();
+
+    return errors == 0 ? 0 : 2;
+}
+
+/* Multi-threaded import, through the splitter, worker and sink stages of PGNPipeline */
+static int importParallel(const char * path, bool replay, unsigned threads, UniquePositions * unique) {
+    PGNPipelineOptions options;
+    options.threads = threads;
+    options.replay = replay;
+
+    PGNPipeline pipeline(options);
+    /* The sink receives the games in file order on this thread, so the set needs no locking */
+    if (!pipeline.run(path, [unique](const PGNPipelineGame & result) {
+            if (unique && result.replayed) unique->add(result.game, result.moves);
+        })) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return 1;
+    }
+
+    const PGNPipelineStats & stats = pipeline.getStats();
+    std::cout << "Games:   " << stats.games << " (" << stats.failed << " failed)" << std::endl;
+    std::cout << "Moves:   " << stats.moves << std::endl;
+    std::cout << "Bytes:   " << stats.bytes << std::endl;
+    std::cout << "Time:    " << stats.seconds << " s" << std::endl;
+    printRate("Games/s: ", stats.games, stats.seconds);
+    printRate("Moves/s: ", stats.moves, stats.seconds);
+
+    std::cout << std::endl << "Stage     Busy (s)   Throughput" << std::endl;
+    std::cout << "Split     " << stats.splitSeconds << "   " << static_cast<std::uint64_t>(stats.ranges / (stats.splitSeconds > 0.0 ? stats.splitSeconds : 1e-9)) << " ranges/s" << std::endl;
+    std::cout << "Workers   " << stats.workerSeconds << "   " << static_cast<std::uint64_t>(stats.games / (stats.workerSeconds > 0.0 ? stats.workerSeconds : 1e-9)) << " games/s per worker (" << stats.workers << " workers)" << std::endl;
+    std::cout << "Sink      " << stats.sinkSeconds << "   " << static_cast<std::uint64_t>(stats.delivered / (stats.sinkSeconds > 0.0 ? stats.sinkSeconds : 1e-9)) << " games/s" << std::endl;
+
+    std::cout << std::endl << "Queue     Max   Average" << std::endl;
+    std::cout << "Ranges    " << stats.rangeQueueMax << "   " << stats.rangeQueueAverage << std::endl;
+    std::cout << "Results   " << stats.resultQueueMax << "   " << stats.resultQueueAverage << std::endl;
+    std::cout << "Reorder   " << stats.reorderMax << std::endl;
+    if (unique) unique->print();
+
+    return stats.failed == 0 ? 0 : 2;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.pgn> [--no-replay] [--threads N] [--unique] [--trace out.json] [--metrics <file|->] [--metrics-format json|prometheus] [--metrics-interval S]" << std::endl;
+        return 1;
+    }
+
+    bool replay = true;
+    bool parallel = false;
+    bool unique = false;
+    unsigned threads = 0;
+    const char * tracePath = nullptr;
+    MetricsOptions metricsOptions;
+    for (int i = 2; i < argc; ++i) {
+        if (parseMetricsArgument(argc, argv, i, metricsOptions)) continue;
+        if (std::strcmp(argv[i], "--no-replay") == 0) replay = false;
+        else if (std::strcmp(argv[i], "--unique") == 0) unique = true;
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            parallel = true;
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        }
+    }
+
+    MetricsExporter exporter(metricsOptions);
+
+    /* The positions come from the replayed moves */
+    std::optional<UniquePositions> positions;
+    if (unique && replay) positions.emplace();
+    else if (unique) std::cerr << "--unique needs the games to be replayed, ignored with --no-replay" << std::endl;
+
+    UniquePositions * set = positions ? &*positions : nullptr;
+    int result = parallel ? importParallel(argv[1], replay, threads, set) : importStreaming(argv[1], replay, set);
+
+    /* Timeline of the reading and replaying, in a build with CPPCHESS_TRACE */
+    if (tracePath != nullptr && !writeTrace(tracePath)) {
+        std::cerr << "Unable to write the trace " << tracePath << (isTraceEnabled() ? "" : " (built without CPPCHESS_TRACE)") << std::endl;
+        return 1;
+    }
+    return result;
+}
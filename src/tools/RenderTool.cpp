@@ -0,0 +1,142 @@
+/* Command line board diagram renderer
+
+Usage:
+   cppchess-render <fens.txt> <out dir> [--threads N] [--flip] [--no-markings]
+
+Every line of the file is a FEN, optionally followed by "| <square>" to show the piece on that square selected, with its moves. The images are saved as <out dir>/<line>.png, with the same drawing code as the GUI, on an offscreen software renderer: no display is needed. Each thread has its own renderer, created before the threads start
+*/
+
+/* Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+/* Include other defined headers */
+#include "Board.hpp"
+#include "Graphics.hpp"
+
+struct Diagram {
+    std::string fen;
+    int selectedIndex = -1;
+    int line = 0;
+};
+
+/* Splits "<fen> | <square>" */
+static bool parseDiagram(const std::string & line, Diagram & diagram) {
+    std::size_t bar = line.find('|');
+    std::string fen = line.substr(0, bar);
+    fen.erase(fen.find_last_not_of(" \t\r") + 1);
+    if (fen.empty()) return false;
+    diagram.fen = fen;
+
+    if (bar != std::string::npos) {
+        std::string square = line.substr(bar + 1);
+        square.erase(0, square.find_first_not_of(" \t"));
+        square.erase(square.find_last_not_of(" \t\r") + 1);
+        try {
+            diagram.selectedIndex = Board::algebraicToIndex(square);
+        } catch (const std::invalid_argument &) {
+            std::cerr << "Invalid square " << square << ", rendered without a selection" << std::endl;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <fens.txt> <out dir> [--threads N] [--flip] [--no-markings]" << std::endl;
+        return 1;
+    }
+
+    unsigned threads = 0;
+    bool flip = false, markings = true;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--flip") == 0) flip = true;
+        else if (std::strcmp(argv[i], "--no-markings") == 0) markings = false;
+    }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::ifstream file(argv[1]);
+    if (!file) {
+        std::cerr << "Unable to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<Diagram> diagrams;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        Diagram diagram;
+        diagram.line = lineNumber;
+        if (parseDiagram(line, diagram)) diagrams.push_back(std::move(diagram));
+    }
+
+    std::filesystem::path outDir(argv[2]);
+    std::error_code error;
+    std::filesystem::create_directories(outDir, error);
+    if (error) {
+        std::cerr << "Unable to create " << outDir << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    /* SDL and the assets are initialized one renderer at a time, before any thread runs */
+    threads = std::min<unsigned>(threads, std::max<std::size_t>(diagrams.size(), 1));
+    std::vector<std::unique_ptr<Graphics>> renderers;
+    auto loadStart = std::chrono::steady_clock::now();
+    try {
+        for (unsigned i = 0; i < threads; ++i) {
+            renderers.push_back(std::make_unique<Graphics>(RenderMode::Offscreen));
+            renderers.back()->loadMedia();
+            renderers.back()->showMarkings = markings;
+            if (flip) renderers.back()->flipBoard();
+        }
+    } catch (const std::runtime_error & e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+    std::atomic<std::size_t> next(0), saved(0), invalid(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) {
+        pool.emplace_back([&, i] {
+            Graphics & graphics = *renderers[i];
+            Board board;
+            for (std::size_t index = next++; index < diagrams.size(); index = next++) {
+                const Diagram & diagram = diagrams[index];
+                FENError fenError = board.parseFEN(diagram.fen);
+                if (fenError != FENError::None) {
+                    std::cerr << "Line " << diagram.line << ": " << fenErrorName(fenError) << std::endl;
+                    ++invalid;
+                    continue;
+                }
+
+                char name[32];
+                std::snprintf(name, sizeof(name), "%06d.png", diagram.line);
+                if (graphics.saveBoardImage(board, (outDir / name).string(), diagram.selectedIndex)) ++saved;
+            }
+        });
+    }
+    for (std::thread & thread : pool) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Images:   " << saved.load() << " saved, " << invalid.load() << " invalid FENs" << std::endl;
+    std::cout << "Startup:  " << loadSeconds << " s for " << threads << " renderers" << std::endl;
+    std::cout << "Time:     " << seconds << " s on " << threads << " threads" << std::endl;
+    std::cout << "Images/s: " << (seconds > 0.0 ? saved.load() / seconds : 0.0) << std::endl;
+    return saved.load() + invalid.load() == diagrams.size() ? 0 : 1;
+}
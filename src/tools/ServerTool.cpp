@@ -0,0 +1,88 @@
+/* Command line multi-game server (Linux)
+
+Usage:
+   cppchess-server [options]
+
+Options:
+   --host <address>       Address to listen on (default 127.0.0.1)
+   --port N               TCP port (default 7878)
+   --workers N            Engine threads, 0 uses every core (default 0)
+   --depth N              Search depth of the engine moves (default 2)
+   --nodes N              Search nodes of the engine moves, instead of the depth
+   --hash MB              Transposition table of each engine thread (default 1)
+   --max-games N          Games hosted at the same time (default 100000)
+   --metrics <file|->     Writes the engine and server metrics while running, and at exit
+   --metrics-format F     json or prometheus (default prometheus)
+   --metrics-interval S   Seconds between two writes (default 10)
+
+The protocol is described in GameServer.hpp: it can be tried by hand with nc 127.0.0.1 7878. The server runs until interrupted (Ctrl+C), then prints what it served. cppchess-loadgen plays many games on it at once
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/* Include other defined headers */
+#include "GameServer.hpp"
+#include "Metrics.hpp"
+
+static GameServer * runningServer = nullptr;
+
+static void handleSignal(int) {
+    if (runningServer) runningServer->stop();
+}
+
+int main(int argc, char * argv[]) {
+
+    ServerOptions options;
+    options.engineLimits.depth = 2;
+    MetricsOptions metricsOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (parseMetricsArgument(argc, argv, i, metricsOptions)) continue;
+        if (std::strcmp(argv[i], "--host") == 0 && hasValue) options.host = argv[++i];
+        else if (std::strcmp(argv[i], "--port") == 0 && hasValue) options.port = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--workers") == 0 && hasValue) options.workers = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--depth") == 0 && hasValue) options.engineLimits.depth = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--nodes") == 0 && hasValue) {
+            options.engineLimits.nodes = std::strtoull(argv[++i], nullptr, 10);
+            options.engineLimits.depth = MAX_SEARCH_DEPTH;
+        }
+        else if (std::strcmp(argv[i], "--hash") == 0 && hasValue) options.hash = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--max-games") == 0 && hasValue) options.maxGames = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Unknown option " << argv[i] << ", see the comment at the top of ServerTool.cpp" << std::endl;
+            return 1;
+        }
+    }
+    if (options.engineLimits.depth < 1 || options.engineLimits.depth > MAX_SEARCH_DEPTH) {
+        std::cerr << "The depth must be between 1 and " << MAX_SEARCH_DEPTH << std::endl;
+        return 1;
+    }
+
+    MetricsExporter exporter(metricsOptions);
+    GameServer server(options);
+    if (!server.start()) return 1;
+
+    runningServer = &server;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::cout << "Listening on " << options.host << ":" << options.port << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    server.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    runningServer = nullptr;
+
+    const ServerStats & stats = server.getStats();
+    std::cout << std::endl;
+    std::cout << "Uptime:       " << static_cast<std::uint64_t>(seconds) << " s" << std::endl;
+    std::cout << "Connections:  " << stats.connections << std::endl;
+    std::cout << "Games:        " << stats.gamesCreated << " created, " << stats.gamesFinished << " finished" << std::endl;
+    std::cout << "Moves:        " << stats.moves << " (" << stats.engineMoves << " by the engine)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+/* Command line Syzygy tablebase prober
+
+Usage:
+   cppchess-tb <directories> "<FEN>" [--depth N] [--tb-search]   Probes a position, lists the root moves that keep its result and searches it, with the tables only if --tb-search is given
+   cppchess-tb <directories> --verify              Checks the prober on positions of 3 and 4 pieces (KQvK, KRvK, KPvK, KRvKR, KQvKQ) whose WDL and DTZ are known
+
+The directories are separated by ':' (';' on Windows). The search can be skipped with --depth 0
+*/
+
+/* Standard Libraries */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+/* Include other defined headers */
+#include "Notation.hpp"
+#include "Search.hpp"
+#include "Tablebase.hpp"
+
+static const char * wdlName(WDLScore wdl) {
+    switch (wdl) {
+        case WDLScore::Win: return "win";
+        case WDLScore::CursedWin: return "cursed win";
+        case WDLScore::Draw: return "draw";
+        case WDLScore::BlessedLoss: return "blessed loss";
+        case WDLScore::Loss: return "loss";
+    }
+    return "?";
+}
+
+/* Positions whose result does not need the tables: mates in one, mated Kings, a stalemate, captures of the only piece and pawn pushes that queen by the rule of the square */
+static const struct {
+    const char * fen;
+    WDLScore wdl;
+    int dtz;
+} KNOWN_POSITIONS[] = {
+    {"7k/8/6K1/8/8/8/8/1Q6 w - - 0 1", WDLScore::Win, 1},    /* KQvK, Qb8# */
+    {"7k/8/6K1/8/8/8/8/1Q6 b - - 0 1", WDLScore::Loss, -2},  /* KQvK, Kg8 Qb8# */
+    {"k7/1Q6/8/8/8/8/8/7K b - - 0 1", WDLScore::Draw, 0},     /* KQvK, Kxb7 */
+    {"7k/8/6K1/8/8/8/8/R7 w - - 0 1", WDLScore::Win, 1},     /* KRvK, Ra8# */
+    {"7k/8/6K1/8/8/8/8/1R6 b - - 0 1", WDLScore::Loss, -2},  /* KRvK, Kg8 Rb8# */
+    {"R6k/8/6K1/8/8/8/8/8 b - - 0 1", WDLScore::Loss, -1},   /* KRvK, mated */
+    {"8/8/8/8/8/8/4P3/4K2k w - - 0 1", WDLScore::Win, 1},    /* KPvK, the King is outside the square */
+    {"8/8/8/8/8/8/4P3/4K2k b - - 0 1", WDLScore::Loss, -2},  /* KPvK, the same with Black to move */
+    {"4k3/4P3/4K3/8/8/8/8/8 b - - 0 1", WDLScore::Draw, 0},   /* KPvK, stalemate */
+    {"k7/8/8/8/8/8/r7/R6K b - - 0 1", WDLScore::Win, 1},      /* KRvKR, Rxa1+ */
+    {"k7/8/8/8/8/8/q7/Q6K b - - 0 1", WDLScore::Win, 1},      /* KQvKQ, Qxa1+ */
+};
+
+static int verify(const Tablebase & tablebase) {
+    int failures = 0;
+
+    for (const auto & known : KNOWN_POSITIONS) {
+        Board board;
+        if (board.parseFEN(known.fen) != FENError::None) {
+            std::cerr << "Invalid FEN: " << known.fen << std::endl;
+            return 1;
+        }
+
+        WDLScore wdl;
+        int dtz;
+        bool hasWDL = tablebase.probeWDL(board, wdl);
+        bool hasDTZ = tablebase.probeDTZ(board, dtz);
+        bool good = hasWDL && hasDTZ && wdl == known.wdl && dtz == known.dtz;
+        if (!good) ++failures;
+
+        std::cout << (good ? "ok      " : "FAILED  ") << known.fen << "  WDL " << (hasWDL ? wdlName(wdl) : "missing") << " (" << wdlName(known.wdl) << ")"
+                  << ", DTZ " << (hasDTZ ? std::to_string(dtz) : "missing") << " (" << known.dtz << ")" << std::endl;
+    }
+
+    std::cout << (sizeof(KNOWN_POSITIONS) / sizeof(KNOWN_POSITIONS[0]) - failures) << " of " << sizeof(KNOWN_POSITIONS) / sizeof(KNOWN_POSITIONS[0]) << " positions match" << std::endl;
+    return failures == 0 ? 0 : 2;
+}
+
+static std::string moveToSAN(const Board & board, const Move & move) {
+    char san[SAN_BUFFER_SIZE];
+    writeSAN(board, move, san, sizeof(san));
+    return san;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <directories> \"<FEN>\" [--depth N] [--tb-search]" << std::endl;
+        std::cerr << "       " << argv[0] << " <directories> --verify" << std::endl;
+        return 1;
+    }
+
+    int depth = 8;
+    bool tablebaseSearch = false;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tb-search") == 0) tablebaseSearch = true;
+        else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) depth = std::atoi(argv[++i]);
+    }
+
+    Tablebase tablebase;
+    tablebase.init(argv[1]);
+    std::cout << "Tables:  " << tablebase.getWDLCount() << " WDL, " << tablebase.getDTZCount() << " DTZ, up to " << tablebase.getMaxPieces() << " pieces" << std::endl;
+    if (std::strcmp(argv[2], "--verify") == 0) return verify(tablebase);
+
+    Board board;
+    try {
+        if (!board.loadFromFEN(argv[2])) throw std::invalid_argument("Invalid FEN");
+    } catch (const std::exception &) {
+        std::cerr << "Invalid FEN: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WDLScore wdl;
+    if (!tablebase.probeWDL(board, wdl)) {
+        std::cerr << "The position is not in the tablebases" << std::endl;
+        return 2;
+    }
+    double wdlSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "WDL:     " << wdlName(wdl) << " (" << wdlSeconds * 1e6 << " us)" << std::endl;
+
+    int dtz;
+    if (tablebase.probeDTZ(board, dtz)) std::cout << "DTZ:     " << dtz << std::endl;
+    else std::cout << "DTZ:     not available" << std::endl;
+
+    std::vector<Move> moves;
+    board.generateLegalMoves(moves);
+    if (tablebase.filterRootMoves(board, moves, wdl)) {
+        std::cout << "Moves:  ";
+        for (const Move & move : moves) std::cout << " " << moveToSAN(board, move);
+        std::cout << std::endl;
+    }
+
+    if (depth <= 0) return 0;
+
+    Search search;
+    search.setTablebase(&tablebase);
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.useTablebase = tablebaseSearch;
+    SearchResult result = search.think(board, limits);
+    const SearchStats & stats = search.getStats();
+
+    if (result.bestMove.from < 0) {
+        std::cout << "Search:  no legal moves" << std::endl;
+        return 0;
+    }
+
+    std::cout << "Search:  " << moveToSAN(board, result.bestMove) << " score " << result.score << " depth " << result.depth
+              << " nodes " << stats.nodes << " tbhits " << stats.tbHits << " time " << stats.seconds << " s" << std::endl;
+    return 0;
+}